@@ -11,13 +11,13 @@ from mk_util import *
 def init_project_def():
     set_version(4, 5, 1, 0)
     add_lib('util', [])
-    add_lib('polynomial', ['util'], 'math/polynomial')
+    add_lib('interval', ['util'], 'math/interval')
+    add_lib('polynomial', ['util', 'interval'], 'math/polynomial')
     add_lib('sat', ['util'])
     add_lib('nlsat', ['polynomial', 'sat'])
     add_lib('hilbert', ['util'], 'math/hilbert')
     add_lib('simplex', ['util'], 'math/simplex')
     add_lib('automata', ['util'], 'math/automata')
-    add_lib('interval', ['util'], 'math/interval')
     add_lib('realclosure', ['interval'], 'math/realclosure')
     add_lib('subpaving', ['interval'], 'math/subpaving')
     add_lib('ast', ['util', 'polynomial'])
@@ -34,7 +34,7 @@ def init_project_def():
     add_lib('arith_tactics', ['core_tactics', 'sat'], 'tactic/arith')
     add_lib('nlsat_tactic', ['nlsat', 'sat_tactic', 'arith_tactics'], 'nlsat/tactic')
     add_lib('subpaving_tactic', ['core_tactics', 'subpaving'], 'math/subpaving/tactic')
-    add_lib('aig_tactic', ['tactic'], 'tactic/aig')
+    add_lib('aig_tactic', ['tactic', 'sat'], 'tactic/aig')
     add_lib('solver', ['model', 'tactic'])
     add_lib('ackermannization', ['model', 'rewriter', 'ast', 'solver', 'tactic'], 'ackermannization')
     add_lib('interp', ['solver'])
@@ -0,0 +1,213 @@
+#!/usr/bin/env python
+"""
+Trains the decision model used by the select-strategy tactic
+(see src/tactic/portfolio/strategy_selector_tactic.cpp) on a set
+of local SMT2 benchmarks.
+
+For every benchmark, the script collects the features of its
+first (check-sat) goal and the run time of every candidate
+strategy. Runs are stored in a JSON file, so a model can be
+retrained without rerunning the benchmarks. The model is a
+decision tree that minimizes the total PAR-2 score (unsolved
+runs cost twice the timeout) of the selected strategies.
+
+Example:
+
+    python scripts/train_strategy_selector.py --z3 build/z3 \\
+        --runs runs.json --model selector.model benchmarks/
+    z3 selector.model=selector.model problem.smt2
+"""
+import argparse
+import json
+import logging
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+DEFAULT_STRATEGIES = ['default', 'smt', 'qfbv', 'qfaufbv', 'qfufbv', 'qfidl', 'qflia',
+                      'qfauflia', 'qflra', 'qfnia', 'qfnra', 'qfuf', 'nra', 'lra', 'lia',
+                      'lira', 'ufnia', 'qffp']
+
+CHECK_SAT_RE = re.compile(r'\(\s*check-sat\s*\)')
+FEATURES_RE = re.compile(r'\(selector-features([^)]*)\)')
+
+def find_benchmarks(paths):
+    result = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, dirs, files in os.walk(path):
+                dirs.sort()
+                for f in sorted(files):
+                    if f.endswith('.smt2'):
+                        result.append(os.path.join(root, f))
+        else:
+            result.append(path)
+    return result
+
+def mk_script(benchmark, command):
+    """
+    Return the content of benchmark where the first (check-sat) is
+    replaced by command, and everything after it is removed.
+    """
+    with open(benchmark) as f:
+        text = f.read()
+    m = CHECK_SAT_RE.search(text)
+    if m is None:
+        return None
+    return text[:m.start()] + command + '\n'
+
+def run_z3(z3, script, timeout, extra_args):
+    with tempfile.NamedTemporaryFile(mode='w', suffix='.smt2', delete=False) as f:
+        f.write(script)
+        name = f.name
+    try:
+        start = time.time()
+        p = subprocess.Popen([z3, '-T:%d' % timeout] + extra_args + [name],
+                             stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                             universal_newlines=True)
+        out, err = p.communicate()
+        return out, err, time.time() - start
+    finally:
+        os.remove(name)
+
+def collect_features(z3, benchmark, timeout):
+    script = mk_script(benchmark, '(apply select-strategy)')
+    if script is None:
+        return None
+    out, err, _ = run_z3(z3, script, timeout, ['selector.features_only=true'])
+    m = FEATURES_RE.search(err)
+    if m is None:
+        logging.warning('no features for %s', benchmark)
+        return None
+    tokens = m.group(1).split()
+    return dict((tokens[i][1:], float(tokens[i + 1])) for i in range(0, len(tokens), 2))
+
+def run_strategy(z3, benchmark, strategy, timeout):
+    script = mk_script(benchmark, '(check-sat-using %s)' % strategy)
+    out, err, t = run_z3(z3, script, timeout, [])
+    lines = out.split()
+    solved = len(lines) > 0 and lines[0] in ('sat', 'unsat')
+    return { 'time' : t, 'solved' : solved }
+
+def collect_runs(args, runs):
+    for benchmark in find_benchmarks(args.benchmarks):
+        entry = runs.setdefault(benchmark, { 'features' : None, 'runs' : {} })
+        if entry['features'] is None:
+            entry['features'] = collect_features(args.z3, benchmark, args.timeout)
+            if entry['features'] is None:
+                continue
+        for strategy in args.strategies:
+            if strategy not in entry['runs']:
+                logging.info('running %s on %s', strategy, benchmark)
+                entry['runs'][strategy] = run_strategy(args.z3, benchmark, strategy, args.timeout)
+
+def cost(run, timeout):
+    if run is None or not run['solved']:
+        return 2.0 * timeout
+    return run['time']
+
+class Sample:
+    def __init__(self, features, costs):
+        self.features = features
+        self.costs = costs
+
+def best_leaf(samples, strategies):
+    """
+    Return the strategy with the smallest total cost on samples,
+    and the total cost.
+    """
+    best = None
+    for i, s in enumerate(strategies):
+        c = sum(x.costs[i] for x in samples)
+        if best is None or c < best[1]:
+            best = (s, c)
+    return best
+
+def best_split(samples, features, strategies, min_samples):
+    best = None
+    for f in features:
+        values = sorted(set(x.features[f] for x in samples))
+        for lo, hi in zip(values, values[1:]):
+            threshold = (lo + hi) / 2.0
+            le = [x for x in samples if x.features[f] <= threshold]
+            gt = [x for x in samples if x.features[f] > threshold]
+            if len(le) < min_samples or len(gt) < min_samples:
+                continue
+            c = best_leaf(le, strategies)[1] + best_leaf(gt, strategies)[1]
+            if best is None or c < best[0]:
+                best = (c, f, threshold, le, gt)
+    return best
+
+def train(samples, features, strategies, depth, args, model):
+    """
+    Append the nodes of the tree for samples to model in preorder,
+    so successors have larger ids, and return the id of the root.
+    """
+    id = len(model)
+    model.append(None)
+    strategy, leaf_cost = best_leaf(samples, strategies)
+    split = None
+    if depth < args.max_depth and len(samples) >= 2 * args.min_samples:
+        split = best_split(samples, features, strategies, args.min_samples)
+    if split is None or split[0] >= leaf_cost:
+        model[id] = 'leaf %d %s' % (id, strategy)
+        return id
+    _, f, threshold, le, gt = split
+    le_id = train(le, features, strategies, depth + 1, args, model)
+    gt_id = train(gt, features, strategies, depth + 1, args, model)
+    model[id] = 'node %d %s %r %d %d' % (id, f, threshold, le_id, gt_id)
+    return id
+
+def main(args):
+    logging.basicConfig(level=logging.INFO)
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--z3', default='z3', help='z3 executable')
+    parser.add_argument('--timeout', type=int, default=60, help='timeout per run in seconds')
+    parser.add_argument('--strategies', default=','.join(DEFAULT_STRATEGIES), help='comma separated list of candidate strategies')
+    parser.add_argument('--runs', required=True, help='JSON file storing features and run times; existing runs are reused')
+    parser.add_argument('--model', help='file where the trained model is written')
+    parser.add_argument('--max-depth', type=int, default=8, help='maximal depth of the decision tree')
+    parser.add_argument('--min-samples', type=int, default=3, help='minimal number of benchmarks in a leaf')
+    parser.add_argument('benchmarks', nargs='*', help='SMT2 files or directories containing SMT2 files')
+    pargs = parser.parse_args(args)
+    pargs.strategies = pargs.strategies.split(',')
+
+    runs = {}
+    if os.path.exists(pargs.runs):
+        with open(pargs.runs) as f:
+            runs = json.load(f)
+    try:
+        collect_runs(pargs, runs)
+    finally:
+        with open(pargs.runs, 'w') as f:
+            json.dump(runs, f, indent=1, sort_keys=True)
+
+    if pargs.model is None:
+        return 0
+    samples = []
+    for benchmark in sorted(runs):
+        entry = runs[benchmark]
+        if entry['features'] is None:
+            continue
+        costs = [cost(entry['runs'].get(s), pargs.timeout) for s in pargs.strategies]
+        samples.append(Sample(entry['features'], costs))
+    if not samples:
+        logging.error('no benchmarks with features')
+        return 1
+    features = sorted(set.intersection(*[set(x.features) for x in samples]))
+    model = []
+    train(samples, features, pargs.strategies, 0, pargs, model)
+    with open(pargs.model, 'w') as f:
+        f.write('# strategy selector model trained on %d benchmarks\n' % len(samples))
+        for line in model:
+            f.write(line + '\n')
+    for i, s in enumerate(pargs.strategies):
+        logging.info('%s: %.2f', s, sum(x.costs[i] for x in samples))
+    logging.info('wrote %s', pargs.model)
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
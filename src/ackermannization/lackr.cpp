@@ -55,6 +55,7 @@ lbool lackr::operator() () {
     SASSERT(m_sat);
     if (!init()) return l_undef;
     const lbool rv = m_eager ? eager() : lazy();
+    if (!m_eager) m_st.m_ackrs_avoided += ackr_helper::calculate_lemma_bound(m_fun2terms) - m_ackrs.size();
     if (rv == l_true) m_sat->get_model(m_model);
     CTRACE("lackr", rv == l_true,
         model_smt2_pp(tout << "abstr_model(\n", m_m, *(m_model.get()), 2); tout << ")\n"; );
@@ -237,7 +238,17 @@ lbool lackr::lazy() {
         const lackr_model_constructor::conflict_list conflicts = mc.get_conflicts();
         for (lackr_model_constructor::conflict_list::const_iterator i = conflicts.begin();
              i != conflicts.end(); ++i) {
-            ackr(i->first, i->second);
+            app * t1 = i->first;
+            app * t2 = i->second;
+            if (t1->get_id() > t2->get_id()) std::swap(t1, t2);
+            if (m_refined.contains(std::make_pair(t1, t2))) continue;
+            m_refined.insert(std::make_pair(t1, t2));
+            ackr(t1, t2);
+        }
+        if (ackr_head == m_ackrs.size()) {
+            // no new congruence constraint rules out the current model
+            TRACE("lackr", tout << "no refinement\n";);
+            return l_undef;
         }
         while (ackr_head < m_ackrs.size()) {
             m_sat->assert_expr(m_ackrs.get(ackr_head++));
@@ -28,12 +28,14 @@
 #include"util.h"
 #include"tactic_exception.h"
 #include"goal.h"
+#include"obj_pair_hashtable.h"
 
 struct lackr_stats {
-    lackr_stats() : m_it(0), m_ackrs_sz(0) {}
-    void reset() { m_it = m_ackrs_sz = 0; }
-    unsigned    m_it;       // number of lazy iterations
-    unsigned    m_ackrs_sz; // number of congruence constraints
+    lackr_stats() : m_it(0), m_ackrs_sz(0), m_ackrs_avoided(0) {}
+    void reset() { m_it = m_ackrs_sz = 0; m_ackrs_avoided = 0; }
+    unsigned    m_it;            // number of lazy iterations
+    unsigned    m_ackrs_sz;      // number of congruence constraints
+    double      m_ackrs_avoided; // number of congruence constraints not needed by the lazy mode
 };
 
 /** \brief
@@ -90,6 +92,7 @@ class lackr {
         ackr_helper                          m_ackr_helper;
         th_rewriter                          m_simp;
         expr_ref_vector                      m_ackrs;
+        obj_pair_hashtable<app, app>         m_refined; // pairs already refined in lazy mode
         model_ref                            m_model;
         bool                                 m_eager;
         lackr_stats&                         m_st;
@@ -17,13 +17,43 @@ Revision History:
 --*/
 #include<iostream>
 #include<fstream>
+#include<sstream>
 #include"z3.h"
 #include"api_log_macros.h"
 #include"util.h"
 #include"version.h"
+#include"map.h"
 
 std::ostream * g_z3_log = 0;
 bool g_z3_log_enabled   = false;
+bool g_z3_log_binary    = false;
+
+// Binary logs are not flushed after every entry.
+static char g_z3_log_buffer[1 << 16];
+
+// Binary logs identify objects by ids assigned in the order their
+// addresses are first logged. The replayer maps ids to objects in the
+// same way it maps addresses in text logs.
+static size_t_map<unsigned> * g_z3_log_ids = 0;
+
+unsigned _Z3_log_obj_id(void * obj) {
+    if (obj == 0)
+        return 0;
+    SASSERT(g_z3_log_ids);
+    size_t addr = reinterpret_cast<size_t>(obj);
+    unsigned id;
+    if (!g_z3_log_ids->find(addr, id)) {
+        id = g_z3_log_ids->size() + 1;
+        g_z3_log_ids->insert(addr, id);
+    }
+    return id;
+}
+
+static std::string version_string() {
+    std::ostringstream strm;
+    strm << Z3_MAJOR_VERSION << "." << Z3_MINOR_VERSION << "." << Z3_BUILD_NUMBER << "." << Z3_REVISION_NUMBER << " " << __DATE__;
+    return strm.str();
+}
 
 extern "C" {
     Z3_bool Z3_API Z3_open_log(Z3_string filename) {
@@ -31,13 +61,33 @@ extern "C" {
             Z3_close_log();
         g_z3_log = alloc(std::ofstream, filename);
         g_z3_log_enabled = true;
+        g_z3_log_binary  = false;
         if (g_z3_log->bad() || g_z3_log->fail()) {
             dealloc(g_z3_log);
             g_z3_log = 0;
             return Z3_FALSE;
         }
-        *g_z3_log << "V \"" << Z3_MAJOR_VERSION << "." << Z3_MINOR_VERSION << "." << Z3_BUILD_NUMBER << "." << Z3_REVISION_NUMBER << " " << __DATE__ << "\"\n";
-        g_z3_log->flush();
+        _Z3_log_version(version_string().c_str());
+        return Z3_TRUE;
+    }
+
+    Z3_bool Z3_API Z3_open_binary_log(Z3_string filename) {
+        if (g_z3_log != 0)
+            Z3_close_log();
+        std::ofstream * out = alloc(std::ofstream);
+        out->rdbuf()->pubsetbuf(g_z3_log_buffer, sizeof(g_z3_log_buffer));
+        out->open(filename, std::ios_base::out | std::ios_base::binary);
+        if (out->bad() || out->fail()) {
+            dealloc(out);
+            return Z3_FALSE;
+        }
+        g_z3_log         = out;
+        g_z3_log_enabled = true;
+        g_z3_log_binary  = true;
+        g_z3_log_ids     = alloc(size_t_map<unsigned>);
+        // The 'B' command switches the replayer to the binary encoding.
+        g_z3_log->put('B');
+        _Z3_log_version(version_string().c_str());
         return Z3_TRUE;
     }
 
@@ -51,7 +101,12 @@ extern "C" {
         if (g_z3_log != 0) {
             dealloc(g_z3_log);
             g_z3_log_enabled = false;
+            g_z3_log_binary  = false;
             g_z3_log = 0;
+            if (g_z3_log_ids) {
+                dealloc(g_z3_log_ids);
+                g_z3_log_ids = 0;
+            }
         }
     }
 }
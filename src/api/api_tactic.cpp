@@ -21,6 +21,7 @@ Revision History:
 #include"api_context.h"
 #include"api_tactic.h"
 #include"api_model.h"
+#include"api_stats.h"
 #include"scoped_ctrl_c.h"
 #include"cancel_eh.h"
 #include"scoped_timer.h"
@@ -410,15 +411,22 @@ extern "C" {
         unsigned timeout     = p.get_uint("timeout", UINT_MAX);
         bool     use_ctrl_c  = p.get_bool("ctrl_c", false);
         cancel_eh<reslimit> eh(mk_c(c)->m().limit());
+
+        tactic_ref tac = to_tactic_ref(t);
+        if (p.get_bool("profile", false)) {
+            // the profilers are added to a copy, so t is not profiled in later applications.
+            ref->m_profile = alloc(tactic_profile);
+            tac = profile_tactic(*ref->m_profile, "tactic", tac->translate(mk_c(c)->m()));
+        }
         
-        to_tactic_ref(t)->updt_params(p);
+        tac->updt_params(p);
 
         api::context::set_interruptable si(*(mk_c(c)), eh);
         {
             scoped_ctrl_c ctrlc(eh, false, use_ctrl_c);
             scoped_timer timer(timeout, &eh);
             try {
-                exec(*to_tactic_ref(t), new_goal, ref->m_subgoals, ref->m_mc, ref->m_pc, ref->m_core);
+                exec(*tac, new_goal, ref->m_subgoals, ref->m_mc, ref->m_pc, ref->m_core);
                 return of_apply_result(ref);
             }
             catch (z3_exception & ex) {
@@ -452,6 +460,7 @@ extern "C" {
         RESET_ERROR_CODE();
         param_descrs pd;
         to_tactic_ref(t)->collect_param_descrs(pd);
+        pd.insert("profile", CPK_BOOL, "(default: false) record time, memory and goal sizes of the tactic and of the tactics it is built from, see Z3_apply_result_get_statistics.");
         to_param_ref(p).validate(pd);
         Z3_apply_result r = _tactic_apply(c, t, g, to_param_ref(p));
         RETURN_Z3(r);
@@ -485,6 +494,10 @@ extern "C" {
             to_apply_result(r)->m_subgoals[i]->display(buffer);
         }
         buffer << ")";
+        if (to_apply_result(r)->m_profile) {
+            buffer << "\n";
+            to_apply_result(r)->m_profile->display(buffer);
+        }
         return mk_c(c)->mk_external_string(buffer.str());
         Z3_CATCH_RETURN("");
     }
@@ -497,6 +510,19 @@ extern "C" {
         Z3_CATCH_RETURN(0);
     }
     
+    Z3_stats Z3_API Z3_apply_result_get_statistics(Z3_context c, Z3_apply_result r) {
+        Z3_TRY;
+        LOG_Z3_apply_result_get_statistics(c, r);
+        RESET_ERROR_CODE();
+        Z3_stats_ref * st = alloc(Z3_stats_ref, *mk_c(c));
+        if (to_apply_result(r)->m_profile)
+            to_apply_result(r)->m_profile->collect_statistics(st->m_stats);
+        mk_c(c)->save_object(st);
+        Z3_stats result = of_stats(st);
+        RETURN_Z3(result);
+        Z3_CATCH_RETURN(0);
+    }
+
     Z3_goal Z3_API Z3_apply_result_get_subgoal(Z3_context c, Z3_apply_result r, unsigned i) {
         Z3_TRY;
         LOG_Z3_apply_result_get_subgoal(c, r, i);
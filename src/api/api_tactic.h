@@ -51,6 +51,7 @@ struct Z3_apply_result_ref : public api::object {
     model_converter_ref  m_mc;
     proof_converter_ref  m_pc;
     expr_dependency_ref  m_core;
+    ref<tactic_profile>  m_profile;
     Z3_apply_result_ref(api::context& c, ast_manager & m);
     virtual ~Z3_apply_result_ref() {}
 };
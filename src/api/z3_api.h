@@ -4830,6 +4830,17 @@ extern "C" {
     */
     Z3_bool Z3_API Z3_open_log(Z3_string filename);
 
+    /**
+       \brief Log interaction to a file using a compact binary encoding.
+
+       The binary log is buffered, and it is only guaranteed to be complete
+       after #Z3_close_log is invoked. It can be replayed like the logs created
+       by #Z3_open_log.
+
+       extra_API('Z3_open_binary_log', INT, (_in(STRING),))
+    */
+    Z3_bool Z3_API Z3_open_binary_log(Z3_string filename);
+
     /**
        \brief Append user-defined string to interaction log.
 
@@ -5635,6 +5646,10 @@ extern "C" {
     /**
        \brief Apply tactic \c t to the goal \c g using the parameter set \c p.
 
+       If the parameter \c profile is true, the time, memory and goal sizes of \c t,
+       and of the tactics it is built from, are recorded in the result, see
+       #Z3_apply_result_get_statistics.
+
        def_API('Z3_tactic_apply_ex', APPLY_RESULT, (_in(CONTEXT), _in(TACTIC), _in(GOAL), _in(PARAMS)))
     */
     Z3_apply_result Z3_API Z3_tactic_apply_ex(Z3_context c, Z3_tactic t, Z3_goal g, Z3_params p);
@@ -5676,6 +5691,16 @@ extern "C" {
     */
     Z3_goal Z3_API Z3_apply_result_get_subgoal(Z3_context c, Z3_apply_result r, unsigned i);
 
+    /**
+       \brief Return the profile of the tactic that produced \c r, when it was applied
+       with the parameter \c profile set to true. The statistics are empty otherwise.
+
+       \remark User must use #Z3_stats_inc_ref and #Z3_stats_dec_ref to manage Z3_stats objects.
+
+       def_API('Z3_apply_result_get_statistics', STATS, (_in(CONTEXT), _in(APPLY_RESULT)))
+    */
+    Z3_stats Z3_API Z3_apply_result_get_statistics(Z3_context c, Z3_apply_result r);
+
     /**
        \brief Convert a model for the subgoal \c Z3_apply_result_get_subgoal(c, r, i) into a model for the original goal \c g.
        Where \c g is the goal used to create \c r using \c Z3_tactic_apply(c, t, g).
@@ -14,21 +14,72 @@ Author:
     Leonardo de Moura (leonardo) 2011-09-22
 
 Notes:
-    
+   
 --*/
 #include<iostream>
 #include"symbol.h"
 struct ll_escaped { char const * m_str; ll_escaped(char const * str):m_str(str) {} };
 static std::ostream & operator<<(std::ostream & out, ll_escaped const & d);
 
-static void __declspec(noinline) R()  { *g_z3_log << "R\n"; g_z3_log->flush(); }
-static void __declspec(noinline) P(void * obj)  { *g_z3_log << "P " << obj << "\n"; g_z3_log->flush(); }
-static void __declspec(noinline) I(__int64 i)   { *g_z3_log << "I " << i << "\n"; g_z3_log->flush(); }
-static void __declspec(noinline) U(__uint64 u)   { *g_z3_log << "U " << u << "\n"; g_z3_log->flush(); }
-static void __declspec(noinline) D(double d)   { *g_z3_log << "D " << d << "\n"; g_z3_log->flush(); }
-static void __declspec(noinline) S(Z3_string str) { *g_z3_log << "S \"" << ll_escaped(str) << "\"\n"; g_z3_log->flush(); }
-static void __declspec(noinline) Sy(Z3_symbol sym) { 
+// Binary encoding: a one character tag followed by the payload.
+// Integers are encoded using LEB128 (signed integers are zig-zag encoded),
+// doubles are stored as 8 raw bytes, and strings as their length followed by their characters.
+static void Bt(char tag) { g_z3_log->put(tag); }
+static void Bu(__uint64 u) {
+    while (u >= 0x80) {
+        g_z3_log->put(static_cast<char>((u & 0x7F) | 0x80));
+        u >>= 7;
+    }
+    g_z3_log->put(static_cast<char>(u));
+}
+static void Bi(__int64 i) { Bu((static_cast<__uint64>(i) << 1) ^ static_cast<__uint64>(i >> 63)); }
+// Objects are logged by their id, see _Z3_log_obj_id.
+unsigned _Z3_log_obj_id(void * obj);
+static void Bp(void * obj) { Bu(_Z3_log_obj_id(obj)); }
+static void Bs(char const * str) {
+    size_t sz = strlen(str);
+    Bu(sz);
+    g_z3_log->write(str, sz);
+}
+
+static void __declspec(noinline) R()  {
+    if (g_z3_log_binary) { Bt('R'); return; }
+    *g_z3_log << "R\n"; g_z3_log->flush();
+}
+static void __declspec(noinline) P(void * obj)  {
+    if (g_z3_log_binary) { Bt('P'); Bp(obj); return; }
+    *g_z3_log << "P " << obj << "\n"; g_z3_log->flush();
+}
+static void __declspec(noinline) I(__int64 i)   {
+    if (g_z3_log_binary) { Bt('I'); Bi(i); return; }
+    *g_z3_log << "I " << i << "\n"; g_z3_log->flush();
+}
+static void __declspec(noinline) U(__uint64 u)   {
+    if (g_z3_log_binary) { Bt('U'); Bu(u); return; }
+    *g_z3_log << "U " << u << "\n"; g_z3_log->flush();
+}
+static void __declspec(noinline) D(double d)   {
+    if (g_z3_log_binary) { Bt('D'); g_z3_log->write(reinterpret_cast<char const *>(&d), sizeof(double)); return; }
+    *g_z3_log << "D " << d << "\n"; g_z3_log->flush();
+}
+static void __declspec(noinline) S(Z3_string str) {
+    if (g_z3_log_binary) { Bt('S'); Bs(str); return; }
+    *g_z3_log << "S \"" << ll_escaped(str) << "\"\n"; g_z3_log->flush();
+}
+static void __declspec(noinline) Sy(Z3_symbol sym) {
     symbol s = symbol::mk_symbol_from_c_ptr(reinterpret_cast<void *>(sym));
+    if (g_z3_log_binary) {
+        if (s == symbol::null) {
+            Bt('N');
+        }
+        else if (s.is_numerical()) {
+            Bt('#'); Bu(s.get_num());
+        }
+        else {
+            Bt('$'); Bs(s.bare_str());
+        }
+        return;
+    }
     if (s == symbol::null) {
         *g_z3_log << "N\n";
     }
@@ -40,11 +91,43 @@ static void __declspec(noinline) Sy(Z3_symbol sym) {
     }
     g_z3_log->flush();
 }
-static void __declspec(noinline) Ap(unsigned sz) { *g_z3_log << "p " << sz << "\n"; g_z3_log->flush(); }
-static void __declspec(noinline) Au(unsigned sz) { *g_z3_log << "u " << sz << "\n"; g_z3_log->flush(); }
-static void __declspec(noinline) Asy(unsigned sz) { *g_z3_log << "s " << sz << "\n"; g_z3_log->flush(); }
-static void __declspec(noinline) C(unsigned id)   { *g_z3_log << "C " << id << "\n"; g_z3_log->flush(); }
-void __declspec(noinline) _Z3_append_log(char const * msg) { *g_z3_log << "M \"" << ll_escaped(msg) << "\"\n"; g_z3_log->flush(); }
+static void __declspec(noinline) Ap(unsigned sz) {
+    if (g_z3_log_binary) { Bt('p'); Bu(sz); return; }
+    *g_z3_log << "p " << sz << "\n"; g_z3_log->flush();
+}
+static void __declspec(noinline) Au(unsigned sz) {
+    if (g_z3_log_binary) { Bt('u'); Bu(sz); return; }
+    *g_z3_log << "u " << sz << "\n"; g_z3_log->flush();
+}
+static void __declspec(noinline) Asy(unsigned sz) {
+    if (g_z3_log_binary) { Bt('s'); Bu(sz); return; }
+    *g_z3_log << "s " << sz << "\n"; g_z3_log->flush();
+}
+static void __declspec(noinline) C(unsigned id)   {
+    if (g_z3_log_binary) { Bt('C'); Bu(id); return; }
+    *g_z3_log << "C " << id << "\n"; g_z3_log->flush();
+}
+void __declspec(noinline) SetR(void * obj) {
+    if (g_z3_log_binary) { Bt('='); Bp(obj); return; }
+    *g_z3_log << "= " << obj << "\n";
+}
+void __declspec(noinline) SetO(void * obj, unsigned pos) {
+    if (g_z3_log_binary) { Bt('*'); Bp(obj); Bu(pos); return; }
+    *g_z3_log << "* " << obj << " " << pos << "\n";
+}
+void __declspec(noinline) SetAO(void * obj, unsigned pos, unsigned idx) {
+    if (g_z3_log_binary) { Bt('@'); Bp(obj); Bu(pos); Bu(idx); return; }
+    *g_z3_log << "@ " << obj << " " << pos << " " << idx << "\n";
+}
+void __declspec(noinline) _Z3_append_log(char const * msg) {
+    if (g_z3_log_binary) { Bt('M'); Bs(msg); return; }
+    *g_z3_log << "M \"" << ll_escaped(msg) << "\"\n"; g_z3_log->flush();
+}
+
+void __declspec(noinline) _Z3_log_version(char const * version) {
+    if (g_z3_log_binary) { Bt('V'); Bs(version); return; }
+    *g_z3_log << "V \"" << version << "\"\n"; g_z3_log->flush();
+}
 
 static std::ostream & operator<<(std::ostream & out, ll_escaped const & d) {
     char const * s = d.m_str;
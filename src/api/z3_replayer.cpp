@@ -38,6 +38,7 @@ struct z3_replayer::imp {
     std::istream &           m_stream;
     char                     m_curr;  // current char;
     int                      m_line;  // line
+    bool                     m_binary; // true if the log uses the binary encoding (see z3_logger.h)
     svector<char>            m_string;
     symbol                   m_id;
     __int64                  m_int64;
@@ -112,7 +113,8 @@ struct z3_replayer::imp {
         m_owner(o),
         m_stream(in),
         m_curr(0),
-        m_line(1) {
+        m_line(1),
+        m_binary(false) {
         next();
     }
 
@@ -159,9 +161,54 @@ struct z3_replayer::imp {
 
     char curr() const { return m_curr; }
     void new_line() { m_line++; }
-    void next() { m_curr = m_stream.get(); }
+    void next() { if (!m_binary) m_curr = m_stream.get(); }
+
+    // -----------------------
+    //
+    // Binary encoding
+    //
+    // -----------------------
+
+    char read_byte() {
+        int c = m_stream.get();
+        if (c == EOF)
+            throw z3_replayer_exception("unexpected end of file");
+        return static_cast<char>(c);
+    }
+
+    __uint64 read_leb128() {
+        __uint64 r = 0;
+        unsigned shift = 0;
+        while (true) {
+            unsigned char c = static_cast<unsigned char>(read_byte());
+            if (shift >= 64)
+                throw z3_replayer_exception("invalid unsigned");
+            r |= static_cast<__uint64>(c & 0x7F) << shift;
+            if ((c & 0x80) == 0)
+                return r;
+            shift += 7;
+        }
+    }
+
+    void read_raw(void * data, unsigned sz) {
+        m_stream.read(static_cast<char*>(data), sz);
+        if (static_cast<unsigned>(m_stream.gcount()) != sz)
+            throw z3_replayer_exception("unexpected end of file");
+    }
+
+    void read_binary_string() {
+        __uint64 sz = read_leb128();
+        m_string.reset();
+        for (__uint64 i = 0; i < sz; i++)
+            m_string.push_back(read_byte());
+        m_string.push_back(0);
+    }
 
     void read_string_core(char delimiter) {
+        if (m_binary) {
+            read_binary_string();
+            return;
+        }
         if (curr() != delimiter)
             throw z3_replayer_exception("invalid string/symbol");
         m_string.reset();
@@ -217,6 +264,11 @@ struct z3_replayer::imp {
     }
 
     void read_int64() {
+        if (m_binary) {
+            __uint64 u = read_leb128();
+            m_int64 = static_cast<__int64>(u >> 1) ^ -static_cast<__int64>(u & 1);
+            return;
+        }
         if (!(curr() == '-' || ('0' <= curr() && curr() <= '9')))
             throw z3_replayer_exception("invalid integer");
         bool sign = false;
@@ -242,6 +294,10 @@ struct z3_replayer::imp {
     }
 
     void read_uint64() {
+        if (m_binary) {
+            m_uint64 = read_leb128();
+            return;
+        }
         if (!('0' <= curr() && curr() <= '9'))
             throw z3_replayer_exception("invalid unsigned");
         m_uint64 = 0;
@@ -269,6 +325,10 @@ struct z3_replayer::imp {
 #endif
 
     void read_float() {
+        if (m_binary) {
+            read_raw(&m_float, sizeof(float));
+            return;
+        }
         m_string.reset();
         while (is_double_char()) {
             m_string.push_back(curr());
@@ -282,6 +342,10 @@ struct z3_replayer::imp {
     }
 
     void read_double() {
+        if (m_binary) {
+            read_raw(&m_double, sizeof(double));
+            return;
+        }
         m_string.reset();
         while (is_double_char()) {
             m_string.push_back(curr());
@@ -295,6 +359,10 @@ struct z3_replayer::imp {
     }
 
     void read_ptr() {
+        if (m_binary) {
+            m_ptr = static_cast<size_t>(read_leb128());
+            return;
+        }
         if (!(('0' <= curr() && curr() <= '9') || ('A' <= curr() && curr() <= 'F') || ('a' <= curr() && curr() <= 'f'))) {
             TRACE("invalid_ptr", tout << "curr: " << curr() << "\n";);
             throw z3_replayer_exception("invalid ptr");
@@ -323,13 +391,15 @@ struct z3_replayer::imp {
     }
 
     void skip_blank() {
+        if (m_binary)
+            return;
         while (true) {
             char c = curr();
             if (c == '\n') {
                 new_line();
                 next();
             }
-            else if (c == ' ' || c == '\t') {
+            else if (c == ' ' || c == '\t' || c == '\r') {
                 next();
             }
             else {
@@ -410,11 +480,20 @@ struct z3_replayer::imp {
                     tick = 0;
                 }
             });
+            if (m_binary) {
+                // each command is a tag followed by its arguments, the line is the command index.
+                m_curr = m_stream.get();
+                new_line();
+            }
             skip_blank();
             char c = curr();
             if (c == EOF)
                 return;
             switch (c) {
+            case 'B':
+                // the rest of the log uses the binary encoding
+                m_binary = true;
+                break;
             case 'V':
                 // version
                 next(); skip_blank(); read_string();
@@ -1886,6 +1886,7 @@ public:
     void copy(expr_array const & s, expr_array & r) { m_expr_array_manager.copy(s, r); }
     unsigned size(expr_array const & r) const { return m_expr_array_manager.size(r); }
     bool empty(expr_array const & r) const { return m_expr_array_manager.empty(r); }
+    bool same(expr_array const & r1, expr_array const & r2) const { return m_expr_array_manager.same(r1, r2); }
     expr * get(expr_array const & r, unsigned i) const { return m_expr_array_manager.get(r, i); }
     void set(expr_array & r, unsigned i, expr * v) { m_expr_array_manager.set(r, i, v); }
     void set(expr_array const & s, unsigned i, expr * v, expr_array & r) { m_expr_array_manager.set(s, i, v, r); }
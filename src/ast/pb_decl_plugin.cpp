@@ -297,6 +297,18 @@ bool pb_util::has_unit_coefficients(func_decl* f) const {
     return true;
 }
 
+bool pb_util::has_unsigned_coefficients(func_decl* f) const {
+    rational sum = get_k(f);
+    if (!sum.is_unsigned()) return false;
+    unsigned sz = f->get_arity();
+    for (unsigned i = 0; i < sz; ++i) {
+        rational c = get_coeff(f, i);
+        if (c.is_neg()) return false;
+        sum += c;
+    }
+    return sum.is_unsigned();
+}
+
 app* pb_util::mk_fresh_bool() {
     symbol name = m.mk_fresh_var_name("pb");
     func_decl_info info(m_fid, OP_PB_AUX_BOOL, 0, 0);
@@ -114,6 +114,12 @@ public:
     rational get_coeff(func_decl* a, unsigned index) const; 
     bool has_unit_coefficients(func_decl* f) const;
     bool has_unit_coefficients(expr* f) const { return is_app(f) && has_unit_coefficients(to_app(f)->get_decl()); }
+    /**
+       \brief Return true if the coefficients and the bound of f are
+       non-negative and their sum fits in an unsigned.
+    */
+    bool has_unsigned_coefficients(func_decl* f) const;
+    bool has_unsigned_coefficients(expr* f) const { return is_app(f) && has_unsigned_coefficients(to_app(f)->get_decl()); }
 
 
     bool is_eq(func_decl* f) const;
@@ -49,6 +49,8 @@ struct pb2bv_rewriter::imp {
         expr_ref_vector m_args;
         rational     m_k;
         vector<rational> m_coeffs;
+        bool         m_keep_cardinality_constraints;
+        unsigned     m_min_cardinality_size;
 
         template<lbool is_le>
         expr_ref mk_le_ge(expr_ref_vector& fmls, expr* a, expr* b, expr* bound) {
@@ -238,11 +240,33 @@ struct pb2bv_rewriter::imp {
             pb(m),
             bv(m),
             m_trail(m),
-            m_args(m)
+            m_args(m),
+            m_keep_cardinality_constraints(false),
+            m_min_cardinality_size(0)
         {}
 
+        void updt_params(params_ref const & p) {
+            m_keep_cardinality_constraints = p.get_bool("keep_cardinality_constraints", false);
+            m_min_cardinality_size = p.get_uint("min_cardinality_size", 0);
+        }
+
+        /**
+           \brief Return true if f is left for a solver that handles
+           cardinality and pseudo-Boolean constraints natively.
+        */
+        bool keep_cardinality(func_decl * f, unsigned sz) const {
+            return
+                m_keep_cardinality_constraints &&
+                sz >= m_min_cardinality_size &&
+                f->get_decl_kind() != OP_PB_AUX_BOOL &&
+                pb.has_unsigned_coefficients(f);
+        }
+
         bool mk_app(bool full, func_decl * f, unsigned sz, expr * const* args, expr_ref & result) {
             if (f->get_family_id() == pb.get_family_id()) {
+                if (keep_cardinality(f, sz)) {
+                    return false;
+                }
                 mk_pb(full, f, sz, args, result);
             }
             else if (au.is_le(f) && is_pb(args[0], args[1])) {
@@ -424,9 +448,13 @@ struct pb2bv_rewriter::imp {
         m_fresh(m),
         m_num_translated(0), 
         m_rw(*this, m) {
+        updt_params(p);
     }
 
-    void updt_params(params_ref const & p) {}
+    void updt_params(params_ref const & p) {
+        m_params = p;
+        m_rw.m_cfg.m_r.updt_params(p);
+    }
     unsigned get_num_steps() const { return m_rw.get_num_steps(); }
     void cleanup() { m_rw.cleanup(); }
     void operator()(expr * e, expr_ref & result, proof_ref & result_proof) {
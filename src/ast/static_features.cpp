@@ -644,5 +644,88 @@ void static_features::display(std::ostream & out) const {
     out << "END_STATIC_FEATURES" << "\n";
 }
 
+/**
+   \brief Names of the entries produced by get_feature_vector, in order.
+*/
+static char const * g_feature_names[] = {
+    "cnf",
+    "num_exprs",
+    "num_roots",
+    "max_depth",
+    "num_quantifiers",
+    "num_clauses",
+    "num_bool_constants",
+    "num_uninterpreted_constants",
+    "num_uninterpreted_functions",
+    "num_eqs",
+    "has_int",
+    "has_real",
+    "has_bv",
+    "has_fpa",
+    "has_arrays",
+    "num_arith_terms",
+    "num_arith_ineqs",
+    "num_non_linear",
+    "num_theories",
+    "max_or_and_tree_depth",
+    "max_ite_tree_depth",
+    "perc_quantifiers_with_patterns",
+    "avg_clause_size",
+    "perc_bool_constants",
+    "perc_nested_formulas",
+    "is_diff",
+    "ineq_eq_ratio",
+    "perc_arith_eqs",
+    "perc_diff_eqs",
+    "perc_diff_ineqs",
+    "perc_simple_eqs",
+    "perc_simple_ineqs",
+    "perc_aliens",
+};
+
 void static_features::get_feature_vector(vector<double> & result) {
+    result.reset();
+    result.push_back(m_cnf);
+    result.push_back(m_num_exprs);
+    result.push_back(m_num_roots);
+    result.push_back(m_max_depth);
+    result.push_back(m_num_quantifiers);
+    result.push_back(m_num_clauses);
+    result.push_back(m_num_bool_constants);
+    result.push_back(m_num_uninterpreted_constants);
+    result.push_back(m_num_uninterpreted_functions);
+    result.push_back(m_num_eqs);
+    result.push_back(m_has_int);
+    result.push_back(m_has_real);
+    result.push_back(m_has_bv);
+    result.push_back(m_has_fpa);
+    result.push_back(m_has_arrays);
+    result.push_back(m_num_arith_terms);
+    result.push_back(m_num_arith_ineqs);
+    result.push_back(m_num_non_linear);
+    result.push_back(num_theories());
+    result.push_back(m_max_or_and_tree_depth);
+    result.push_back(m_max_ite_tree_depth);
+    result.push_back(m_num_quantifiers > 0 ? (double) m_num_quantifiers_with_patterns / (double) m_num_quantifiers : 0);
+    result.push_back(m_num_clauses > 0 ? (double) m_sum_clause_size / (double) m_num_clauses : 0);
+    result.push_back(m_num_uninterpreted_constants > 0 ? (double) m_num_bool_constants / (double) m_num_uninterpreted_constants : 0);
+    result.push_back(m_num_bool_exprs > 0 ? (double) m_num_nested_formulas / (double) m_num_bool_exprs : 0);
+    result.push_back(m_num_arith_eqs == m_num_diff_eqs && m_num_arith_ineqs == m_num_diff_ineqs && m_num_arith_terms == m_num_diff_terms);
+    result.push_back(m_num_arith_eqs > 0 ? (double) m_num_arith_ineqs / (double) m_num_arith_eqs : 0);
+    result.push_back(m_num_eqs > 0 ? (double) m_num_arith_eqs / (double) m_num_eqs : 0);
+    result.push_back(m_num_arith_eqs > 0 ? (double) m_num_diff_eqs / (double) m_num_arith_eqs : 0);
+    result.push_back(m_num_arith_ineqs > 0 ? (double) m_num_diff_ineqs / (double) m_num_arith_ineqs : 0);
+    result.push_back(m_num_arith_eqs > 0 ? (double) m_num_simple_eqs / (double) m_num_arith_eqs : 0);
+    result.push_back(m_num_arith_ineqs > 0 ? (double) m_num_simple_ineqs / (double) m_num_arith_ineqs : 0);
+    result.push_back(m_num_exprs > 0 ? (double) m_num_aliens / (double) m_num_exprs : 0);
+    SASSERT(result.size() == get_num_features());
+}
+
+unsigned static_features::get_num_features() {
+    return sizeof(g_feature_names) / sizeof(char const *);
+}
+
+char const * static_features::get_feature_name(unsigned i) {
+    SASSERT(i < get_num_features());
+    return g_feature_names[i];
 }
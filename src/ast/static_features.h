@@ -171,7 +171,13 @@ struct static_features {
     void display_family_data(std::ostream & out, char const * prefix, unsigned_vector const & data) const;
     void display_primitive(std::ostream & out) const;
     void display(std::ostream & out) const;
+    /**
+       \brief Store in \c result a vector of numeric features of the collected formulas.
+       The i-th entry is named get_feature_name(i).
+    */
     void get_feature_vector(vector<double> & result);
+    static unsigned get_num_features();
+    static char const * get_feature_name(unsigned i);
     bool has_uf() const;
     unsigned num_theories() const; 
     unsigned num_non_uf_theories() const; 
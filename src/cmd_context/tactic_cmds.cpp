@@ -153,14 +153,23 @@ public:
         insert_timeout(p);
         insert_max_memory(p);
         p.insert("print_statistics", CPK_BOOL, "(default: false) print statistics.");
+        p.insert("profile", CPK_BOOL, "(default: false) record time, memory and goal sizes of the tactics in the tactic expression and of the tactics they are built from, print them as a tree and report them in the statistics.");
     }
 
-    void display_statistics(cmd_context & ctx, tactic * t) {
+    tactic * mk_tactic(cmd_context & ctx, params_ref const & p, ref<tactic_profile> & prof) {
+        if (p.get_bool("profile", false))
+            prof = alloc(tactic_profile);
+        return using_params(sexpr2tactic(ctx, m_tactic, prof.get()), p);
+    }
+
+    void display_statistics(cmd_context & ctx, tactic * t, tactic_profile * prof) {
         statistics stats;
         get_memory_statistics(stats);
         get_rlimit_statistics(ctx.m().limit(), stats);
         stats.update("time", ctx.get_seconds());
         t->collect_statistics(stats);
+        if (prof)
+            prof->collect_statistics(stats);
         stats.display_smt2(ctx.regular_stream());
     }
 };
@@ -184,7 +193,8 @@ public:
 
     virtual void execute(cmd_context & ctx) {
         params_ref p = ctx.params().merge_default_params(ps());
-        tactic_ref tref = using_params(sexpr2tactic(ctx, m_tactic), p);
+        ref<tactic_profile> prof;
+        tactic_ref tref = mk_tactic(ctx, p, prof);
         tref->set_logic(ctx.get_logic());
         ast_manager & m = ctx.m();
         unsigned timeout   = p.get_uint("timeout", ctx.params().m_timeout);
@@ -232,6 +242,8 @@ public:
                 ctx.validate_check_sat_result(r);
             }
             t.collect_statistics(result->m_stats);
+            if (prof)
+                prof->collect_statistics(result->m_stats);
         }
 
         if (ctx.produce_unsat_cores()) {
@@ -269,7 +281,10 @@ public:
         }
 
         if (p.get_bool("print_statistics", false))
-            display_statistics(ctx, tref.get());
+            display_statistics(ctx, tref.get(), prof.get());
+
+        if (prof)
+            prof->display(ctx.regular_stream());
     }
 };
 
@@ -294,7 +309,8 @@ public:
 
     virtual void execute(cmd_context & ctx) {
         params_ref p = ctx.params().merge_default_params(ps());
-        tactic_ref tref = using_params(sexpr2tactic(ctx, m_tactic), p);
+        ref<tactic_profile> prof;
+        tactic_ref tref = mk_tactic(ctx, p, prof);
         {
             tactic & t = *(tref.get());
             ast_manager & m = ctx.m();
@@ -381,7 +397,10 @@ public:
                 mc->display(ctx.regular_stream());
 
             if (p.get_bool("print_statistics", false))
-                display_statistics(ctx, tref.get());
+                display_statistics(ctx, tref.get(), prof.get());
+
+            if (prof)
+                prof->display(ctx.regular_stream());
         }
     }
 };
@@ -399,71 +418,71 @@ void install_core_tactic_cmds(cmd_context & ctx) {
     install_tactics(ctx);
 }
 
-static tactic * mk_and_then(cmd_context & ctx, sexpr * n) {
+static tactic * mk_and_then(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children < 2)
         throw cmd_exception("invalid and-then combinator, at least one argument expected", n->get_line(), n->get_pos());
     if (num_children == 2)
-        return sexpr2tactic(ctx, n->get_child(1));
+        return sexpr2tactic(ctx, n->get_child(1), prof);
     tactic_ref_buffer args;
     for (unsigned i = 1; i < num_children; i++)
-        args.push_back(sexpr2tactic(ctx, n->get_child(i)));
+        args.push_back(sexpr2tactic(ctx, n->get_child(i), prof));
     return and_then(args.size(), args.c_ptr());
 }
 
-static tactic * mk_or_else(cmd_context & ctx, sexpr * n) {
+static tactic * mk_or_else(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children < 2)
         throw cmd_exception("invalid or-else combinator, at least one argument expected", n->get_line(), n->get_pos());
     if (num_children == 2)
-        return sexpr2tactic(ctx, n->get_child(1));
+        return sexpr2tactic(ctx, n->get_child(1), prof);
     tactic_ref_buffer args;
     for (unsigned i = 1; i < num_children; i++)
-        args.push_back(sexpr2tactic(ctx, n->get_child(i)));
+        args.push_back(sexpr2tactic(ctx, n->get_child(i), prof));
     return or_else(args.size(), args.c_ptr());
 }
 
-static tactic * mk_par(cmd_context & ctx, sexpr * n) {
+static tactic * mk_par(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children < 2)
         throw cmd_exception("invalid par-or combinator, at least one argument expected", n->get_line(), n->get_pos());
     if (num_children == 2)
-        return sexpr2tactic(ctx, n->get_child(1));
+        return sexpr2tactic(ctx, n->get_child(1), prof);
     tactic_ref_buffer args;
     for (unsigned i = 1; i < num_children; i++)
-        args.push_back(sexpr2tactic(ctx, n->get_child(i)));
+        args.push_back(sexpr2tactic(ctx, n->get_child(i), prof));
     return par(args.size(), args.c_ptr());
 }
 
-static tactic * mk_par_then(cmd_context & ctx, sexpr * n) {
+static tactic * mk_par_then(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children < 2)
         throw cmd_exception("invalid par-then combinator, at least one argument expected", n->get_line(), n->get_pos());
     if (num_children == 2)
-        return sexpr2tactic(ctx, n->get_child(1));
+        return sexpr2tactic(ctx, n->get_child(1), prof);
     tactic_ref_buffer args;
     for (unsigned i = 1; i < num_children; i++)
-        args.push_back(sexpr2tactic(ctx, n->get_child(i)));
+        args.push_back(sexpr2tactic(ctx, n->get_child(i), prof));
     return par_and_then(args.size(), args.c_ptr());
 }
 
-static tactic * mk_try_for(cmd_context & ctx, sexpr * n) {
+static tactic * mk_try_for(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children != 3)
         throw cmd_exception("invalid try-for combinator, two arguments expected", n->get_line(), n->get_pos());
     if (!n->get_child(2)->is_numeral() || !n->get_child(2)->get_numeral().is_unsigned())
         throw cmd_exception("invalid try-for combinator, second argument must be an unsigned integer", n->get_line(), n->get_pos());
-    tactic * t = sexpr2tactic(ctx, n->get_child(1));
+    tactic * t = sexpr2tactic(ctx, n->get_child(1), prof);
     unsigned timeout = n->get_child(2)->get_numeral().get_unsigned();
     return try_for(t, timeout);
 }
 
-static tactic * mk_repeat(cmd_context & ctx, sexpr * n) {
+static tactic * mk_repeat(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children != 3 && num_children != 2)
@@ -474,18 +493,18 @@ static tactic * mk_repeat(cmd_context & ctx, sexpr * n) {
             throw cmd_exception("invalid repeat combinator, second argument must be an unsigned integer", n->get_line(), n->get_pos());
         max = n->get_child(2)->get_numeral().get_unsigned();
     }
-    tactic * t = sexpr2tactic(ctx, n->get_child(1));
+    tactic * t = sexpr2tactic(ctx, n->get_child(1), prof);
     return repeat(t, max);
 }
 
-static tactic * mk_using_params(cmd_context & ctx, sexpr * n) {
+static tactic * mk_using_params(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children < 2)
         throw cmd_exception("invalid using-params combinator, at least one argument expected", n->get_line(), n->get_pos());
     if (num_children == 2)
-        return sexpr2tactic(ctx, n->get_child(1));
-    tactic_ref t = sexpr2tactic(ctx, n->get_child(1));
+        return sexpr2tactic(ctx, n->get_child(1), prof);
+    tactic_ref t = sexpr2tactic(ctx, n->get_child(1), prof);
     param_descrs descrs;
     t->collect_param_descrs(descrs);
     params_ref p;
@@ -535,14 +554,14 @@ static tactic * mk_using_params(cmd_context & ctx, sexpr * n) {
     return using_params(t.get(), p);
 }
 
-static tactic * mk_if(cmd_context & ctx, sexpr * n) {
+static tactic * mk_if(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children != 4)
         throw cmd_exception("invalid if/conditional combinator, three arguments expected", n->get_line(), n->get_pos());
     probe_ref   c = sexpr2probe(ctx, n->get_child(1));
-    tactic_ref  t = sexpr2tactic(ctx, n->get_child(2));
-    tactic_ref  e = sexpr2tactic(ctx, n->get_child(3));
+    tactic_ref  t = sexpr2tactic(ctx, n->get_child(2), prof);
+    tactic_ref  e = sexpr2tactic(ctx, n->get_child(3), prof);
     return cond(c.get(), t.get(), e.get());
 }
 
@@ -555,13 +574,13 @@ static tactic * mk_fail_if(cmd_context & ctx, sexpr * n) {
     return fail_if(c.get());
 }
 
-static tactic * mk_when(cmd_context & ctx, sexpr * n) {
+static tactic * mk_when(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children != 3)
         throw cmd_exception("invalid when combinator, two arguments expected", n->get_line(), n->get_pos());
     probe_ref   c = sexpr2probe(ctx, n->get_child(1));
-    tactic_ref  t = sexpr2tactic(ctx, n->get_child(2));
+    tactic_ref  t = sexpr2tactic(ctx, n->get_child(2), prof);
     return cond(c.get(), t.get(), mk_skip_tactic());
 }
 
@@ -592,7 +611,7 @@ static tactic * mk_echo(cmd_context & ctx, sexpr * n) {
     return 0;
 }
 
-static tactic * mk_fail_if_branching(cmd_context & ctx, sexpr * n) {
+static tactic * mk_fail_if_branching(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children != 3 && num_children != 2)
@@ -603,54 +622,54 @@ static tactic * mk_fail_if_branching(cmd_context & ctx, sexpr * n) {
             throw cmd_exception("invalid fail-if-branching combinator, second argument must be an unsigned integer", n->get_line(), n->get_pos());
         threshold = n->get_child(2)->get_numeral().get_unsigned();
     }
-    tactic * t = sexpr2tactic(ctx, n->get_child(1));
+    tactic * t = sexpr2tactic(ctx, n->get_child(1), prof);
     return fail_if_branching(t, threshold);
 }
 
-static tactic * mk_if_no_proofs(cmd_context & ctx, sexpr * n) {
+static tactic * mk_if_no_proofs(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children != 2)
         throw cmd_exception("invalid if-no-proofs combinator, one argument expected", n->get_line(), n->get_pos());
-    tactic * t = sexpr2tactic(ctx, n->get_child(1));
+    tactic * t = sexpr2tactic(ctx, n->get_child(1), prof);
     return if_no_proofs(t);
 }
 
-static tactic * mk_if_no_models(cmd_context & ctx, sexpr * n) {
+static tactic * mk_if_no_models(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children != 2)
         throw cmd_exception("invalid if-no-models combinator, one argument expected", n->get_line(), n->get_pos());
-    tactic * t = sexpr2tactic(ctx, n->get_child(1));
+    tactic * t = sexpr2tactic(ctx, n->get_child(1), prof);
     return if_no_models(t);
 }
 
-static tactic * mk_if_no_unsat_cores(cmd_context & ctx, sexpr * n) {
+static tactic * mk_if_no_unsat_cores(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children != 2)
         throw cmd_exception("invalid if-no-unsat-cores combinator, one argument expected", n->get_line(), n->get_pos());
-    tactic * t = sexpr2tactic(ctx, n->get_child(1));
+    tactic * t = sexpr2tactic(ctx, n->get_child(1), prof);
     return if_no_unsat_cores(t);
 }
 
-static tactic * mk_skip_if_failed(cmd_context & ctx, sexpr * n) {
+static tactic * mk_skip_if_failed(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
     if (num_children != 2)
         throw cmd_exception("invalid skip-if-failed combinator, one argument expected", n->get_line(), n->get_pos());
-    tactic * t = sexpr2tactic(ctx, n->get_child(1));
+    tactic * t = sexpr2tactic(ctx, n->get_child(1), prof);
     return skip_if_failed(t);
 }
 
-tactic * sexpr2tactic(cmd_context & ctx, sexpr * n) {
+static tactic * sexpr2tactic_core(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
     if (n->is_symbol()) {
         tactic_cmd * cmd = ctx.find_tactic_cmd(n->get_symbol());
         if (cmd != 0)
             return cmd->mk(ctx.m());
         sexpr * decl = ctx.find_user_tactic(n->get_symbol());
         if (decl != 0)
-            return sexpr2tactic(ctx, decl);
+            return sexpr2tactic(ctx, decl, prof);
         throw cmd_exception("invalid tactic, unknown tactic ", n->get_symbol(), n->get_line(), n->get_pos());
     }
     else if (n->is_composite()) {
@@ -662,39 +681,39 @@ tactic * sexpr2tactic(cmd_context & ctx, sexpr * n) {
             throw cmd_exception("invalid tactic, symbol expected", n->get_line(), n->get_pos());
         symbol const & cmd_name = head->get_symbol();
         if (cmd_name == "and-then" || cmd_name == "then")
-            return mk_and_then(ctx, n);
+            return mk_and_then(ctx, n, prof);
         else if (cmd_name == "or-else")
-            return mk_or_else(ctx, n);
+            return mk_or_else(ctx, n, prof);
         else if (cmd_name == "par")
-            return mk_par(ctx, n);
+            return mk_par(ctx, n, prof);
         else if (cmd_name == "par-or")
-            return mk_par(ctx, n);
+            return mk_par(ctx, n, prof);
         else if (cmd_name == "par-then")
-            return mk_par_then(ctx, n);
+            return mk_par_then(ctx, n, prof);
         else if (cmd_name == "try-for")
-            return mk_try_for(ctx, n);
+            return mk_try_for(ctx, n, prof);
         else if (cmd_name == "repeat")
-            return mk_repeat(ctx, n);
+            return mk_repeat(ctx, n, prof);
         else if (cmd_name == "if" || cmd_name == "ite" || cmd_name == "cond")
-            return mk_if(ctx, n);
+            return mk_if(ctx, n, prof);
         else if (cmd_name == "fail-if")
             return mk_fail_if(ctx, n);
         else if (cmd_name == "fail-if-branching")
-            return mk_fail_if_branching(ctx, n);
+            return mk_fail_if_branching(ctx, n, prof);
         else if (cmd_name == "when")
-            return mk_when(ctx, n);
+            return mk_when(ctx, n, prof);
         else if (cmd_name == "!" || cmd_name == "using-params" || cmd_name == "with")
-            return mk_using_params(ctx, n);
+            return mk_using_params(ctx, n, prof);
         else if (cmd_name == "echo")
             return mk_echo(ctx, n);
         else if (cmd_name == "if-no-proofs")
-            return mk_if_no_proofs(ctx, n);
+            return mk_if_no_proofs(ctx, n, prof);
         else if (cmd_name == "if-no-models")
-            return mk_if_no_models(ctx, n);
+            return mk_if_no_models(ctx, n, prof);
         else if (cmd_name == "if-no-unsat-cores")
-            return mk_if_no_unsat_cores(ctx, n);
+            return mk_if_no_unsat_cores(ctx, n, prof);
         else if (cmd_name == "skip-if-failed")
-            return mk_skip_if_failed(ctx, n);
+            return mk_skip_if_failed(ctx, n, prof);
         else
             throw cmd_exception("invalid tactic, unknown tactic combinator ", cmd_name, n->get_line(), n->get_pos());
     }
@@ -703,6 +722,21 @@ tactic * sexpr2tactic(cmd_context & ctx, sexpr * n) {
     }
 }
 
+tactic * sexpr2tactic(cmd_context & ctx, sexpr * n, tactic_profile * prof) {
+    if (!prof)
+        return sexpr2tactic_core(ctx, n, prof);
+    symbol name;
+    if (n->is_symbol())
+        name = n->get_symbol();
+    else if (n->is_composite() && n->get_num_children() > 0 && n->get_child(0)->is_symbol())
+        name = n->get_child(0)->get_symbol();
+    else
+        return sexpr2tactic_core(ctx, n, prof);
+    // the tactics a named tactic is built from are profiled too, and a tactical
+    // that is profiled already is renamed after the expression.
+    return profile_tactic(*prof, name.str().c_str(), sexpr2tactic_core(ctx, n, prof));
+}
+
 static probe * mk_not_probe (cmd_context & ctx, sexpr * n) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
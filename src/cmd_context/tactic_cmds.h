@@ -25,6 +25,7 @@ Notes:
 class tactic;
 class probe;
 class tactic_factory;
+class tactic_profile;
 
 class tactic_cmd {
     symbol           m_name;
@@ -46,7 +47,8 @@ public:
 };
 
 void install_core_tactic_cmds(cmd_context & ctx);
-tactic * sexpr2tactic(cmd_context & ctx, sexpr * n);
+// The tactic is profiled in prof, see profile_tactic, unless prof is 0.
+tactic * sexpr2tactic(cmd_context & ctx, sexpr * n, tactic_profile * prof = 0);
 
 class probe_info {
     symbol           m_name;
@@ -0,0 +1,77 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    interval_hwf.h
+
+Abstract:
+
+    Configuration for interval arithmetic over hardware floats.
+    The bounds are computed using outward rounding.
+
+    Clients must include interval_def.h in the compilation unit that
+    uses hwf_interval_manager.
+
+Revision History:
+
+--*/
+#ifndef INTERVAL_HWF_H_
+#define INTERVAL_HWF_H_
+
+#include"interval.h"
+#include"f2n.h"
+#include"hwf.h"
+
+/**
+   \brief Interval manager configuration for f2n<hwf_manager>.
+
+   Remark: f2n<hwf_manager> throws f2n<hwf_manager>::exception when
+   a bound is not a regular floating-point number (e.g., overflow).
+*/
+class im_hwf_config {
+    f2n<hwf_manager> & m_manager;
+public:
+    typedef f2n<hwf_manager>  numeral_manager;
+    typedef hwf               numeral;
+
+    struct interval {
+        numeral   m_lower;
+        numeral   m_upper;
+        unsigned  m_lower_open:1;
+        unsigned  m_upper_open:1;
+        unsigned  m_lower_inf:1;
+        unsigned  m_upper_inf:1;
+        interval():m_lower_open(false), m_upper_open(false), m_lower_inf(true), m_upper_inf(true) {}
+    };
+
+    void round_to_minus_inf() { m_manager.round_to_minus_inf(); }
+    void round_to_plus_inf() { m_manager.round_to_plus_inf(); }
+    void set_rounding(bool to_plus_inf) { m_manager.set_rounding(to_plus_inf); }
+
+    // Getters
+    numeral const & lower(interval const & a) const { return a.m_lower; }
+    numeral const & upper(interval const & a) const { return a.m_upper; }
+    numeral & lower(interval & a) { return a.m_lower; }
+    numeral & upper(interval & a) { return a.m_upper; }
+    bool lower_is_open(interval const & a) const { return a.m_lower_open; }
+    bool upper_is_open(interval const & a) const { return a.m_upper_open; }
+    bool lower_is_inf(interval const & a) const { return a.m_lower_inf; }
+    bool upper_is_inf(interval const & a) const { return a.m_upper_inf; }
+
+    // Setters
+    void set_lower(interval & a, numeral const & n) { m_manager.set(a.m_lower, n); }
+    void set_upper(interval & a, numeral const & n) { m_manager.set(a.m_upper, n); }
+    void set_lower_is_open(interval & a, bool v) { a.m_lower_open = v; }
+    void set_upper_is_open(interval & a, bool v) { a.m_upper_open = v; }
+    void set_lower_is_inf(interval & a, bool v) { a.m_lower_inf = v; }
+    void set_upper_is_inf(interval & a, bool v) { a.m_upper_inf = v; }
+
+    numeral_manager & m() const { return m_manager; }
+
+    im_hwf_config(numeral_manager & m):m_manager(m) {}
+};
+
+typedef interval_manager<im_hwf_config> hwf_interval_manager;
+
+#endif
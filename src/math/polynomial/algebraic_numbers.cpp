@@ -16,6 +16,7 @@ Author:
 Notes:
 
 --*/
+#include<cmath>
 #include"algebraic_numbers.h"
 #include"upolynomial.h"
 #include"mpbq.h"
@@ -24,6 +25,8 @@ Notes:
 #include"sexpr2upolynomial.h"
 #include"scoped_ptr_vector.h"
 #include"mpbqi.h"
+#include"interval_hwf.h"
+#include"interval_def.h"
 #include"timeit.h"
 #include"algebraic_params.hpp"
 #include"common_msgs.h"
@@ -57,6 +60,7 @@ namespace algebraic_numbers {
     typedef upolynomial::numeral_vector upoly;
     typedef upolynomial::scoped_numeral_vector scoped_upoly;
     typedef upolynomial::factors factors;
+    typedef hwf_interval_manager::interval hwf_interval;
 
     void manager::get_param_descrs(param_descrs & r) {
         algebraic_params::collect_param_descrs(r);
@@ -71,6 +75,9 @@ namespace algebraic_numbers {
         mpbqi_manager            m_bqimanager;
         poly_manager             m_pmanager;
         upoly_manager            m_upmanager;
+        hwf_manager              m_hwfmanager;
+        f2n<hwf_manager>         m_f2n;
+        hwf_interval_manager     m_hwf_imanager;
         mpq                      m_zero;
         scoped_mpz               m_is_rational_tmp;
         scoped_upoly             m_isolate_tmp1;
@@ -90,12 +97,15 @@ namespace algebraic_numbers {
         bool                       m_factor;
         polynomial::factor_params  m_factor_params;
         int                        m_zero_accuracy;
+        bool                       m_float_filter;
 
         // statistics
         unsigned                 m_compare_cheap;
         unsigned                 m_compare_sturm;
         unsigned                 m_compare_refine;
         unsigned                 m_compare_poly_eq;
+        unsigned                 m_eval_sign_float;
+        unsigned                 m_eval_sign_fallback;
 
         imp(reslimit& lim, manager & w, unsynch_mpq_manager & m, params_ref const & p, small_object_allocator & a):
             m_limit(lim),
@@ -106,6 +116,8 @@ namespace algebraic_numbers {
             m_bqimanager(m_bqmanager),
             m_pmanager(lim, m, &a),
             m_upmanager(lim, m),
+            m_f2n(m_hwfmanager),
+            m_hwf_imanager(lim, im_hwf_config(m_f2n)),
             m_is_rational_tmp(m),
             m_isolate_tmp1(upm()),
             m_isolate_tmp2(upm()),
@@ -136,6 +148,8 @@ namespace algebraic_numbers {
             m_compare_sturm   = 0;
             m_compare_refine  = 0;
             m_compare_poly_eq = 0;
+            m_eval_sign_float    = 0;
+            m_eval_sign_fallback = 0;
         }
 
         void collect_statistics(statistics & st) {
@@ -145,6 +159,8 @@ namespace algebraic_numbers {
             st.update("algebraic compare refine", m_compare_refine);
             st.update("algebraic compare poly", m_compare_poly_eq);
 #endif
+            st.update("algebraic eval sign float", m_eval_sign_float);
+            st.update("algebraic eval sign fallback", m_eval_sign_fallback);
         }
 
         void updt_params(params_ref const & _p) {
@@ -155,6 +171,7 @@ namespace algebraic_numbers {
             m_factor_params.m_p_trials = p.factor_num_primes();
             m_factor_params.m_max_search_size = p.factor_search_size();
             m_zero_accuracy            = -static_cast<int>(p.zero_accuracy());
+            m_float_filter             = p.float_filter();
         }
 
         unsynch_mpq_manager & qm() {
@@ -1976,6 +1993,90 @@ namespace algebraic_numbers {
         };
 
         polynomial::var_vector m_eval_sign_vars;
+        /**
+           \brief Store in r a float f s.t. f <= k*2^e (f >= k*2^e if to_plus_inf is true).
+           Return false if k*2^e is too big or too small to be safely approximated.
+        */
+        bool to_float(mpz const & k, int e, bool to_plus_inf, hwf & r) {
+            scoped_mpz t(qm());
+            qm().set(t, k);
+            unsigned log2_t = qm().is_neg(t) ? qm().mlog2(t) : qm().log2(t);
+            bool exact = log2_t < 53;
+            if (!exact) {
+                unsigned shift = log2_t - 52;
+                qm().machine_div2k(t, shift);
+                e += shift;
+            }
+            // |t| < 2^53, and t is exactly representable as a double
+            if (e < -900 || e > 900)
+                return false;
+            int64 v = qm().get_int64(t);
+            if (!exact) {
+                // machine_div2k truncates, so k*2^e is in (v-1, v+1)*2^shift
+                v += to_plus_inf ? 1 : -1;
+            }
+            m_f2n.set(r, ldexp(static_cast<double>(v), e));
+            return true;
+        }
+
+        /**
+           \brief Try to determine the sign of p at x2v using interval arithmetic over
+           hardware floats with outward rounding.
+           Return false if the sign could not be determined, i.e., the resultant interval
+           contains zero or the bounds could not be represented as floats.
+
+           \pre Every variable in p is assigned to a non-basic algebraic number in x2v.
+        */
+        bool float_eval_sign_at(polynomial_ref const & p, polynomial::var2anum const & x2v, int & r) {
+            polynomial::manager & ext_pm = p.m();
+            hwf_interval_manager & im = m_hwf_imanager;
+            hwf_interval sum, mon, v;
+            bool result = false;
+            try {
+                m_f2n.set(sum.m_lower, 0);
+                m_f2n.set(sum.m_upper, 0);
+                sum.m_lower_inf = sum.m_upper_inf = false;
+                unsigned sz = ext_pm.size(p);
+                unsigned i  = 0;
+                for (; i < sz; i++) {
+                    mpz const & a = ext_pm.coeff(p, i);
+                    if (!to_float(a, 0, false, mon.m_lower) || !to_float(a, 0, true, mon.m_upper))
+                        break;
+                    mon.m_lower_inf = mon.m_upper_inf = false;
+                    polynomial::monomial * m = ext_pm.get_monomial(p, i);
+                    unsigned msz = ext_pm.size(m);
+                    unsigned j   = 0;
+                    for (; j < msz; j++) {
+                        anum const & val = x2v(ext_pm.get_var(m, j));
+                        SASSERT(!val.is_basic());
+                        algebraic_cell * c = val.to_algebraic();
+                        mpbq const & l = lower(c);
+                        mpbq const & u = upper(c);
+                        if (!to_float(l.numerator(), -static_cast<int>(l.k()), false, v.m_lower) ||
+                            !to_float(u.numerator(), -static_cast<int>(u.k()), true, v.m_upper))
+                            break;
+                        v.m_lower_inf = v.m_upper_inf = false;
+                        im.power(v, ext_pm.degree(m, j), v);
+                        im.mul(mon, v, mon);
+                    }
+                    if (j < msz)
+                        break;
+                    im.add(sum, mon, sum);
+                }
+                if (i == sz && !im.contains_zero(sum)) {
+                    r = im.lower_is_pos(sum) ? 1 : -1;
+                    result = true;
+                }
+            }
+            catch (f2n<hwf_manager>::exception const &) {
+                TRACE("anum_eval_sign", tout << "float interval evaluation failed\n";);
+            }
+            // restore the default rounding mode
+            hwf dummy;
+            m_hwfmanager.set(dummy, MPF_ROUND_NEAREST_TEVEN, 0, 1);
+            return result;
+        }
+
         int eval_sign_at(polynomial_ref const & p, polynomial::var2anum const & x2v) {
             polynomial::manager & ext_pm = p.m();
             TRACE("anum_eval_sign", tout << "evaluating sign of: " << p << "\n";);
@@ -2010,6 +2111,17 @@ namespace algebraic_numbers {
                     return ext_pm.m().sign(ext_pm.coeff(p_prime, 0));
                 }
 
+                // Try to find sign using hardware float intervals
+                if (m_float_filter) {
+                    int s;
+                    if (float_eval_sign_at(p_prime, x2v, s)) {
+                        TRACE("anum_eval_sign", tout << "sign determined using float intervals: " << s << "\n";);
+                        m_eval_sign_float++;
+                        return s;
+                    }
+                    m_eval_sign_fallback++;
+                }
+
                 // Try to find sign using intervals
                 polynomial::var_vector & xs = m_eval_sign_vars;
                 xs.reset();
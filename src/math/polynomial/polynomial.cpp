@@ -1693,6 +1693,10 @@ namespace polynomial {
         return p->id();
     }
 
+    unsigned manager::ref_count(polynomial const * p) {
+        return p->ref_count();
+    }
+
     bool manager::is_unit(monomial const * m) {
         return m->size() == 0;
     }
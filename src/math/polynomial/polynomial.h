@@ -276,6 +276,11 @@ namespace polynomial {
            This id can be used to implement efficient mappings from polynomial to data.
         */
         static unsigned id(polynomial const * p);
+
+        /**
+           \brief Return the number of references to \c p.
+        */
+        static unsigned ref_count(polynomial const * p);
         
         /**
            \brief Return true if \c m is the unit monomial.
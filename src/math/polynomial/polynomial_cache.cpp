@@ -86,6 +86,17 @@ namespace polynomial {
     typedef chashtable<factor_entry*, factor_entry::hash_proc, factor_entry::eq_proc> factor_cache;
     
     struct cache::imp { 
+        struct stats {
+            unsigned m_psc_chain_hits;
+            unsigned m_psc_chain_misses;
+            unsigned m_factor_hits;
+            unsigned m_factor_misses;
+            unsigned m_flushes;
+            unsigned m_collected;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
         manager &                m;
         polynomial_table         m_poly_table;
         psc_chain_cache          m_psc_chain_cache;
@@ -93,8 +104,11 @@ namespace polynomial {
         polynomial_ref_vector    m_cached_polys;
         svector<char>            m_in_cache;
         small_object_allocator & m_allocator;
+        unsigned                 m_max_entries;
+        unsigned                 m_gc_lim; // twice the number of unique polynomials kept by the last collection
+        stats                    m_stats;
 
-        imp(manager & _m):m(_m), m_poly_table(poly_hash_proc(m), poly_eq_proc(m)), m_cached_polys(m), m_allocator(m.allocator()) {
+        imp(manager & _m):m(_m), m_poly_table(poly_hash_proc(m), poly_eq_proc(m)), m_cached_polys(m), m_allocator(m.allocator()), m_max_entries(UINT_MAX), m_gc_lim(0) {
         }
         
         ~imp() {
@@ -134,6 +148,47 @@ namespace polynomial {
             m_factor_cache.reset();
         }
 
+        /**
+           \brief Flush the operation caches if they reached the maximum number of entries,
+           or if the unique polynomial table reached its collection limit.
+           After the flush, the unique polynomials that are only referenced by the cache are
+           removed. The ones referenced by clients (e.g., nlsat atoms) are kept, since clients
+           rely on pointer equality of unique polynomials.
+        */
+        void flush_if_full() {
+            if (m_psc_chain_cache.size() + m_factor_cache.size() < m_max_entries &&
+                m_cached_polys.size() < std::max(m_max_entries, m_gc_lim))
+                return;
+            reset_psc_chain_cache();
+            reset_factor_cache();
+            gc_unique_table();
+            m_stats.m_flushes++;
+        }
+
+        /**
+           \brief Remove the unique polynomials that are only referenced by m_cached_polys.
+           If more than half of the bound is still referenced by clients, the next collection
+           is delayed until the table doubles, so collections remain amortized.
+        */
+        void gc_unique_table() {
+            unsigned j = 0;
+            unsigned sz = m_cached_polys.size();
+            for (unsigned i = 0; i < sz; i++) {
+                polynomial * p = m_cached_polys.get(i);
+                if (m.ref_count(p) == 1) {
+                    m_poly_table.erase(p);
+                    m_in_cache[pid(p)] = false;
+                    m_stats.m_collected++;
+                }
+                else {
+                    m_cached_polys.set(j, p);
+                    j++;
+                }
+            }
+            m_cached_polys.shrink(j);
+            m_gc_lim = 2 * j;
+        }
+
         unsigned pid(polynomial * p) const { return m.id(p); }
         
         polynomial * mk_unique(polynomial * p) {
@@ -148,12 +203,16 @@ namespace polynomial {
         }
 
         void psc_chain(polynomial * p, polynomial * q, var x, polynomial_ref_vector & S) {
+            // p and q are not collected while they are in use.
+            polynomial_ref _p(p, m), _q(q, m);
+            flush_if_full();
             p = mk_unique(p);
             q = mk_unique(q);
-            unsigned h = hash_u_u(pid(p), pid(q));
+            unsigned h = combine_hash(hash_u_u(pid(p), pid(q)), hash_u(x));
             psc_chain_entry * entry = new (m_allocator.allocate(sizeof(psc_chain_entry))) psc_chain_entry(p, q, x, h);
             psc_chain_entry * old_entry = m_psc_chain_cache.insert_if_not_there(entry); 
             if (entry != old_entry) {
+                m_stats.m_psc_chain_hits++;
                 entry->~psc_chain_entry();
                 m_allocator.deallocate(sizeof(psc_chain_entry), entry);
                 S.reset();
@@ -162,6 +221,7 @@ namespace polynomial {
                 }
             }
             else {
+                m_stats.m_psc_chain_misses++;
                 m.psc_chain(p, q, x, S);
                 unsigned sz = S.size();
                 entry->m_result_sz = sz;
@@ -176,11 +236,14 @@ namespace polynomial {
 
         void factor(polynomial * p, polynomial_ref_vector & distinct_factors) {
             distinct_factors.reset();
+            polynomial_ref _p(p, m);
+            flush_if_full();
             p = mk_unique(p);
             unsigned h = hash_u(pid(p));
             factor_entry * entry = new (m_allocator.allocate(sizeof(factor_entry))) factor_entry(p, h);
             factor_entry * old_entry = m_factor_cache.insert_if_not_there(entry); 
             if (entry != old_entry) {
+                m_stats.m_factor_hits++;
                 entry->~factor_entry();
                 m_allocator.deallocate(sizeof(factor_entry), entry);
                 distinct_factors.reset();
@@ -189,6 +252,7 @@ namespace polynomial {
                 }
             }
             else {
+                m_stats.m_factor_misses++;
                 factors fs(m);
                 m.factor(p, fs);
                 unsigned sz = fs.distinct_factors();
@@ -229,7 +293,28 @@ namespace polynomial {
     
     void cache::reset() {
         manager & _m = m();
+        unsigned max_entries = m_imp->m_max_entries;
+        imp::stats st = m_imp->m_stats;
         dealloc(m_imp);
         m_imp = alloc(imp, _m);
+        m_imp->m_max_entries = max_entries;
+        m_imp->m_stats       = st;
+    }
+
+    void cache::set_max_entries(unsigned n) {
+        m_imp->m_max_entries = n;
+    }
+
+    void cache::reset_statistics() {
+        m_imp->m_stats.reset();
+    }
+
+    void cache::collect_statistics(statistics & st) const {
+        st.update("polynomial cache psc hits", m_imp->m_stats.m_psc_chain_hits);
+        st.update("polynomial cache psc misses", m_imp->m_stats.m_psc_chain_misses);
+        st.update("polynomial cache factor hits", m_imp->m_stats.m_factor_hits);
+        st.update("polynomial cache factor misses", m_imp->m_stats.m_factor_misses);
+        st.update("polynomial cache flushes", m_imp->m_stats.m_flushes);
+        st.update("polynomial cache collected", m_imp->m_stats.m_collected);
     }
 };
@@ -20,11 +20,17 @@ Notes:
 #define POLYNOMIAL_CACHE_H_
 
 #include"polynomial.h"
+#include"statistics.h"
 
 namespace polynomial {
 
     /**
        \brief Functor for creating unique polynomials and caching results of operations
+
+       The psc_chain and factor results are memoized across calls. The number of memoized
+       results and unique polynomials can be bounded using set_max_entries. When the bound
+       is reached, the operation caches are flushed, and the unique polynomials that are not
+       referenced outside of the cache are removed.
     */
     class cache {
         struct imp;
@@ -38,6 +44,9 @@ namespace polynomial {
         void psc_chain(polynomial const * p, polynomial const * q, var x, polynomial_ref_vector & S);
         void factor(polynomial const * p, polynomial_ref_vector & distinct_factors);
         void reset();
+        void set_max_entries(unsigned n);
+        void reset_statistics();
+        void collect_statistics(statistics & st) const;
     };
 };
 
@@ -76,18 +76,32 @@ model * model::copy() const {
 }
 
 // Remark: eval is for backward compatibility. We should use model_evaluator.
+//
+// The evaluator (and its theory rewriters) is created on the first call
+// and reused afterwards, since clients such as Z3_model_eval evaluate many
+// small terms over the same model. The result cache is cleared after each
+// call because the model may be updated between calls. Since the evaluator
+// is shared, concurrent calls on the same model are not safe.
 bool model::eval(expr * e, expr_ref & result, bool model_completion) {
-    model_evaluator ev(*this);
+    if (!m_evaluator)
+        m_evaluator = alloc(model_evaluator, *this);
+    model_evaluator & ev = *m_evaluator;
     ev.set_model_completion(model_completion);
+    bool r = true;
     try {
         ev(e, result);
-        return true;
     }
     catch (model_evaluator_exception & ex) {
         (void)ex;
         TRACE("model_evaluator", tout << ex.msg() << "\n";);
-        return false;
+        r = false;
     }
+    catch (...) {
+        ev.reset_cache();
+        throw;
+    }
+    ev.reset_cache();
+    return r;
 }
 
 struct model::value_proc : public some_value_proc {
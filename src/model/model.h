@@ -23,14 +23,21 @@ Revision History:
 #include"ref.h"
 #include"ast_translation.h"
 
+class model_evaluator;
+
 class model : public model_core {
 protected:
     typedef obj_map<sort, ptr_vector<expr>*> sort2universe;
     
     ptr_vector<sort>              m_usorts;
     sort2universe                 m_usort2universe;
+    scoped_ptr<model_evaluator>   m_evaluator; // lazily created, reused by eval
     struct value_proc;
 
+    // the evaluator refers to the model, use copy() or translate() instead.
+    model(model const & other);
+    model & operator=(model const & other);
+
 public:
     model(ast_manager & m);
     virtual ~model(); 
@@ -42,6 +49,14 @@ public:
     model * copy() const;
     
     bool eval(func_decl * f, expr_ref & r) const { return model_core::eval(f, r); }
+    /**
+       \brief Evaluate \c e in the model. The evaluator is created on the first call
+       with the default parameters of model_evaluator, and it is shared by later calls.
+       Use a model_evaluator to evaluate with other parameters.
+
+       Calls that evaluate in the same model from different threads must be
+       synchronized by the caller, since they share the evaluator.
+    */
     bool eval(expr * e, expr_ref & result, bool model_completion = false);
     
     virtual expr * get_some_value(sort * s);
@@ -45,6 +45,10 @@ public:
 
     void cleanup(params_ref const & p = params_ref());
     void reset(params_ref const & p = params_ref());
+    /**
+       \brief Clear cached results, but keep the configuration and the rewriters.
+    */
+    void reset_cache();
     
     unsigned get_num_steps() const;
 };
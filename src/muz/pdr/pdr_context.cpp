@@ -82,7 +82,8 @@ namespace pdr {
         ctx(ctx), m_head(head, m),
         m_sig(m), m_solver(pm, head->get_name()),
         m_invariants(m), m_transition(m), m_initial_state(m),
-        m_reachable(pm, (datalog::PDR_CACHE_MODE)ctx.get_params().pdr_cache_mode()) {}
+        m_reachable(pm, (datalog::PDR_CACHE_MODE)ctx.get_params().pdr_cache_mode()),
+        m_stamp(0) {}
 
     pred_transformer::~pred_transformer() {
         rule2inst::iterator it2 = m_rule2inst.begin(), end2 = m_rule2inst.end();
@@ -109,6 +110,7 @@ namespace pdr {
         m_solver.collect_statistics(st);
         m_reachable.collect_statistics(st);
         st.update("PDR num propagations", m_stats.m_num_propagations);
+        st.update("PDR num propagations skipped", m_stats.m_num_propagations_skipped);
         unsigned np = m_invariants.size();
         for (unsigned i = 0; i < m_levels.size(); ++i) {
             np += m_levels[i].size();
@@ -272,6 +274,17 @@ namespace pdr {
                tout << "propagating " << src_level << " to " << tgt_level;
                tout << " for relation " << head()->get_name() << "\n";);
 
+        // The lemmas in src failed to propagate and no lemma was added to this 
+        // predicate or to its body predicates since. The checks would fail again.
+        if (!src.empty() &&
+            ctx.get_params().pdr_incremental_propagate() &&
+            src_level < m_propagate_stamp.size() &&
+            m_propagate_stamp[src_level] == m_stamp) {
+            TRACE("pdr", tout << "skipping propagation, frames did not change\n";);
+            m_stats.m_num_propagations_skipped += src.size();
+            return false;
+        }
+
         for (unsigned i = 0; i < src.size(); ) {
             expr * curr = src[i].get();
             unsigned stored_lvl = 0;
@@ -296,6 +309,7 @@ namespace pdr {
                 ++i;
             }
         }
+        m_propagate_stamp.setx(src_level, src.empty() ? UINT_MAX : m_stamp, UINT_MAX);
         IF_VERBOSE(3, verbose_stream() << "propagate: " << pp_level(src_level) << "\n";
                    for (unsigned i = 0; i < src.size(); ++i) {
                        verbose_stream() << mk_pp(src[i].get(), m) << "\n";
@@ -310,6 +324,7 @@ namespace pdr {
                 m_invariants.push_back(lemma);
                 m_prop2level.insert(lemma, lvl);
                 m_solver.add_formula(lemma);
+                ++m_stamp;
                 return true;
             }
             else {
@@ -324,6 +339,7 @@ namespace pdr {
             m_levels[lvl].push_back(lemma);
             m_prop2level.insert(lemma, lvl);
             m_solver.add_level_formula(lemma, lvl);
+            ++m_stamp;
             return true;
         }
         else {
@@ -334,6 +350,7 @@ namespace pdr {
 
     void pred_transformer::add_child_property(pred_transformer& child, expr* lemma, unsigned lvl) {
         ensure_level(lvl);
+        ++m_stamp;
         expr_ref_vector fmls(m);
         mk_assumptions(child.head(), lemma, fmls);
         for (unsigned i = 0; i < fmls.size(); ++i) {
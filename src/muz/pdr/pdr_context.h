@@ -56,6 +56,7 @@ namespace pdr {
 
         struct stats {
             unsigned m_num_propagations;
+            unsigned m_num_propagations_skipped;
             stats() { reset(); }
             void reset() { memset(this, 0, sizeof(*this)); }
         };
@@ -84,6 +85,8 @@ namespace pdr {
         expr_ref                     m_initial_state;   // initial state.
         reachable_cache              m_reachable; 
         ptr_vector<func_decl>        m_predicates;
+        unsigned                     m_stamp;           // incremented whenever a lemma is added to m_solver.
+        unsigned_vector              m_propagate_stamp; // value of m_stamp after the last unsuccessful propagation from a level.
         stats                        m_stats;
 
         void init_sig();
@@ -29,6 +29,9 @@ Revision History:
 #include "model_v2_pp.h"
 #include "expr_functors.h"
 #include "for_each_expr.h"
+#include "map.h"
+#include "scoped_ptr_vector.h"
+#include "statistics.h"
 
 
 using namespace qe;
@@ -126,6 +129,36 @@ class mbp::impl {
     ptr_vector<project_plugin> m_plugins;
     expr_mark m_visited;
 
+    /**
+       A projection computed for a model M remains a valid projection of
+       the same variables and formulas for every other model M' that
+       satisfies it: it implies the existential closure of the input
+       independently of M. Projections are cached by their (unordered)
+       inputs and reused for models that satisfy them.
+    */
+    struct projection {
+        unsigned         m_hash;
+        unsigned_vector  m_key;    // force_elim flag, ids of the variables, UINT_MAX, ids of the formulas
+        app_ref_vector   m_vars_in;
+        expr_ref_vector  m_fmls_in;
+        app_ref_vector   m_vars;   // variables that were not eliminated
+        expr_ref_vector  m_fmls;   // projected formulas
+        unsigned         m_next;   // next projection with the same hash
+        projection(ast_manager& m): m_vars_in(m), m_fmls_in(m), m_vars(m), m_fmls(m), m_next(UINT_MAX) {}
+    };
+    scoped_ptr_vector<projection> m_projections;
+    u_map<unsigned>               m_hash2projection;
+    unsigned                      m_max_projections;
+
+    struct stats {
+        unsigned m_num_projections;
+        unsigned m_num_cache_hits;
+        unsigned m_num_cache_flushes;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+    stats m_stats;
+
     void add_plugin(project_plugin* p) {
         family_id fid = p->get_family_id();
         SASSERT(!m_plugins.get(fid, 0));
@@ -407,7 +440,7 @@ public:
         m_visited.reset();
     }
 
-    impl(ast_manager& m):m(m), m_rw(m) {
+    impl(ast_manager& m):m(m), m_rw(m), m_max_projections(1000) {
         add_plugin(alloc(arith_project_plugin, m));
         add_plugin(alloc(datatype_project_plugin, m));
         add_plugin(alloc(array_project_plugin, m));
@@ -438,7 +471,134 @@ public:
         return true;
     }
 
+    unsigned mk_key(bool force_elim, app_ref_vector const& vars, expr_ref_vector const& fmls, unsigned_vector& key) {
+        key.reset();
+        key.push_back(force_elim);
+        unsigned sz = key.size();
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            key.push_back(vars[i]->get_id());
+        }
+        std::sort(key.begin() + sz, key.end());
+        key.push_back(UINT_MAX);
+        sz = key.size();
+        for (unsigned i = 0; i < fmls.size(); ++i) {
+            key.push_back(fmls[i]->get_id());
+        }
+        std::sort(key.begin() + sz, key.end());
+        unsigned h = 17;
+        for (unsigned i = 0; i < key.size(); ++i) {
+            h = combine_hash(h, key[i]);
+        }
+        return h;
+    }
+
+    bool holds(model& model, expr_ref_vector const& fmls) {
+        expr_ref val(m);
+        for (unsigned i = 0; i < fmls.size(); ++i) {
+            if (!model.eval(fmls[i], val) || !m.is_true(val)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool same_key(unsigned_vector const& k1, unsigned_vector const& k2) {
+        if (k1.size() != k2.size()) {
+            return false;
+        }
+        for (unsigned i = 0; i < k1.size(); ++i) {
+            if (k1[i] != k2[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool find_projection(unsigned h, unsigned_vector const& key, model& model, app_ref_vector& vars, expr_ref_vector& fmls) {
+        unsigned idx;
+        if (!m_hash2projection.find(h, idx)) {
+            return false;
+        }
+        for (; idx != UINT_MAX; idx = m_projections[idx]->m_next) {
+            projection const& p = *m_projections[idx];
+            if (same_key(p.m_key, key) && holds(model, p.m_fmls)) {
+                vars.reset();
+                vars.append(p.m_vars);
+                fmls.reset();
+                fmls.append(p.m_fmls);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void insert_projection(unsigned h, unsigned_vector const& key, 
+                           app_ref_vector const& vars_in, expr_ref_vector const& fmls_in,
+                           app_ref_vector const& vars, expr_ref_vector const& fmls) {
+        // projections that introduce fresh variables are not reused.
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            if (!vars_in.contains(vars[i])) {
+                return;
+            }
+        }
+        if (m_projections.size() >= m_max_projections) {
+            m_projections.reset();
+            m_hash2projection.reset();
+            ++m_stats.m_num_cache_flushes;
+        }
+        projection* p = alloc(projection, m);
+        p->m_hash = h;
+        p->m_key.append(key);
+        p->m_vars_in.append(vars_in);
+        p->m_fmls_in.append(fmls_in);
+        p->m_vars.append(vars);
+        p->m_fmls.append(fmls);
+        unsigned next;
+        if (m_hash2projection.find(h, next)) {
+            p->m_next = next;
+        }
+        m_hash2projection.insert(h, m_projections.size());
+        m_projections.push_back(p);
+    }
+
+    void collect_statistics(statistics& st) const {
+        st.update("mbp projections", m_stats.m_num_projections);
+        st.update("mbp projection cache hits", m_stats.m_num_cache_hits);
+        st.update("mbp projection cache flushes", m_stats.m_num_cache_flushes);
+    }
+
+    void reset_statistics() {
+        m_stats.reset();
+    }
+
+    void set_max_projections(unsigned n) {
+        m_max_projections = n;
+        if (m_projections.size() > n) {
+            m_projections.reset();
+            m_hash2projection.reset();
+        }
+    }
+
     void operator()(bool force_elim, app_ref_vector& vars, model& model, expr_ref_vector& fmls) {
+        ++m_stats.m_num_projections;
+        if (m_max_projections == 0) {
+            project(force_elim, vars, model, fmls);
+            return;
+        }
+        unsigned_vector key;
+        unsigned h = mk_key(force_elim, vars, fmls, key);
+        if (find_projection(h, key, model, vars, fmls)) {
+            ++m_stats.m_num_cache_hits;
+            TRACE("qe", tout << "cached projection " << vars << " " << fmls << "\n";);
+            return;
+        }
+        app_ref_vector vars_in(vars);
+        expr_ref_vector fmls_in(fmls);
+        project(force_elim, vars, model, fmls);
+        insert_projection(h, key, vars_in, fmls_in, vars, fmls);
+    }
+
+    void project(bool force_elim, app_ref_vector& vars, model& model, expr_ref_vector& fmls) {
         SASSERT(validate_model(model, fmls));
         expr_ref val(m), tmp(m);
         app_ref var(m);
@@ -512,6 +672,18 @@ void mbp::operator()(bool force_elim, app_ref_vector& vars, model& mdl, expr_ref
     (*m_impl)(force_elim, vars, mdl, fmls);
 }
 
+void mbp::collect_statistics(statistics& st) const {
+    m_impl->collect_statistics(st);
+}
+
+void mbp::reset_statistics() {
+    m_impl->reset_statistics();
+}
+
+void mbp::set_max_projections(unsigned n) {
+    m_impl->set_max_projections(n);
+}
+
 void mbp::solve(model& model, app_ref_vector& vars, expr_ref_vector& fmls) {
     m_impl->preprocess_solve(model, vars, fmls);
 }
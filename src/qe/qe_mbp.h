@@ -25,6 +25,7 @@ Revision History:
 #include "params.h"
 #include "model.h"
 #include "model_based_opt.h"
+#include "statistics.h"
 
 
 namespace qe {
@@ -80,6 +81,16 @@ namespace qe {
            Maximize objective t under current model for constraints in fmls.
          */
         opt::inf_eps maximize(expr_ref_vector const& fmls, model& mdl, app* t, expr_ref& ge, expr_ref& gt);
+
+        /**
+           \brief
+           Set the maximal number of cached projections. 0 disables the cache.
+         */
+        void set_max_projections(unsigned n);
+
+        void collect_statistics(statistics& st) const;
+
+        void reset_statistics();
     };
 }
 
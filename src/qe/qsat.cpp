@@ -1198,6 +1198,7 @@ namespace qe {
             m_gt(m)
         {
             reset();
+            updt_params(p);
         }
         
         virtual ~qsat() {
@@ -1205,9 +1206,14 @@ namespace qe {
         }
         
         void updt_params(params_ref const & p) {
+            m_params.append(p);
+            // every projection is blocked once it is returned, so a later
+            // model of the same level never satisfies a cached projection.
+            m_mbp.set_max_projections(m_params.get_uint("max_projections", 0));
         }
         
         void collect_param_descrs(param_descrs & r) {
+            r.insert("max_projections", CPK_UINT, "(default: 0) maximal number of model-based projections cached for reuse, 0 disables the cache");
         }
 
         
@@ -1294,12 +1300,14 @@ namespace qe {
             m_pred_abs.collect_statistics(st);
             st.update("qsat num rounds", m_stats.m_num_rounds); 
             m_pred_abs.collect_statistics(st);
+            m_mbp.collect_statistics(st);
         }
         
         void reset_statistics() {
             m_stats.reset();
             m_fa.reset();
             m_ex.reset();
+            m_mbp.reset_statistics();
         }
         
         void cleanup() {
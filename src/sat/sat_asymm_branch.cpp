@@ -26,7 +26,9 @@ namespace sat {
 
     asymm_branch::asymm_branch(solver & _s, params_ref const & p):
         s(_s),
-        m_counter(0) {
+        m_counter(0),
+        m_cost(0),
+        m_learned_cost(0) {
         updt_params(p);
         reset_statistics();
     }
@@ -35,21 +37,31 @@ namespace sat {
         bool operator()(clause * c1, clause * c2) const { return c1->size() > c2->size(); }
     };
 
+    struct clause_glue_lt {
+        bool operator()(clause * c1, clause * c2) const {
+            if (c1->glue() != c2->glue()) return c1->glue() < c2->glue();
+            return c1->size() < c2->size();
+        }
+    };
+
     struct asymm_branch::report {
         asymm_branch & m_asymm_branch;
         stopwatch      m_watch;
+        bool           m_learned;
         unsigned       m_elim_literals;
-        report(asymm_branch & a):
+        report(asymm_branch & a, bool learned):
             m_asymm_branch(a),
-            m_elim_literals(a.m_elim_literals) {
+            m_learned(learned),
+            m_elim_literals(learned ? a.m_elim_learned_literals : a.m_elim_literals) {
             m_watch.start();
         }
         
         ~report() {
             m_watch.stop();
+            unsigned elim_literals = m_learned ? m_asymm_branch.m_elim_learned_literals : m_asymm_branch.m_elim_literals;
             IF_VERBOSE(SAT_VB_LVL, 
-                       verbose_stream() << " (sat-asymm-branch :elim-literals "
-                       << (m_asymm_branch.m_elim_literals - m_elim_literals)
+                       verbose_stream() << (m_learned ? " (sat-asymm-branch-learned" : " (sat-asymm-branch")
+                       << " :elim-literals " << (elim_literals - m_elim_literals)
                        << " :cost " << m_asymm_branch.m_counter
                        << mem_stat()
                        << " :time " << std::fixed << std::setprecision(2) << m_watch.get_seconds() << ")\n";);
@@ -66,16 +78,68 @@ namespace sat {
             return;
         CASSERT("asymm_branch", s.check_invariant());
         TRACE("asymm_branch_detail", s.display(tout););
-        report rpt(*this);
+        report rpt(*this, false);
         svector<char> saved_phase(s.m_phase);
         m_counter  = 0; // counter is moving down to capture propagate cost.
         int limit  = -static_cast<int>(m_asymm_branch_limit);
         std::stable_sort(s.m_clauses.begin(), s.m_clauses.end(), clause_size_lt());
         m_counter -= s.m_clauses.size();
+        try {
+            process(s.m_clauses, limit);
+        }
+        catch (solver_exception & ex) {
+            m_counter = -m_counter;
+            m_cost   += m_counter;
+            throw ex;
+        }
+        m_counter = -m_counter;
+        m_cost   += m_counter;
+        s.m_phase = saved_phase;
+        CASSERT("asymm_branch", s.check_invariant());
+    }
+
+    void asymm_branch::learned() {
+        if (!m_asymm_branch_learned)
+            return;
+        s.propagate(false); // must propagate, since it uses s.push()
+        if (s.m_inconsistent)
+            return;
+        CASSERT("asymm_branch", s.check_invariant());
+        svector<char> saved_phase(s.m_phase);
+        // m_counter is used to decide when to process the problem
+        // clauses again.
+        int saved_counter = m_counter;
+        unsigned elim_literals = m_elim_literals;
+        {
+            report rpt(*this, true);
+            int limit  = -static_cast<int>(m_asymm_branch_learned_limit);
+            std::stable_sort(s.m_learned.begin(), s.m_learned.end(), clause_glue_lt());
+            m_counter  = -static_cast<int>(s.m_learned.size());
+            try {
+                process(s.m_learned, limit);
+            }
+            catch (solver_exception & ex) {
+                m_elim_learned_literals += m_elim_literals - elim_literals;
+                m_elim_literals = elim_literals;
+                m_learned_cost += -m_counter;
+                m_counter = saved_counter;
+                throw ex;
+            }
+            m_elim_learned_literals += m_elim_literals - elim_literals;
+            m_elim_literals = elim_literals;
+            m_counter = -m_counter;
+            m_learned_cost += m_counter;
+        }
+        m_counter = saved_counter;
+        s.m_phase = saved_phase;
+        CASSERT("asymm_branch", s.check_invariant());
+    }
+
+    void asymm_branch::process(clause_vector & clauses, int limit) {
         SASSERT(s.m_qhead == s.m_trail.size());
-        clause_vector::iterator it  = s.m_clauses.begin();
+        clause_vector::iterator it  = clauses.begin();
         clause_vector::iterator it2 = it;
-        clause_vector::iterator end = s.m_clauses.end();
+        clause_vector::iterator end = clauses.end();
         try {
             for (; it != end; ++it) {
                 if (s.inconsistent()) {
@@ -85,7 +149,8 @@ namespace sat {
                     break;
                 }
                 SASSERT(s.m_qhead == s.m_trail.size());
-                if (m_counter < limit || s.inconsistent()) {
+                // frozen learned clauses are not attached.
+                if (m_counter < limit || (*it)->frozen()) {
                     *it2 = *it;
                     ++it2;
                     continue;
@@ -99,20 +164,16 @@ namespace sat {
                 // throw exception to test bug fix: if (it2 != it) throw solver_exception("trigger bug");
                 ++it2;
             }
-            s.m_clauses.set_end(it2);
+            clauses.set_end(it2);
         }
         catch (solver_exception & ex) {
-            // put m_clauses in a consistent state...
+            // put clauses in a consistent state...
             for (; it != end; ++it, ++it2) {
                 *it2 = *it;
             }
-            s.m_clauses.set_end(it2);
-            m_counter = -m_counter;
+            clauses.set_end(it2);
             throw ex;
         }
-        m_counter = -m_counter;
-        s.m_phase = saved_phase;
-        CASSERT("asymm_branch", s.check_invariant());
     }
 
     bool asymm_branch::process(clause & c) {
@@ -194,7 +255,7 @@ namespace sat {
             return false; // check_missed_propagation() may fail, since m_clauses is not in a consistent state.
         case 2:
             SASSERT(s.value(c[0]) == l_undef && s.value(c[1]) == l_undef);
-            s.mk_bin_clause(c[0], c[1], false);
+            s.mk_bin_clause(c[0], c[1], c.is_learned());
             s.del_clause(c);
             SASSERT(s.m_qhead == s.m_trail.size());
             return false;
@@ -213,6 +274,10 @@ namespace sat {
         m_asymm_branch_limit  = p.asymm_branch_limit();
         if (m_asymm_branch_limit > INT_MAX)
             m_asymm_branch_limit = INT_MAX;
+        m_asymm_branch_learned       = p.asymm_branch_learned();
+        m_asymm_branch_learned_limit = p.asymm_branch_learned_limit();
+        if (m_asymm_branch_learned_limit > INT_MAX)
+            m_asymm_branch_learned_limit = INT_MAX;
     }
 
     void asymm_branch::collect_param_descrs(param_descrs & d) {
@@ -221,10 +286,12 @@ namespace sat {
     
     void asymm_branch::collect_statistics(statistics & st) const {
         st.update("elim literals", m_elim_literals);
+        st.update("elim learned literals", m_elim_learned_literals);
     }
 
     void asymm_branch::reset_statistics() {
         m_elim_literals = 0;
+        m_elim_learned_literals = 0;
     }
 
 };
@@ -27,6 +27,7 @@ namespace sat {
     class solver;
 
     class asymm_branch {
+        friend class inprocessing;
         struct report;
         
         solver & s;
@@ -36,16 +37,29 @@ namespace sat {
         bool                   m_asymm_branch;
         unsigned               m_asymm_branch_rounds;
         unsigned               m_asymm_branch_limit;
+        bool                   m_asymm_branch_learned;
+        unsigned               m_asymm_branch_learned_limit;
 
         // stats
         unsigned m_elim_literals;
+        unsigned m_elim_learned_literals;
+        unsigned m_cost;          // cost of all rounds on the problem clauses, in the units of m_counter
+        unsigned m_learned_cost;  // cost of all rounds on the learned clauses
 
         bool process(clause & c);
+        void process(clause_vector & clauses, int limit);
     public:
         asymm_branch(solver & s, params_ref const & p);
 
         void operator()(bool force = false);
 
+        /**
+           \brief Apply asymmetric branching to the learned clauses, also
+           known as vivification. Clauses with small glue are processed
+           first.
+        */
+        void learned();
+
         void updt_params(params_ref const & p);
         static void collect_param_descrs(param_descrs & d);
 
@@ -0,0 +1,354 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_card_extension.cpp
+
+Abstract:
+
+    Native propagation of cardinality and pseudo-Boolean constraints.
+
+Notes:
+
+--*/
+#include"sat_card_extension.h"
+
+namespace sat {
+
+    card_extension::constraint::constraint(literal lit, svector<wliteral> const& wlits, unsigned k):
+        m_lit(lit),
+        m_k(k),
+        m_max_coeff(0),
+        m_num_watch(0),
+        m_wlits(wlits) {
+        for (unsigned i = 0; i < wlits.size(); ++i) {
+            m_max_coeff = std::max(m_max_coeff, wlits[i].first);
+        }
+    }
+
+    card_extension::card_extension():
+        m_solver(0) {
+    }
+
+    card_extension::~card_extension() {
+    }
+
+    struct wliteral_lt {
+        bool operator()(card_extension::wliteral const& a, card_extension::wliteral const& b) const {
+            return a.second.index() < b.second.index();
+        }
+    };
+
+    /**
+       \brief Merge occurrences of the same variable in m_wlits, remove
+       literals with coefficient 0, and bound the coefficients by k.
+    */
+    void card_extension::normalize(unsigned& k) {
+        std::sort(m_wlits.begin(), m_wlits.end(), wliteral_lt());
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_wlits.size(); ++i) {
+            wliteral wl = m_wlits[i];
+            if (j == 0 || m_wlits[j-1].second.var() != wl.second.var()) {
+                m_wlits[j++] = wl;
+                continue;
+            }
+            wliteral & prev = m_wlits[j-1];
+            if (prev.second == wl.second) {
+                prev.first += wl.first;
+            }
+            else if (prev.first >= wl.first) {
+                // a*x + b*~x = b + (a - b)*x
+                k -= std::min(k, wl.first);
+                prev.first -= wl.first;
+            }
+            else {
+                k -= std::min(k, prev.first);
+                prev = wliteral(wl.first - prev.first, wl.second);
+            }
+        }
+        m_wlits.shrink(j);
+        j = 0;
+        for (unsigned i = 0; i < m_wlits.size(); ++i) {
+            if (m_wlits[i].first > 0) {
+                m_wlits[j++] = wliteral(std::min(k, m_wlits[i].first), m_wlits[i].second);
+            }
+        }
+        m_wlits.shrink(j);
+    }
+
+    void card_extension::add_at_least(literal lit, literal_vector const& lits, unsigned k) {
+        svector<wliteral> wlits;
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            wlits.push_back(wliteral(1, lits[i]));
+        }
+        add_pb_ge(lit, wlits, k);
+    }
+
+    void card_extension::add_pb_ge(literal lit, svector<wliteral> const& wlits, unsigned k) {
+        SASSERT(m_solver);
+        m_wlits.reset();
+        // the constraint is only enforced when lit is true, so lit is
+        // true and ~lit is false within it. They are removed, otherwise
+        // enabling the constraint would change the watch list of lit
+        // while the solver traverses it.
+        for (unsigned i = 0; i < wlits.size(); ++i) {
+            if (wlits[i].second == lit) {
+                k -= std::min(k, wlits[i].first);
+            }
+            else if (wlits[i].second != ~lit) {
+                m_wlits.push_back(wlits[i]);
+            }
+        }
+        normalize(k);
+        if (k == 0) {
+            return;
+        }
+        unsigned sum = 0;
+        for (unsigned i = 0; i < m_wlits.size(); ++i) {
+            sum += m_wlits[i].first;
+        }
+        if (sum < k) {
+            literal nlit = ~lit;
+            s().mk_clause(1, &nlit);
+            return;
+        }
+        if (!s().m_user_scope_literals.empty()) {
+            // guard the constraint by a literal that is implied by lit
+            // only within the current user scope. Propagations and
+            // lemmas that use the constraint then depend on the scope.
+            literal g(s().mk_var(true, false), false);
+            literal lits[2] = { ~lit, g };
+            s().mk_clause(2, lits);
+            lit = g;
+        }
+        s().set_external(lit.var());
+        for (unsigned i = 0; i < m_wlits.size(); ++i) {
+            s().set_external(m_wlits[i].second.var());
+        }
+        ext_constraint_idx idx = m_constraints.size();
+        m_constraints.push_back(constraint(lit, m_wlits, k));
+        s().get_wlist(lit).push_back(watched(idx));
+        TRACE("sat_card", display(tout););
+        if (value(lit) == l_true) {
+            init_watch(idx);
+        }
+    }
+
+    void card_extension::watch_literal(literal l, ext_constraint_idx idx) {
+        s().get_wlist(~l).push_back(watched(idx));
+    }
+
+    void card_extension::unwatch_literal(literal l, ext_constraint_idx idx) {
+        s().get_wlist(~l).erase(watched(idx));
+    }
+
+    void card_extension::clear_watch(ext_constraint_idx idx) {
+        constraint & c = m_constraints[idx];
+        for (unsigned i = 0; i < c.num_watch(); ++i) {
+            unwatch_literal(c[i].second, idx);
+        }
+        c.set_num_watch(0);
+    }
+
+    /**
+       \brief Select the watched literals of a constraint whose
+       literal was assigned to true.
+    */
+    void card_extension::init_watch(ext_constraint_idx idx) {
+        clear_watch(idx);
+        constraint & c = m_constraints[idx];
+        unsigned sz = c.size();
+        unsigned num_non_false = 0;
+        for (unsigned i = 0; i < sz; ++i) {
+            if (value(c[i].second) != l_false) {
+                c.swap(i, num_non_false);
+                ++num_non_false;
+            }
+        }
+        unsigned bound = c.k() + c.max_coeff();
+        unsigned sum = 0, num_watch = 0;
+        for (; num_watch < num_non_false && sum < bound; ++num_watch) {
+            sum += c[num_watch].first;
+        }
+        if (sum >= bound) {
+            for (unsigned i = 0; i < num_watch; ++i) {
+                watch_literal(c[i].second, idx);
+            }
+            c.set_num_watch(num_watch);
+        }
+        else {
+            for (unsigned i = 0; i < sz; ++i) {
+                watch_literal(c[i].second, idx);
+            }
+            c.set_num_watch(sz);
+            propagate_core(idx);
+        }
+    }
+
+    /**
+       \brief Propagate or detect a conflict for a constraint where all
+       non-false literals are watched.
+    */
+    void card_extension::propagate_core(ext_constraint_idx idx) {
+        constraint const & c = m_constraints[idx];
+        unsigned slack = 0;
+        for (unsigned i = 0; i < c.num_watch(); ++i) {
+            if (value(c[i].second) != l_false) {
+                slack += c[i].first;
+            }
+        }
+        if (slack < c.k()) {
+            set_conflict(idx);
+            return;
+        }
+        for (unsigned i = 0; i < c.num_watch() && !s().inconsistent(); ++i) {
+            wliteral wl = c[i];
+            if (value(wl.second) == l_undef && slack - wl.first < c.k()) {
+                ++m_stats.m_num_propagations;
+                s().assign(wl.second, justification::mk_ext_justification(idx));
+            }
+        }
+    }
+
+    void card_extension::set_conflict(ext_constraint_idx idx) {
+        TRACE("sat_card", tout << "conflict: " << idx << "\n";);
+        ++m_stats.m_num_conflicts;
+        s().set_conflict(justification::mk_ext_justification(idx));
+    }
+
+    void card_extension::propagate(literal l, ext_constraint_idx idx, bool & keep) {
+        keep = true;
+        constraint & c = m_constraints[idx];
+        if (l == c.lit()) {
+            init_watch(idx);
+            return;
+        }
+        if (value(c.lit()) != l_true) {
+            // the watches are reset when the constraint is enabled.
+            return;
+        }
+        literal not_l = ~l;
+        unsigned num_watch = c.num_watch();
+        unsigned index = num_watch;
+        unsigned slack = 0;
+        for (unsigned i = 0; i < num_watch; ++i) {
+            literal lit = c[i].second;
+            if (lit == not_l) {
+                index = i;
+            }
+            else if (value(lit) != l_false) {
+                slack += c[i].first;
+            }
+        }
+        if (index == num_watch) {
+            keep = false;
+            return;
+        }
+        unsigned bound = c.k() + c.max_coeff();
+        unsigned sz = c.size();
+        for (unsigned j = num_watch; j < sz && slack < bound; ++j) {
+            literal lit = c[j].second;
+            if (value(lit) != l_false) {
+                slack += c[j].first;
+                watch_literal(lit, idx);
+                c.swap(j, num_watch);
+                ++num_watch;
+            }
+        }
+        if (slack >= bound) {
+            --num_watch;
+            c.swap(index, num_watch);
+            c.set_num_watch(num_watch);
+            keep = false;
+            return;
+        }
+        // all non-false literals are watched, and not_l remains watched.
+        c.set_num_watch(num_watch);
+        propagate_core(idx);
+    }
+
+    void card_extension::get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) {
+        constraint const & c = m_constraints[idx];
+        SASSERT(value(c.lit()) == l_true);
+        r.push_back(c.lit());
+        unsigned pos = l == null_literal ? UINT_MAX : trail_pos(l.var());
+        for (unsigned i = 0; i < c.size(); ++i) {
+            literal lit = c[i].second;
+            if (value(lit) == l_false && (s().lvl(lit) == 0 || trail_pos(lit.var()) < pos)) {
+                r.push_back(~lit);
+            }
+        }
+        TRACE("sat_card", tout << l << " " << idx << ": " << r << "\n";);
+    }
+
+    void card_extension::asserted(literal l) {
+        bool_var v = l.var();
+        if (v >= m_trail_pos.size()) {
+            m_trail_pos.resize(v + 1, 0);
+        }
+        m_trail_pos[v] = s().m_trail.size() - 1;
+    }
+
+    check_result card_extension::check() {
+        for (unsigned idx = 0; idx < m_constraints.size(); ++idx) {
+            constraint const & c = m_constraints[idx];
+            if (value(c.lit()) != l_true) {
+                continue;
+            }
+            unsigned sum = 0;
+            for (unsigned i = 0; i < c.size(); ++i) {
+                if (value(c[i].second) == l_true) {
+                    sum += c[i].first;
+                }
+            }
+            if (sum < c.k()) {
+                set_conflict(idx);
+                return CR_CONTINUE;
+            }
+        }
+        return CR_DONE;
+    }
+
+    void card_extension::user_push() {
+        m_constraints_lim.push_back(m_constraints.size());
+    }
+
+    void card_extension::user_pop(unsigned num_scopes) {
+        // the extension may have been attached inside a scope that is
+        // popped, in which case all constraints are removed.
+        unsigned lim = 0;
+        if (num_scopes <= m_constraints_lim.size()) {
+            unsigned new_lvl = m_constraints_lim.size() - num_scopes;
+            lim = m_constraints_lim[new_lvl];
+            m_constraints_lim.shrink(new_lvl);
+        }
+        else {
+            m_constraints_lim.reset();
+        }
+        for (unsigned idx = m_constraints.size(); idx-- > lim; ) {
+            clear_watch(idx);
+            s().get_wlist(m_constraints[idx].lit()).erase(watched(idx));
+        }
+        m_constraints.shrink(lim);
+    }
+
+    void card_extension::collect_statistics(statistics& st) const {
+        st.update("cardinality propagations", m_stats.m_num_propagations);
+        st.update("cardinality conflicts", m_stats.m_num_conflicts);
+    }
+
+    void card_extension::display(std::ostream& out) const {
+        for (unsigned idx = 0; idx < m_constraints.size(); ++idx) {
+            constraint const & c = m_constraints[idx];
+            out << idx << ": " << c.lit() << " ==> ";
+            for (unsigned i = 0; i < c.size(); ++i) {
+                if (i > 0) out << " + ";
+                if (c[i].first != 1) out << c[i].first << "*";
+                out << c[i].second;
+            }
+            out << " >= " << c.k() << "\n";
+        }
+    }
+
+};
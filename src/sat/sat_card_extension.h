@@ -0,0 +1,124 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_card_extension.h
+
+Abstract:
+
+    Native propagation of cardinality and pseudo-Boolean constraints.
+
+    A constraint is of the form
+
+        lit => sum a_i * l_i >= k
+
+    where the coefficients a_i are positive. The constraint is enforced
+    while lit is true. Cardinality constraints are the special case
+    where all coefficients are 1.
+
+Notes:
+
+    Literals are watched such that the sum of the coefficients of
+    the non-false watched literals is at least k + max a_i. When a
+    watched literal becomes false, replacements are searched among
+    the unwatched literals. If none are found, all non-false literals
+    are watched and the constraint propagates or is in conflict.
+
+    Explanations are the reification literal together with the
+    false literals that were assigned before the propagated literal.
+
+--*/
+#ifndef SAT_CARD_EXTENSION_H_
+#define SAT_CARD_EXTENSION_H_
+
+#include"sat_extension.h"
+#include"sat_solver.h"
+
+namespace sat {
+
+    class card_extension : public extension {
+    public:
+        typedef std::pair<unsigned, literal> wliteral;
+    private:
+        struct stats {
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        class constraint {
+            literal           m_lit;
+            unsigned          m_k;
+            unsigned          m_max_coeff;
+            unsigned          m_num_watch;
+            svector<wliteral> m_wlits;
+        public:
+            constraint(literal lit, svector<wliteral> const& wlits, unsigned k);
+            literal lit() const { return m_lit; }
+            unsigned k() const { return m_k; }
+            unsigned max_coeff() const { return m_max_coeff; }
+            unsigned size() const { return m_wlits.size(); }
+            wliteral const& operator[](unsigned i) const { return m_wlits[i]; }
+            unsigned num_watch() const { return m_num_watch; }
+            void set_num_watch(unsigned n) { m_num_watch = n; }
+            void swap(unsigned i, unsigned j) { std::swap(m_wlits[i], m_wlits[j]); }
+        };
+
+        solver*            m_solver;
+        vector<constraint> m_constraints;
+        unsigned_vector    m_constraints_lim;
+        unsigned_vector    m_trail_pos;
+        svector<wliteral>  m_wlits;
+        stats              m_stats;
+
+        solver& s() const { return *m_solver; }
+        lbool value(literal l) const { return s().value(l); }
+
+        void watch_literal(literal l, ext_constraint_idx idx);
+        void unwatch_literal(literal l, ext_constraint_idx idx);
+        void clear_watch(ext_constraint_idx idx);
+        void init_watch(ext_constraint_idx idx);
+        void propagate_core(ext_constraint_idx idx);
+        void set_conflict(ext_constraint_idx idx);
+        unsigned trail_pos(bool_var v) const { return v < m_trail_pos.size() ? m_trail_pos[v] : 0; }
+        void normalize(unsigned& k);
+
+    public:
+        card_extension();
+        virtual ~card_extension();
+
+        /**
+           \brief Add the constraint lit => sum of wlits >= k.
+           Literals may repeat, and coefficients may be larger than k.
+        */
+        void add_pb_ge(literal lit, svector<wliteral> const& wlits, unsigned k);
+
+        /**
+           \brief Add the constraint lit => at least k of lits are true.
+        */
+        void add_at_least(literal lit, literal_vector const& lits, unsigned k);
+
+        unsigned num_constraints() const { return m_constraints.size(); }
+
+        virtual void set_solver(solver* s) { m_solver = s; }
+        virtual void propagate(literal l, ext_constraint_idx idx, bool & keep);
+        virtual void get_antecedents(literal l, ext_justification_idx idx, literal_vector & r);
+        virtual void asserted(literal l);
+        virtual check_result check();
+        virtual void push() {}
+        virtual void pop(unsigned n) {}
+        virtual void simplify() {}
+        virtual void clauses_modifed() {}
+        virtual lbool get_phase(bool_var v) { return l_undef; }
+        virtual void user_push();
+        virtual void user_pop(unsigned num_scopes);
+        virtual void collect_statistics(statistics& st) const;
+
+        void display(std::ostream& out) const;
+    };
+
+};
+
+#endif
@@ -33,7 +33,8 @@ namespace sat {
         m_psm("psm"),
         m_glue("glue"),
         m_glue_psm("glue_psm"),
-        m_psm_glue("psm_glue") {
+        m_psm_glue("psm_glue"),
+        m_tiers("tiers") {
         updt_params(p); 
     }
 
@@ -101,16 +102,30 @@ namespace sat {
                 m_gc_strategy = GC_PSM;
             else if (s == m_psm_glue)
                 m_gc_strategy = GC_PSM_GLUE;
+            else if (s == m_tiers)
+                m_gc_strategy = GC_TIERS;
             else 
                 throw sat_param_exception("invalid gc strategy");
             m_gc_initial      = p.gc_initial();
             m_gc_increment    = p.gc_increment();
+            m_gc_tier1_glue   = p.gc_tier1_glue();
+            m_gc_tier1_max    = p.gc_tier1_max();
+            m_gc_tier2_glue   = std::max(p.gc_tier2_glue(), m_gc_tier1_glue);
         }
         m_minimize_lemmas = p.minimize_lemmas();
         m_core_minimize   = p.core_minimize();
         m_core_minimize_partial   = p.core_minimize_partial();
         m_optimize_model  = p.optimize_model();
         m_bcd             = p.bcd();
+        m_xor_solver      = p.xor_solver();
+        m_xor_max_size    = std::min(p.xor_max_size(), 16u);
+        // the solver has a single extension, the XOR constraints would
+        // take the place of the cardinality constraints.
+        if (m_xor_solver && p.cardinality_solver())
+            throw sat_param_exception("xor.solver cannot be combined with cardinality.solver");
+        m_inprocess_adaptive = p.inprocess_adaptive();
+        m_inprocess_min_effectiveness = p.inprocess_min_effectiveness();
+        m_inprocess_max_interval = std::max(1u, p.inprocess_max_interval());
         m_dyn_sub_res     = p.dyn_sub_res();
     }
 
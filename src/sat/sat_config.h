@@ -41,7 +41,8 @@ namespace sat {
         GC_PSM,
         GC_GLUE,
         GC_GLUE_PSM,
-        GC_PSM_GLUE
+        GC_PSM_GLUE,
+        GC_TIERS
     };
 
     struct config {
@@ -66,6 +67,9 @@ namespace sat {
         unsigned           m_gc_increment;
         unsigned           m_gc_small_lbd;
         unsigned           m_gc_k;
+        unsigned           m_gc_tier1_glue;
+        unsigned           m_gc_tier1_max;
+        unsigned           m_gc_tier2_glue;
 
         bool               m_minimize_lemmas;
         bool               m_dyn_sub_res;
@@ -73,6 +77,11 @@ namespace sat {
         bool               m_core_minimize_partial;
         bool               m_optimize_model;
         bool               m_bcd;
+        bool               m_xor_solver;
+        unsigned           m_xor_max_size;
+        bool               m_inprocess_adaptive;
+        double             m_inprocess_min_effectiveness;
+        unsigned           m_inprocess_max_interval;
 
 
         symbol             m_always_true;
@@ -87,6 +96,7 @@ namespace sat {
         symbol             m_glue;        
         symbol             m_glue_psm;        
         symbol             m_psm_glue;        
+        symbol             m_tiers;
         
         config(params_ref const & p);
         void updt_params(params_ref const & p);
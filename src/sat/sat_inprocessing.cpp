@@ -0,0 +1,144 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_inprocessing.cpp
+
+Abstract:
+
+    Schedule the inprocessing techniques applied by simplify_problem.
+
+Notes:
+
+--*/
+#include"sat_inprocessing.h"
+#include"sat_solver.h"
+
+namespace sat {
+
+    inprocessing::inprocessing(solver & _s):
+        s(_s) {
+    }
+
+    char const * inprocessing::name(technique t) {
+        switch (t) {
+        case SUBSUMPTION:          return "subsumption";
+        case SUBSUMPTION_LEARNED:  return "subsumption-learned";
+        case PROBING:              return "probing";
+        case ASYMM_BRANCH:         return "asymm-branch";
+        case ASYMM_BRANCH_LEARNED: return "asymm-branch-learned";
+        default:                   return "unknown";
+        }
+    }
+
+    /**
+       \brief Number of simplifications performed so far by technique t.
+       Units are counted separately, using the trail.
+    */
+    unsigned inprocessing::num_simplifications(technique t) const {
+        switch (t) {
+        case SUBSUMPTION:
+        case SUBSUMPTION_LEARNED: {
+            simplifier const & simp = s.m_simplifier;
+            return simp.m_num_elim_lits + simp.m_num_subsumed + simp.m_num_sub_res +
+                simp.m_num_blocked_clauses + simp.m_num_elim_vars;
+        }
+        case ASYMM_BRANCH:
+            return s.m_asymm_branch.m_elim_literals;
+        case ASYMM_BRANCH_LEARNED:
+            return s.m_asymm_branch.m_elim_learned_literals;
+        default:
+            return 0;
+        }
+    }
+
+    /**
+       \brief Cost consumed so far by technique t, in the units of the
+       counter it is bounded by. Costs of different techniques are not
+       comparable, each one is only compared with the simplifications of
+       the same technique.
+    */
+    unsigned inprocessing::cost(technique t) const {
+        switch (t) {
+        case SUBSUMPTION:
+        case SUBSUMPTION_LEARNED:
+            return s.m_simplifier.m_cost;
+        case PROBING:
+            return s.m_probing.m_cost;
+        case ASYMM_BRANCH:
+            return s.m_asymm_branch.m_cost;
+        case ASYMM_BRANCH_LEARNED:
+            return s.m_asymm_branch.m_learned_cost;
+        default:
+            return 0;
+        }
+    }
+
+    bool inprocessing::should_run(technique t) {
+        entry & e = m_entries[t];
+        if (!s.m_config.m_inprocess_adaptive || e.m_countdown == 0) {
+            return true;
+        }
+        --e.m_countdown;
+        ++e.m_skips;
+        return false;
+    }
+
+    void inprocessing::update(technique t, unsigned simplified, unsigned cost) {
+        entry & e = m_entries[t];
+        ++e.m_runs;
+        e.m_simplified += simplified;
+        e.m_cost       += cost;
+        if (cost == 0) {
+            // the technique did not run, for example because it waits
+            // for its delay to expire.
+            return;
+        }
+        double effectiveness = 1000.0 * simplified / static_cast<double>(cost);
+        if (effectiveness >= s.m_config.m_inprocess_min_effectiveness) {
+            e.m_interval = std::max(1u, e.m_interval / 2);
+        }
+        else {
+            e.m_interval = std::min(s.m_config.m_inprocess_max_interval, 2 * e.m_interval);
+        }
+        e.m_countdown = e.m_interval - 1;
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << " (sat-inprocess :technique " << name(t)
+                   << " :simplified " << simplified << " :cost " << cost
+                   << " :interval " << e.m_interval << ")\n";);
+    }
+
+    inprocessing::scoped_run::scoped_run(inprocessing & owner, technique t):
+        m_owner(owner),
+        m_technique(t),
+        m_num_simplifications(owner.num_simplifications(t)),
+        m_num_units(owner.s.m_trail.size()),
+        m_cost(owner.cost(t)) {
+    }
+
+    inprocessing::scoped_run::~scoped_run() {
+        solver & s = m_owner.s;
+        unsigned simplified = m_owner.num_simplifications(m_technique) - m_num_simplifications;
+        if (s.m_trail.size() > m_num_units)
+            simplified += s.m_trail.size() - m_num_units;
+        m_owner.update(m_technique, simplified, m_owner.cost(m_technique) - m_cost);
+    }
+
+    void inprocessing::collect_statistics(statistics & st) const {
+        unsigned skips = 0;
+        for (unsigned i = 0; i < NUM_TECHNIQUES; ++i) {
+            skips += m_entries[i].m_skips;
+        }
+        st.update("inprocess skips", skips);
+    }
+
+    void inprocessing::reset_statistics() {
+        for (unsigned i = 0; i < NUM_TECHNIQUES; ++i) {
+            m_entries[i].m_runs    = 0;
+            m_entries[i].m_skips   = 0;
+            m_entries[i].m_simplified = 0;
+            m_entries[i].m_cost    = 0;
+        }
+    }
+
+};
@@ -0,0 +1,90 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_inprocessing.h
+
+Abstract:
+
+    Schedule the inprocessing techniques applied by simplify_problem.
+
+    The effectiveness of a technique is the number of simplifications
+    it performs per thousand units of its own cost counter, the one
+    that bounds it by its limit parameter. The simplifications are
+    read from the statistics the techniques keep: literals removed by
+    strengthening, clauses subsumed or blocked, variables eliminated
+    and units found. A technique that is not effective is skipped in
+    an increasing number of simplifications, and one that is effective
+    again runs more often.
+
+Notes:
+
+--*/
+#ifndef SAT_INPROCESSING_H_
+#define SAT_INPROCESSING_H_
+
+#include"sat_types.h"
+#include"statistics.h"
+
+namespace sat {
+
+    class inprocessing {
+    public:
+        enum technique {
+            SUBSUMPTION,          // subsumption, blocked clauses and variable elimination
+            SUBSUMPTION_LEARNED,  // subsumption among the learned clauses
+            PROBING,
+            ASYMM_BRANCH,
+            ASYMM_BRANCH_LEARNED, // vivification of the learned clauses
+            NUM_TECHNIQUES
+        };
+    private:
+        struct entry {
+            unsigned m_interval;  // number of simplifications until the next run
+            unsigned m_countdown;
+            unsigned m_runs;
+            unsigned m_skips;
+            unsigned m_simplified;
+            uint64   m_cost;
+            entry():m_interval(1), m_countdown(0), m_runs(0), m_skips(0), m_simplified(0), m_cost(0) {}
+        };
+
+        solver & s;
+        entry    m_entries[NUM_TECHNIQUES];
+
+        unsigned num_simplifications(technique t) const;
+        unsigned cost(technique t) const;
+        void update(technique t, unsigned simplified, unsigned cost);
+        static char const * name(technique t);
+    public:
+        inprocessing(solver & s);
+
+        /**
+           \brief Return true if technique t is scheduled in the current
+           simplification.
+        */
+        bool should_run(technique t);
+
+        /**
+           \brief Measure the simplifications performed by a technique
+           and the cost it consumed.
+        */
+        class scoped_run {
+            inprocessing & m_owner;
+            technique      m_technique;
+            unsigned       m_num_simplifications;
+            unsigned       m_num_units;
+            unsigned       m_cost;
+        public:
+            scoped_run(inprocessing & owner, technique t);
+            ~scoped_run();
+        };
+
+        void collect_statistics(statistics & st) const;
+        void reset_statistics();
+    };
+
+};
+
+#endif
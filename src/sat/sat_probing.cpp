@@ -27,6 +27,7 @@ namespace sat {
         reset_statistics();
         m_stopped_at = 0;
         m_counter    = 0;
+        m_cost       = 0;
     }
 
     // reset the cache for the given literal
@@ -234,6 +235,7 @@ namespace sat {
         if (r)
             m_stopped_at = 0;
         m_counter = -m_counter;
+        m_cost   += m_counter;
         if (rpt.m_num_assigned == m_num_assigned) {
             // penalize
             m_counter *= 2;
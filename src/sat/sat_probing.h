@@ -27,6 +27,7 @@ Revision History:
 namespace sat {
 
     class probing {
+        friend class inprocessing;
         solver &        s;
         unsigned        m_stopped_at;  // where did it stop
         literal_set     m_assigned;    // literals assigned in the first branch
@@ -34,6 +35,7 @@ namespace sat {
 
         // counters
         int             m_counter;       // track cost
+        unsigned        m_cost;          // cost of all rounds, in the units of m_counter
 
         // config
         bool               m_probing;             // enabled/disabled
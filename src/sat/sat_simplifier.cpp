@@ -23,6 +23,7 @@ Revision History:
 #include"sat_solver.h"
 #include"stopwatch.h"
 #include"trace.h"
+#include"z3_omp.h"
 
 namespace sat {
 
@@ -57,7 +58,8 @@ namespace sat {
 
     simplifier::simplifier(solver & _s, params_ref const & p):
         s(_s),
-        m_num_calls(0) {
+        m_num_calls(0),
+        m_cost(0) {
         updt_params(p);
         reset_statistics();
     }
@@ -181,6 +183,9 @@ namespace sat {
                 break;
         }
         while (!m_sub_todo.empty());
+        // not updated if the problem became inconsistent, the search is over then.
+        m_cost += static_cast<unsigned>(static_cast<int64>(m_subsumption_limit) - m_sub_counter);
+        m_cost += static_cast<unsigned>(static_cast<int64>(m_res_limit) - m_elim_counter);
 
         bool vars_eliminated = m_num_elim_vars > old_num_elim_vars;
 
@@ -1050,6 +1055,7 @@ namespace sat {
         blocked_cls_report rpt(*this);
         blocked_clause_elim elim(*this, m_blocked_clause_limit, s.m_mc, m_use_list, s.m_watches);
         elim(s.num_vars());
+        m_cost += static_cast<unsigned>(static_cast<int64>(m_blocked_clause_limit) - elim.m_counter);
     }
 
     unsigned simplifier::get_num_non_learned_bin(literal l) const {
@@ -1117,7 +1123,7 @@ namespace sat {
     /**
        \brief Collect clauses and binary clauses containing l.
     */
-    void simplifier::collect_clauses(literal l, clause_wrapper_vector & r) {
+    void simplifier::collect_clauses(literal l, clause_wrapper_vector & r) const {
         clause_use_list const & cs = m_use_list.get(l);
         clause_use_list::iterator it = cs.mk_iterator();
         while (!it.at_end()) {
@@ -1126,9 +1132,9 @@ namespace sat {
             it.next();
         }
 
-        watch_list & wlist = get_wlist(~l);
-        watch_list::iterator it2  = wlist.begin();
-        watch_list::iterator end2 = wlist.end();
+        watch_list const & wlist = get_wlist(~l);
+        watch_list::const_iterator it2  = wlist.begin();
+        watch_list::const_iterator end2 = wlist.end();
         for (; it2 != end2; ++it2) {
             if (it2->is_binary_non_learned_clause()) {
                 r.push_back(clause_wrapper(l, it2->get_literal()));
@@ -1142,35 +1148,34 @@ namespace sat {
        c1 must contain l.
        c2 must contain ~l.
        Store result in r.
-       Return false if the result is a tautology
+       Return false if the result is a tautology.
+       visited is an all false array indexed by literals.
     */
-    bool simplifier::resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r) {
+    bool simplifier::resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r, svector<char> & visited) {
         CTRACE("resolve_bug", !c1.contains(l), tout << c1 << "\n" << c2 << "\nl: " << l << "\n";);
         SASSERT(c1.contains(l));
         SASSERT(c2.contains(~l));
         bool res = true;
         unsigned sz = c1.size();
-        m_elim_counter -= sz;
         for (unsigned i = 0; i < sz; i++) {
             literal l2 = c1[i];
             if (l == l2)
                 continue;
-            m_visited[l2.index()] = true;
+            visited[l2.index()] = true;
             r.push_back(l2);
         }
 
         literal not_l = ~l;
         sz = c2.size();
-        m_elim_counter -= sz;
         for (unsigned i = 0; i < sz; i++) {
             literal l2 = c2[i];
             if (not_l == l2)
                 continue;
-            if (m_visited[(~l2).index()]) {
+            if (visited[(~l2).index()]) {
                 res = false;
                 break;
             }
-            if (!m_visited[l2.index()])
+            if (!visited[l2.index()])
                 r.push_back(l2);
         }
 
@@ -1179,11 +1184,16 @@ namespace sat {
             literal l2 = c1[i];
             if (l == l2)
                 continue;
-            m_visited[l2.index()] = false;
+            visited[l2.index()] = false;
         }
         return res;
     }
 
+    bool simplifier::resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r) {
+        m_elim_counter -= c1.size() + c2.size();
+        return resolve(c1, c2, l, r, m_visited);
+    }
+
     void simplifier::save_clauses(model_converter::entry & mc_entry, clause_wrapper_vector const & cs) {
         model_converter & mc = s.m_mc;
         clause_wrapper_vector::const_iterator it  = cs.begin();
@@ -1266,32 +1276,33 @@ namespace sat {
         }
     }
 
-    bool simplifier::try_eliminate(bool_var v) {
-        TRACE("resolution_bug", tout << "processing: " << v << "\n";);
-        if (value(v) != l_undef)
-            return false;
-
+    /**
+       \brief Collect the occurrences of v and the number of literals in
+       the clauses containing v.
+    */
+    void simplifier::collect_elim_occs(bool_var v, elim_info & info) const {
         literal pos_l(v, false);
         literal neg_l(v, true);
-        unsigned num_bin_pos = get_num_non_learned_bin(pos_l);
-        unsigned num_bin_neg = get_num_non_learned_bin(neg_l);
-        clause_use_list & pos_occs = m_use_list.get(pos_l);
-        clause_use_list & neg_occs = m_use_list.get(neg_l);
-        unsigned num_pos = pos_occs.size() + num_bin_pos;
-        unsigned num_neg = neg_occs.size() + num_bin_neg;
-        m_elim_counter -= num_pos + num_neg;
-
-        TRACE("resolution", tout << v << " num_pos: " << num_pos << " neg_pos: " << num_neg << "\n";);
-
-        if (num_pos >= m_res_occ_cutoff && num_neg >= m_res_occ_cutoff)
-            return false;
+        info.m_num_bin_pos  = get_num_non_learned_bin(pos_l);
+        info.m_num_bin_neg  = get_num_non_learned_bin(neg_l);
+        clause_use_list const & pos_occs = m_use_list.get(pos_l);
+        clause_use_list const & neg_occs = m_use_list.get(neg_l);
+        info.m_num_pos      = pos_occs.size() + info.m_num_bin_pos;
+        info.m_num_neg      = neg_occs.size() + info.m_num_bin_neg;
+        info.m_before_lits  = 0;
+        info.m_resolve_cost = 0;
+        info.m_bounded      = false;
+        info.m_counted      = false;
+
+        if (info.m_num_pos >= m_res_occ_cutoff && info.m_num_neg >= m_res_occ_cutoff)
+            return;
 
-        unsigned before_lits = num_bin_pos*2 + num_bin_neg*2;
+        info.m_before_lits = info.m_num_bin_pos*2 + info.m_num_bin_neg*2;
 
         {
             clause_use_list::iterator it = pos_occs.mk_iterator();
             while (!it.at_end()) {
-                before_lits += it.curr().size();
+                info.m_before_lits += it.curr().size();
                 it.next();
             }
         }
@@ -1299,53 +1310,123 @@ namespace sat {
         {
             clause_use_list::iterator it2 = neg_occs.mk_iterator();
             while (!it2.at_end()) {
-                before_lits += it2.curr().size();
+                info.m_before_lits += it2.curr().size();
                 it2.next();
             }
         }
+    }
 
-        TRACE("resolution", tout << v << " num_pos: " << num_pos << " neg_pos: " << num_neg << " before_lits: " << before_lits << "\n";);
-
+    /**
+       \brief Return true if the occurrences in info are above the
+       resolution cutoffs for the current number of clauses.
+    */
+    bool simplifier::above_elim_cutoffs(elim_info const & info) const {
+        unsigned num_pos = info.m_num_pos;
+        unsigned num_neg = info.m_num_neg;
+        unsigned before_lits = info.m_before_lits;
+        if (num_pos >= m_res_occ_cutoff && num_neg >= m_res_occ_cutoff)
+            return true;
         if (num_pos >= m_res_occ_cutoff3 && num_neg >= m_res_occ_cutoff3 && before_lits > m_res_lit_cutoff3 && s.m_clauses.size() > m_res_cls_cutoff2)
-            return false;
+            return true;
         if (num_pos >= m_res_occ_cutoff2 && num_neg >= m_res_occ_cutoff2 && before_lits > m_res_lit_cutoff2 &&
             s.m_clauses.size() > m_res_cls_cutoff1 && s.m_clauses.size() <= m_res_cls_cutoff2)
-            return false;
+            return true;
         if (num_pos >= m_res_occ_cutoff1 && num_neg >= m_res_occ_cutoff1 && before_lits > m_res_lit_cutoff1 &&
             s.m_clauses.size() <= m_res_cls_cutoff1)
-            return false;
+            return true;
+        return false;
+    }
 
-        m_pos_cls.reset();
-        m_neg_cls.reset();
-        collect_clauses(pos_l, m_pos_cls);
-        collect_clauses(neg_l, m_neg_cls);
+    /**
+       \brief Count the resolvents of v, whose occurrences are in info.
+       The counting stops as soon as the resolvents outnumber the
+       clauses containing v. This method does not modify the
+       simplifier, and it is executed in parallel by elim_vars_par.
+    */
+    void simplifier::count_resolvents(bool_var v, elim_info & info, svector<char> & visited, clause_wrapper_vector & pos_cls,
+                                      clause_wrapper_vector & neg_cls, literal_vector & new_cls) const {
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        info.m_counted = true;
+        if (info.m_num_pos >= m_res_occ_cutoff && info.m_num_neg >= m_res_occ_cutoff)
+            return;
 
-        m_elim_counter -= num_pos * num_neg + before_lits;
+        pos_cls.reset();
+        neg_cls.reset();
+        collect_clauses(pos_l, pos_cls);
+        collect_clauses(neg_l, neg_cls);
 
         TRACE("resolution_detail", tout << "collecting number of after_clauses\n";);
-        unsigned before_clauses = num_pos + num_neg;
+        unsigned before_clauses = info.m_num_pos + info.m_num_neg;
         unsigned after_clauses  = 0;
-        clause_wrapper_vector::iterator it1  = m_pos_cls.begin();
-        clause_wrapper_vector::iterator end1 = m_pos_cls.end();
+        clause_wrapper_vector::iterator it1  = pos_cls.begin();
+        clause_wrapper_vector::iterator end1 = pos_cls.end();
         for (; it1 != end1; ++it1) {
-            clause_wrapper_vector::iterator it2  = m_neg_cls.begin();
-            clause_wrapper_vector::iterator end2 = m_neg_cls.end();
+            clause_wrapper_vector::iterator it2  = neg_cls.begin();
+            clause_wrapper_vector::iterator end2 = neg_cls.end();
             for (; it2 != end2; ++it2) {
-                m_new_cls.reset();
-                if (resolve(*it1, *it2, pos_l, m_new_cls)) {
-                    TRACE("resolution_detail", tout << *it1 << "\n" << *it2 << "\n-->\n";
-                          for (unsigned i = 0; i < m_new_cls.size(); i++) tout << m_new_cls[i] << " "; tout << "\n";);
+                new_cls.reset();
+                info.m_resolve_cost += it1->size() + it2->size();
+                if (resolve(*it1, *it2, pos_l, new_cls, visited)) {
                     after_clauses++;
                     if (after_clauses > before_clauses) {
                         TRACE("resolution", tout << "too many after clauses: " << after_clauses << "\n";);
-                        return false;
+                        return;
                     }
                 }
             }
         }
         TRACE("resolution", tout << "found var to eliminate, before: " << before_clauses << " after: " << after_clauses << "\n";);
+        info.m_bounded = true;
+    }
+
+    bool simplifier::try_eliminate(bool_var v) {
+        if (value(v) != l_undef)
+            return false;
+        elim_info info;
+        collect_elim_occs(v, info);
+        // the resolvents are only counted for variables below the cutoffs.
+        if (!above_elim_cutoffs(info))
+            count_resolvents(v, info, m_visited, m_pos_cls, m_neg_cls, m_new_cls);
+        return try_eliminate(v, info);
+    }
+
+    /**
+       \brief Eliminate v if info, collected in the current state of
+       the simplifier, shows that it is worthwhile.
+    */
+    bool simplifier::try_eliminate(bool_var v, elim_info const & info) {
+        TRACE("resolution_bug", tout << "processing: " << v << "\n";);
+        if (value(v) != l_undef)
+            return false;
+
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        clause_use_list & pos_occs = m_use_list.get(pos_l);
+        clause_use_list & neg_occs = m_use_list.get(neg_l);
+        unsigned num_pos = info.m_num_pos;
+        unsigned num_neg = info.m_num_neg;
+        unsigned before_lits = info.m_before_lits;
+        m_elim_counter -= num_pos + num_neg;
+
+        TRACE("resolution", tout << v << " num_pos: " << num_pos << " neg_pos: " << num_neg << " before_lits: " << before_lits << "\n";);
+
+        // the cutoffs are checked again, since the number of clauses
+        // may have changed after info was collected.
+        if (above_elim_cutoffs(info))
+            return false;
+
+        m_elim_counter -= num_pos * num_neg + before_lits;
+        m_elim_counter -= info.m_resolve_cost;
+
+        if (!info.m_bounded)
+            return false;
+
+        m_pos_cls.reset();
+        m_neg_cls.reset();
+        collect_clauses(pos_l, m_pos_cls);
+        collect_clauses(neg_l, m_neg_cls);
 
-        
         // eliminate variable
         model_converter::entry & mc_entry = s.m_mc.mk(model_converter::ELIM_VAR, v);
         save_clauses(mc_entry, m_pos_cls);
@@ -1360,8 +1441,8 @@ namespace sat {
 
         m_elim_counter -= num_pos * num_neg + before_lits;
 
-        it1  = m_pos_cls.begin();
-        end1 = m_pos_cls.end();
+        clause_wrapper_vector::iterator it1  = m_pos_cls.begin();
+        clause_wrapper_vector::iterator end1 = m_pos_cls.end();
         for (; it1 != end1; ++it1) {
             clause_wrapper_vector::iterator it2  = m_neg_cls.begin();
             clause_wrapper_vector::iterator end2 = m_neg_cls.end();
@@ -1427,12 +1508,155 @@ namespace sat {
         }
     };
 
+    /**
+       \brief Visit the variables that occur in clauses with v, including v.
+       If marked is 0, return false if one of them is marked.
+       Otherwise, mark them and store them in marked.
+    */
+    bool simplifier::visit_neighborhood(bool_var v, svector<char> & marks, bool_var_vector * marked) const {
+        if (marks[v])
+            return false;
+        if (marked) {
+            marks[v] = true;
+            marked->push_back(v);
+        }
+        for (unsigned i = 0; i < 2; i++) {
+            literal l(v, i == 1);
+            clause_use_list::iterator it = m_use_list.get(l).mk_iterator();
+            while (!it.at_end()) {
+                clause const & c = it.curr();
+                it.next();
+                for (unsigned j = 0; j < c.size(); j++) {
+                    bool_var w = c[j].var();
+                    if (marks[w]) {
+                        if (!marked) return false;
+                        continue;
+                    }
+                    if (marked) {
+                        marks[w] = true;
+                        marked->push_back(w);
+                    }
+                }
+            }
+            watch_list const & wlist = get_wlist(~l);
+            watch_list::const_iterator it2  = wlist.begin();
+            watch_list::const_iterator end2 = wlist.end();
+            for (; it2 != end2; ++it2) {
+                if (!it2->is_binary_non_learned_clause())
+                    continue;
+                bool_var w = it2->get_literal().var();
+                if (marks[w]) {
+                    if (!marked) return false;
+                    continue;
+                }
+                if (marked) {
+                    marks[w] = true;
+                    marked->push_back(w);
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+       \brief Variable elimination using m_res_threads threads.
+
+       The variables are processed in batches. A batch is a prefix of
+       the remaining variables whose neighborhoods are pairwise disjoint.
+       Eliminating a variable of the batch, including the subsumption
+       checks on its resolvents, only touches clauses over its own
+       neighborhood, so the occurrences of the other variables in the
+       batch do not change. Their resolvents are counted in parallel, and
+       the eliminations are applied sequentially in the original order.
+       The resolvents of a variable that is above the cutoffs for the
+       number of clauses at the start of the batch are not counted. If
+       the eliminations before it change the number of clauses so that
+       it is no longer above the cutoffs, its resolvents are counted
+       when it is eliminated.
+       A batch ends early when an elimination assigns a literal, since
+       propagation changes arbitrary clauses.
+
+       The variables are eliminated exactly as by the sequential loop in
+       elim_vars, and the model converter entries are created in the same
+       order, independently of the number of threads.
+    */
+    void simplifier::elim_vars_par(bool_var_vector const & vars) {
+        struct buffers {
+            svector<char>         m_visited;
+            clause_wrapper_vector m_pos_cls;
+            clause_wrapper_vector m_neg_cls;
+            literal_vector        m_new_cls;
+        };
+        unsigned num_threads = m_res_threads;
+        unsigned max_batch   = 256 * num_threads;
+        vector<buffers> bufs;
+        bufs.resize(num_threads);
+        for (unsigned i = 0; i < num_threads; i++) {
+            bufs[i].m_visited.resize(2*s.num_vars(), false);
+        }
+        svector<char> marks;
+        marks.resize(s.num_vars(), false);
+        bool_var_vector marked;
+        svector<elim_info> infos;
+        infos.resize(max_batch);
+
+        unsigned i = 0;
+        unsigned sz = vars.size();
+        while (i < sz) {
+            unsigned j = i;
+            while (j < sz && j - i < max_batch && visit_neighborhood(vars[j], marks, 0)) {
+                visit_neighborhood(vars[j], marks, &marked);
+                j++;
+            }
+            for (unsigned k = 0; k < marked.size(); k++) {
+                marks[marked[k]] = false;
+            }
+            marked.reset();
+            SASSERT(j > i);
+
+            unsigned start = i;
+            int n = static_cast<int>(j - start);
+            #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 16)
+            for (int k = 0; k < n; k++) {
+                buffers & b = bufs[omp_get_thread_num()];
+                collect_elim_occs(vars[start + k], infos[k]);
+                if (!above_elim_cutoffs(infos[k]))
+                    count_resolvents(vars[start + k], infos[k], b.m_visited, b.m_pos_cls, b.m_neg_cls, b.m_new_cls);
+            }
+
+            unsigned trail_sz = s.m_trail.size();
+            for (; i < j; i++) {
+                checkpoint();
+                if (m_elim_counter < 0)
+                    return;
+                elim_info & info = infos[i - start];
+                if (!info.m_counted && !above_elim_cutoffs(info))
+                    count_resolvents(vars[i], info, m_visited, m_pos_cls, m_neg_cls, m_new_cls);
+                if (try_eliminate(vars[i], info)) {
+                    m_num_elim_vars++;
+                }
+                if (s.m_trail.size() != trail_sz || s.inconsistent()) {
+                    i++;
+                    break;
+                }
+            }
+        }
+    }
+
     void simplifier::elim_vars() {
         if (!m_elim_vars) return;
         elim_var_report rpt(*this);
         bool_var_vector vars;
         order_vars_for_elim(vars);
 
+        if (m_res_threads > 1) {
+            elim_vars_par(vars);
+            m_pos_cls.finalize();
+            m_neg_cls.finalize();
+            m_new_cls.finalize();
+            return;
+        }
+
         bool_var_vector::iterator it  = vars.begin();
         bool_var_vector::iterator end = vars.end();
         for (; it != end; ++it) {
@@ -1466,6 +1690,7 @@ namespace sat {
         m_res_lit_cutoff3         = p.resolution_lit_cutoff_range3();
         m_res_cls_cutoff1         = p.resolution_cls_cutoff1();
         m_res_cls_cutoff2         = p.resolution_cls_cutoff2();
+        m_res_threads             = std::max(1u, p.resolution_threads());
         m_subsumption             = p.subsumption();
         m_subsumption_limit       = p.subsumption_limit();
         m_elim_vars               = p.elim_vars();
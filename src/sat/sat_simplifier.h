@@ -47,6 +47,7 @@ namespace sat {
     };
 
     class simplifier {
+        friend class inprocessing;
         solver &               s;
         unsigned               m_num_calls;
         use_list               m_use_list;
@@ -63,6 +64,7 @@ namespace sat {
         // counters
         int                    m_sub_counter;
         int                    m_elim_counter;
+        unsigned               m_cost;        // budget consumed by all calls, in the units of the counters
 
         // config
         bool                   m_elim_blocked_clauses;
@@ -79,6 +81,7 @@ namespace sat {
         unsigned               m_res_lit_cutoff3;
         unsigned               m_res_cls_cutoff1;
         unsigned               m_res_cls_cutoff2;
+        unsigned               m_res_threads;
 
         bool                   m_subsumption;
         unsigned               m_subsumption_limit;
@@ -152,16 +155,39 @@ namespace sat {
         unsigned get_num_non_learned_bin(literal l) const;
         unsigned get_to_elim_cost(bool_var v) const;
         void order_vars_for_elim(bool_var_vector & r);
-        void collect_clauses(literal l, clause_wrapper_vector & r);
+        void collect_clauses(literal l, clause_wrapper_vector & r) const;
         clause_wrapper_vector m_pos_cls;
         clause_wrapper_vector m_neg_cls;
         literal_vector m_new_cls;
+        static bool resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r, svector<char> & visited);
         bool resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r);
         void save_clauses(model_converter::entry & mc_entry, clause_wrapper_vector const & cs);
         void add_non_learned_binary_clause(literal l1, literal l2);
         void remove_bin_clauses(literal l);
         void remove_clauses(clause_use_list const & cs, literal l);
+
+        /**
+           \brief Occurrences of a variable and the number of its
+           resolvents, which decide whether the variable is eliminated.
+        */
+        struct elim_info {
+            unsigned m_num_bin_pos;
+            unsigned m_num_bin_neg;
+            unsigned m_num_pos;       // including binary clauses
+            unsigned m_num_neg;
+            unsigned m_before_lits;
+            unsigned m_resolve_cost;  // literals visited while counting the resolvents
+            bool     m_bounded;       // the resolvents are not more than the clauses they replace
+            bool     m_counted;       // count_resolvents was called
+        };
+        void collect_elim_occs(bool_var v, elim_info & info) const;
+        bool above_elim_cutoffs(elim_info const & info) const;
+        void count_resolvents(bool_var v, elim_info & info, svector<char> & visited, clause_wrapper_vector & pos_cls,
+                              clause_wrapper_vector & neg_cls, literal_vector & new_cls) const;
+        bool try_eliminate(bool_var v, elim_info const & info);
         bool try_eliminate(bool_var v);
+        bool visit_neighborhood(bool_var v, svector<char> & marks, bool_var_vector * marked) const;
+        void elim_vars_par(bool_var_vector const & vars);
         void elim_vars();
 
         struct blocked_cls_report;
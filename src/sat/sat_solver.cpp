@@ -21,6 +21,7 @@ Revision History:
 #include"luby.h"
 #include"trace.h"
 #include"sat_bceq.h"
+#include"sat_xor_finder.h"
 
 // define to update glue during propagation
 #define UPDATE_GLUE
@@ -40,6 +41,7 @@ namespace sat {
         m_scc(*this, p),
         m_asymm_branch(*this, p),
         m_probing(*this, p),
+        m_inprocessing(*this),
         m_mus(*this),
         m_wsls(*this),
         m_inconsistent(false),
@@ -55,6 +57,8 @@ namespace sat {
         m_next_simplify           = 0;
         m_num_checkpoints         = 0;
         m_initializing_preferred  = false;
+        if (m_ext)
+            m_ext->set_solver(this);
     }
 
     solver::~solver() {
@@ -115,6 +119,12 @@ namespace sat {
         }
     }
 
+    void solver::set_extension(extension* ext) {
+        m_ext = ext;
+        if (m_ext)
+            m_ext->set_solver(this);
+    }
+
     // -----------------------
     //
     // Variable & Clause creation
@@ -677,14 +687,18 @@ namespace sat {
                 case watched::EXT_CONSTRAINT:
                     SASSERT(m_ext);
                     m_ext->propagate(l, it->get_ext_constraint_idx(), keep);
-                    if (keep) {
-                        *it2 = *it;
-                        it2++;
-                    }
                     if (m_inconsistent) {
+                        // CONFLICT_CLEANUP retains the current watch.
+                        if (!keep) {
+                            ++it;
+                        }
                         CONFLICT_CLEANUP();
                         return false;
                     }
+                    if (keep) {
+                        *it2 = *it;
+                        it2++;
+                    }
                     break;
                 default:
                     UNREACHABLE();
@@ -725,6 +739,12 @@ namespace sat {
             init_search();
             propagate(false);
             if (inconsistent()) return l_false;
+            // XOR constraints are only detected in the first check, see sat_xor_finder.h
+            if (m_config.m_xor_solver && !m_ext) {
+                xor_finder(*this)();
+                propagate(false);
+                if (inconsistent()) return l_false;
+            }
             init_assumptions(num_lits, lits, weights, max_weight);
             propagate(false);
             if (check_inconsistent()) return l_false;
@@ -1163,11 +1183,15 @@ namespace sat {
         m_scc();
         CASSERT("sat_simplify_bug", check_invariant());
 
-        m_simplifier(false);
+        if (m_inprocessing.should_run(inprocessing::SUBSUMPTION)) {
+            inprocessing::scoped_run _r(m_inprocessing, inprocessing::SUBSUMPTION);
+            m_simplifier(false);
+        }
         CASSERT("sat_simplify_bug", check_invariant());
         CASSERT("sat_missed_prop", check_missed_propagation());
         
-        if (!m_learned.empty()) {
+        if (!m_learned.empty() && m_inprocessing.should_run(inprocessing::SUBSUMPTION_LEARNED)) {
+            inprocessing::scoped_run _r(m_inprocessing, inprocessing::SUBSUMPTION_LEARNED);
             m_simplifier(true);
             CASSERT("sat_missed_prop", check_missed_propagation());
             CASSERT("sat_simplify_bug", check_invariant());
@@ -1176,11 +1200,24 @@ namespace sat {
         sort_watch_lits();
         CASSERT("sat_simplify_bug", check_invariant());
 
-        m_probing();
+        if (m_inprocessing.should_run(inprocessing::PROBING)) {
+            inprocessing::scoped_run _r(m_inprocessing, inprocessing::PROBING);
+            m_probing();
+        }
         CASSERT("sat_missed_prop", check_missed_propagation());
         CASSERT("sat_simplify_bug", check_invariant());
 
-        m_asymm_branch();
+        if (m_inprocessing.should_run(inprocessing::ASYMM_BRANCH)) {
+            inprocessing::scoped_run _r(m_inprocessing, inprocessing::ASYMM_BRANCH);
+            m_asymm_branch();
+        }
+        CASSERT("sat_missed_prop", check_missed_propagation());
+        CASSERT("sat_simplify_bug", check_invariant());
+
+        if (!m_learned.empty() && m_inprocessing.should_run(inprocessing::ASYMM_BRANCH_LEARNED)) {
+            inprocessing::scoped_run _r(m_inprocessing, inprocessing::ASYMM_BRANCH_LEARNED);
+            m_asymm_branch.learned();
+        }
         CASSERT("sat_missed_prop", check_missed_propagation());
         CASSERT("sat_simplify_bug", check_invariant());
 
@@ -1352,6 +1389,9 @@ namespace sat {
         case GC_PSM_GLUE:
             gc_psm_glue();
             break;
+        case GC_TIERS:
+            gc_tiers();
+            break;
         case GC_DYN_PSM:
             if (m_scope_lvl != 0)
                 return;
@@ -1435,6 +1475,67 @@ namespace sat {
         gc_half("psm-glue");
     }
 
+    /**
+       \brief Split the learned clauses in three tiers by glue.
+       Clauses in the core tier are kept, up to m_gc_tier1_max of them.
+       The core clauses with the largest (glue, size) beyond this bound
+       are handled as tier 2 clauses. Clauses in tier 2 are kept if they
+       were used since the last gc, and otherwise compete with the local
+       clauses. Half of the local clauses, those with the largest
+       (glue, size), are deleted.
+    */
+    void solver::gc_tiers() {
+        TRACE("sat", tout << "gc\n";);
+        unsigned sz     = m_learned.size();
+        unsigned j      = 0;
+        for (unsigned i = 0; i < sz; i++) {
+            clause & c = *(m_learned[i]);
+            if (c.glue() <= m_config.m_gc_tier1_glue) {
+                m_learned[i] = m_learned[j];
+                m_learned[j] = &c;
+                j++;
+            }
+        }
+        if (j > m_config.m_gc_tier1_max) {
+            std::stable_sort(m_learned.begin(), m_learned.begin() + j, glue_lt());
+            j = m_config.m_gc_tier1_max;
+        }
+        unsigned num_core = j;
+        for (unsigned i = 0; i < num_core; i++) {
+            m_learned[i]->unmark_used();
+        }
+        for (unsigned i = num_core; i < sz; i++) {
+            clause & c = *(m_learned[i]);
+            if (c.glue() <= m_config.m_gc_tier2_glue && c.was_used()) {
+                m_learned[i] = m_learned[j];
+                m_learned[j] = &c;
+                j++;
+            }
+            c.unmark_used();
+        }
+        unsigned num_tier2 = j - num_core;
+        // m_learned[j:sz] contains the local clauses.
+        std::stable_sort(m_learned.begin() + j, m_learned.end(), glue_lt());
+        unsigned new_sz = j + (sz - j)/2;
+        j = new_sz;
+        for (unsigned i = new_sz; i < sz; i++) {
+            clause & c = *(m_learned[i]);
+            if (can_delete(c)) {
+                dettach_clause(c);
+                del_clause(c);
+            }
+            else {
+                m_learned[j] = &c;
+                j++;
+            }
+        }
+        new_sz = j;
+        m_stats.m_gc_clause += sz - new_sz;
+        m_learned.shrink(new_sz);
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :strategy tiers :core " << num_core
+                   << " :tier2 " << num_tier2 << " :deleted " << (sz - new_sz) << ")\n";);
+    }
+
     /**
        \brief Compute the psm of all learned clauses.
     */
@@ -2588,6 +2689,8 @@ namespace sat {
         bool_var new_v = mk_var(true, false);
         lit = literal(new_v, false);
         m_user_scope_literals.push_back(lit);
+        if (m_ext)
+            m_ext->user_push();
         TRACE("sat", tout << "user_push: " << lit << "\n";);
     }
 
@@ -2646,15 +2749,17 @@ namespace sat {
     }
 
     void solver::gc_var(bool_var v) {
-        if (v > 0) {
-            bool_var w = max_var(m_learned, v-1);
-            w = max_var(m_clauses, w);
-            w = max_var(true, w);
-            w = max_var(false, w);
-            for (unsigned i = 0; i < m_trail.size(); ++i) {
-                if (m_trail[i].var() > w) w = m_trail[i].var();
-            }
-            v = std::max(v, w + 1);
+        // v itself was removed from the solver state by the caller,
+        // so w > v iff a larger variable is still in use.
+        bool_var w = max_var(m_learned, v);
+        w = max_var(m_clauses, w);
+        w = max_var(true, w);
+        w = max_var(false, w);
+        for (unsigned i = 0; i < m_trail.size(); ++i) {
+            if (m_trail[i].var() > w) w = m_trail[i].var();
+        }
+        if (w > v) {
+            v = w + 1;
         }
         // v is an index of a variable that does not occur in solver state.
         if (v < m_level.size()) {
@@ -2680,6 +2785,8 @@ namespace sat {
 
     void solver::user_pop(unsigned num_scopes) {
         pop_to_base_level();
+        if (m_ext)
+            m_ext->user_pop(num_scopes);
         while (num_scopes > 0) {
             literal lit = m_user_scope_literals.back();
             m_user_scope_literals.pop_back();
@@ -2739,6 +2846,9 @@ namespace sat {
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
         m_probing.collect_statistics(st);
+        m_inprocessing.collect_statistics(st);
+        if (m_ext)
+            m_ext->collect_statistics(st);
     }
 
     void solver::reset_statistics() {
@@ -2747,6 +2857,7 @@ namespace sat {
         m_simplifier.reset_statistics();
         m_asymm_branch.reset_statistics();
         m_probing.reset_statistics();
+        m_inprocessing.reset_statistics();
     }
 
     // -----------------------
@@ -32,6 +32,7 @@ Revision History:
 #include"sat_asymm_branch.h"
 #include"sat_iff3_finder.h"
 #include"sat_probing.h"
+#include"sat_inprocessing.h"
 #include"sat_mus.h"
 #include"sat_sls.h"
 #include"params.h"
@@ -74,7 +75,7 @@ namespace sat {
         reslimit&               m_rlimit;
         config                  m_config;
         stats                   m_stats;
-        extension *             m_ext;
+        scoped_ptr<extension>   m_ext;
         random_gen              m_rand;
         clause_allocator        m_cls_allocator;
         cleaner                 m_cleaner;
@@ -85,6 +86,7 @@ namespace sat {
         scc                     m_scc;
         asymm_branch            m_asymm_branch;
         probing                 m_probing;
+        inprocessing            m_inprocessing;
         mus                     m_mus;           // MUS for minimal core extraction
         wsls                    m_wsls;          // SLS facility for MaxSAT use
         bool                    m_inconsistent;
@@ -139,11 +141,15 @@ namespace sat {
         friend class elim_eqs;
         friend class asymm_branch;
         friend class probing;
+        friend class inprocessing;
         friend class iff3_finder;
         friend class mus;
         friend class sls;
         friend class wsls;
         friend class bceq;
+        friend class card_extension;
+        friend class xor_finder;
+        friend class xor_extension;
         friend struct mk_stat;
     public:
         solver(params_ref const & p, reslimit& l, extension * ext);
@@ -168,6 +174,13 @@ namespace sat {
            \pre the model converter of src and this must be empty
         */
         void copy(solver const & src);
+
+        /**
+           \brief Attach an extension to the solver. The solver takes
+           ownership of ext.
+        */
+        void set_extension(extension* ext);
+        extension* get_extension() const { return m_ext.get(); }
         
         // -----------------------
         //
@@ -217,6 +230,7 @@ namespace sat {
         unsigned num_vars() const { return m_level.size(); }
         unsigned num_clauses() const;
         bool is_external(bool_var v) const { return m_external[v] != 0; }
+        void set_external(bool_var v) { m_external[v] = true; }
         bool was_eliminated(bool_var v) const { return m_eliminated[v] != 0; }
         unsigned scope_lvl() const { return m_scope_lvl; }
         lbool value(literal l) const { return static_cast<lbool>(m_assignment[l.index()]); }
@@ -282,6 +296,7 @@ namespace sat {
         lbool check(unsigned num_lits, literal const* lits, double const* weights, double max_weight);
 
         model const & get_model() const { return m_model; }
+        unsigned num_conflicts() const { return m_conflicts; }
         bool model_is_current() const { return m_model_is_current; }
         literal_vector const& get_core() const { return m_core; }
         model_converter const & get_model_converter() const { return m_mc; }
@@ -337,6 +352,7 @@ namespace sat {
         void gc_psm();
         void gc_glue_psm();
         void gc_psm_glue();
+        void gc_tiers();
         void save_psm();
         void gc_half(char const * st_name);
         void gc_dyn_psm();
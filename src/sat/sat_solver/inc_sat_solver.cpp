@@ -35,6 +35,9 @@ Notes:
 #include "ast_translation.h"
 #include "ast_util.h"
 #include "propagate_values_tactic.h"
+#include "th_rewriter.h"
+#include "for_each_expr.h"
+#include "sat_params.hpp"
 
 // incremental SAT solver.
 class inc_sat_solver : public solver {
@@ -54,6 +57,10 @@ class inc_sat_solver : public solver {
     model_ref           m_model;
     scoped_ptr<bit_blaster_rewriter> m_bb_rewriter;
     tactic_ref          m_preprocess;
+    bool                m_incremental_bb;   // parameter
+    th_rewriter         m_simp;             // simplifier used when bit-blasting incrementally
+    unsigned            m_num_preprocessed; // number of formulas sent through m_preprocess
+    unsigned            m_num_bit_blasted;  // number of formulas bit-blasted incrementally
     unsigned            m_num_scopes;
     sat::literal_vector m_asms;
     goal_ref_buffer     m_subgoals;
@@ -75,11 +82,14 @@ public:
         m_fmls_head(0),
         m_core(m),
         m_map(m),
+        m_incremental_bb(true),
+        m_simp(m),
+        m_num_preprocessed(0),
+        m_num_bit_blasted(0),
         m_num_scopes(0),
         m_dep_core(m),
         m_unknown("no reason given") {
-        m_params.set_bool("elim_vars", false);
-        m_solver.updt_params(m_params);
+        updt_params(p);
         init_preprocess();
     }
 
@@ -172,7 +182,16 @@ public:
         if (n > m_num_scopes) {   // allow inc_sat_solver to
             n = m_num_scopes;     // take over for another solver.
         }
-        if (m_bb_rewriter) m_bb_rewriter->pop(n);
+        if (m_bb_rewriter) {
+            unsigned num_consts = m_bb_rewriter->const2bits().size();
+            m_bb_rewriter->pop(n);
+            // cached bit-blasted terms may use bits of constants introduced in the popped scopes.
+            if (num_consts != m_bb_rewriter->const2bits().size())
+                m_bb_rewriter->cleanup();
+        }
+        // the cache of m_simp would otherwise keep the terms of the popped
+        // assertions alive, and grow with every scope.
+        m_simp.reset();
         m_map.pop(n);
         SASSERT(n <= m_num_scopes);
         m_solver.user_pop(n);
@@ -212,12 +231,20 @@ public:
     virtual void updt_params(params_ref const & p) {
         m_params = p;
         m_params.set_bool("elim_vars", false);
+        sat_params sp(m_params);
+        m_params.set_bool("keep_cardinality_constraints", sp.cardinality_solver());
+        m_params.set_uint("min_cardinality_size", sp.cardinality_min_size());
         m_solver.updt_params(m_params);
         m_optimize_model = m_params.get_bool("optimize_model", false);
+        m_incremental_bb = sp.incremental_bb();
+        m_simp.updt_params(mk_simp_params());
+        if (m_bb_rewriter) m_bb_rewriter->updt_params(m_params);
     }
     virtual void collect_statistics(statistics & st) const {
         if (m_preprocess) m_preprocess->collect_statistics(st);
         m_solver.collect_statistics(st);
+        st.update("sat preprocessed formulas", m_num_preprocessed);
+        st.update("sat bit-blasted formulas", m_num_bit_blasted);
     }
     virtual void get_unsat_core(ptr_vector<expr> & r) {
         r.reset();
@@ -320,13 +347,7 @@ public:
         return m_asmsf[idx];
     }
 
-    void init_preprocess() {
-        if (m_preprocess) {
-            m_preprocess->reset();
-        }
-        if (!m_bb_rewriter) {
-            m_bb_rewriter = alloc(bit_blaster_rewriter, m, m_params);
-        }
+    params_ref mk_simp_params() const {
         params_ref simp2_p = m_params;
         simp2_p.set_bool("som", true);
         simp2_p.set_bool("pull_cheap_ite", true);
@@ -336,6 +357,17 @@ public:
         simp2_p.set_bool("flat", true); // required by som
         simp2_p.set_bool("hoist_mul", false); // required by som
         simp2_p.set_bool("elim_and", true);
+        return simp2_p;
+    }
+
+    void init_preprocess() {
+        if (m_preprocess) {
+            m_preprocess->reset();
+        }
+        if (!m_bb_rewriter) {
+            m_bb_rewriter = alloc(bit_blaster_rewriter, m, m_params);
+        }
+        params_ref simp2_p = mk_simp_params();
         m_preprocess =
             and_then(mk_card2bv_tactic(m, m_params),
                      using_params(mk_simplify_tactic(m), simp2_p),
@@ -377,9 +409,13 @@ private:
             return l_undef;
         }
         g = m_subgoals[0];
+        return convert_goal(*g, dep2asm);
+    }
+
+    lbool convert_goal(goal const & g, dep2asm_t& dep2asm) {
         expr_ref_vector atoms(m);
-        TRACE("sat", g->display_with_dependencies(tout););
-        m_goal2sat(*g, m_params, m_solver, m_map, dep2asm, true);
+        TRACE("sat", g.display_with_dependencies(tout););
+        m_goal2sat(g, m_params, m_solver, m_map, dep2asm, true);
         m_goal2sat.get_interpreted_atoms(atoms);
         if (!atoms.empty()) {
             std::stringstream strm;
@@ -522,16 +558,91 @@ private:
         }
         dep2asm_t dep2asm;
         goal_ref g = alloc(goal, m, true, false); // models, maybe cores are enabled
-        for (unsigned i = m_fmls_head ; i < m_fmls.size(); ++i) {
-            g->assert_expr(m_fmls[i].get());
+        lbool res;
+        if (m_incremental_bb && is_qfbv(m_fmls_head)) {
+            res = bit_blast_formulas(*g, dep2asm);
+        }
+        else {
+            for (unsigned i = m_fmls_head ; i < m_fmls.size(); ++i) {
+                g->assert_expr(m_fmls[i].get());
+            }
+            m_num_preprocessed += m_fmls.size() - m_fmls_head;
+            res = internalize_goal(g, dep2asm);
         }
-        lbool res = internalize_goal(g, dep2asm);
         if (res != l_undef) {
             m_fmls_head = m_fmls.size();
         }
         return res;
     }
 
+    struct is_non_qfbv_proc {
+        struct found {};
+        ast_manager & m;
+        bv_util       u;
+        is_non_qfbv_proc(ast_manager & m):m(m), u(m) {}
+        void operator()(var *) { throw found(); }
+        void operator()(quantifier *) { throw found(); }
+        void operator()(app * n) {
+            if (!m.is_bool(n) && !u.is_bv(n))
+                throw found();
+            family_id fid = n->get_family_id();
+            if (fid == m.get_basic_family_id() || fid == u.get_family_id() || is_uninterp_const(n))
+                return;
+            throw found();
+        }
+    };
+
+    /**
+       \brief Return true if the formulas starting at position \c head
+       contain only Boolean and bit-vector operators and constants.
+    */
+    bool is_qfbv(unsigned head) {
+        is_non_qfbv_proc proc(m);
+        expr_fast_mark1 visited;
+        try {
+            for (unsigned i = head; i < m_fmls.size(); ++i) {
+                quick_for_each_expr(proc, visited, m_fmls[i].get());
+            }
+        }
+        catch (is_non_qfbv_proc::found) {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+       \brief Simplify and bit-blast the new formulas one by one, and convert
+       them directly, bypassing m_preprocess. The caches of m_simp and
+       m_bb_rewriter are kept between calls, so terms shared with formulas
+       asserted earlier are not processed again. The cache of m_simp is
+       flushed on pop, the one of m_bb_rewriter when popping scopes removes
+       bit-blasted constants.
+    */
+    lbool bit_blast_formulas(goal & g, dep2asm_t& dep2asm) {
+        if (!m_bb_rewriter) {
+            init_preprocess();
+        }
+        expr_ref f1(m), f2(m), f3(m);
+        proof_ref pr(m);
+        try {
+            for (unsigned i = m_fmls_head; i < m_fmls.size(); ++i) {
+                m_simp(m_fmls[i].get(), f1);
+                (*m_bb_rewriter)(f1, f2, pr);
+                m_simp(f2, f3);
+                g.assert_expr(f3);
+            }
+        }
+        catch (rewriter_exception & ex) {
+            IF_VERBOSE(0, verbose_stream() << "exception in bit-blaster " << ex.msg() << "\n";);
+            m_simp.reset();
+            m_bb_rewriter->cleanup();
+            set_reason_unknown(ex.msg());
+            return l_undef;
+        }
+        m_num_bit_blasted += m_fmls.size() - m_fmls_head;
+        return convert_goal(g, dep2asm);
+    }
+
     void extract_assumptions(unsigned sz, expr* const* asms, dep2asm_t& dep2asm) {
         m_asms.reset();
         unsigned j = 0;
@@ -0,0 +1,426 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_extension.cpp
+
+Abstract:
+
+    Propagation of XOR constraints using Gauss-Jordan elimination.
+
+Notes:
+
+--*/
+#include"sat_xor_extension.h"
+#include"bit_util.h"
+
+namespace sat {
+
+    xor_extension::xor_extension():
+        m_solver(0),
+        m_num_words(0) {
+    }
+
+    xor_extension::~xor_extension() {
+    }
+
+    void xor_extension::add_xor(bool_var_vector const& vars, bool rhs) {
+        m_xor_vars.append(vars);
+        m_xor_lim.push_back(m_xor_vars.size());
+        m_xor_rhs.push_back(rhs);
+        ++m_stats.m_num_xors;
+    }
+
+    unsigned xor_extension::trail_pos(unsigned c) const {
+        bool_var v = m_col2var[c];
+        return v < m_trail_pos.size() ? m_trail_pos[v] : 0;
+    }
+
+    /**
+       \brief Add row src to row r.
+    */
+    void xor_extension::add_row(unsigned r, unsigned src) {
+        unsigned * dst = row(r);
+        unsigned const * s = row(src);
+        for (unsigned i = 0; i < m_num_words; ++i) {
+            dst[i] ^= s[i];
+        }
+        m_rhs[r] = m_rhs[r] != m_rhs[src];
+    }
+
+    /**
+       \brief Eliminate column c from all rows except r.
+       The changed rows are added to m_todo.
+    */
+    void xor_extension::eliminate(unsigned r, unsigned c) {
+        for (unsigned r2 = 0; r2 < num_rows(); ++r2) {
+            if (r2 != r && has(r2, c)) {
+                add_row(r2, r);
+                m_todo.push_back(r2);
+            }
+        }
+    }
+
+    /**
+       \brief Return an unassigned non-basic column of r different
+       from c, or UINT_MAX if there is none.
+    */
+    unsigned xor_extension::find_unassigned(unsigned r, unsigned c) const {
+        unsigned const * bits = row(r);
+        for (unsigned i = 0; i < m_num_words; ++i) {
+            unsigned w = bits[i];
+            while (w != 0) {
+                unsigned c2 = i * 32 + ntz_core(w);
+                w &= w - 1;
+                if (c2 != c && c2 != m_basic[r] && value(c2) == l_undef) {
+                    return c2;
+                }
+            }
+        }
+        return UINT_MAX;
+    }
+
+    /**
+       \brief Return the non-basic column of r that was assigned last.
+    */
+    unsigned xor_extension::find_last_assigned(unsigned r) const {
+        unsigned const * bits = row(r);
+        unsigned result = UINT_MAX;
+        for (unsigned i = 0; i < m_num_words; ++i) {
+            unsigned w = bits[i];
+            while (w != 0) {
+                unsigned c = i * 32 + ntz_core(w);
+                w &= w - 1;
+                if (c != m_basic[r] && (result == UINT_MAX || trail_pos(c) > trail_pos(result))) {
+                    result = c;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+       \brief Return the sum of the right-hand side of r and the values
+       of its columns except c. It is the value implied for c when the
+       other columns are assigned, and true if r is violated when
+       c = UINT_MAX and all columns are assigned.
+    */
+    bool xor_extension::parity(unsigned r, unsigned c) const {
+        bool result = m_rhs[r];
+        unsigned const * bits = row(r);
+        for (unsigned i = 0; i < m_num_words; ++i) {
+            unsigned w = bits[i];
+            while (w != 0) {
+                unsigned c2 = i * 32 + ntz_core(w);
+                w &= w - 1;
+                if (c2 != c && value(c2) == l_true) {
+                    result = !result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+       \brief Record the literals of the columns of r except c,
+       which are all assigned, as an explanation.
+    */
+    unsigned xor_extension::mk_reason(unsigned r, unsigned c) {
+        unsigned idx = m_reason_start.size();
+        m_reason_start.push_back(m_reason_lits.size());
+        unsigned const * bits = row(r);
+        for (unsigned i = 0; i < m_num_words; ++i) {
+            unsigned w = bits[i];
+            while (w != 0) {
+                unsigned c2 = i * 32 + ntz_core(w);
+                w &= w - 1;
+                if (c2 != c) {
+                    SASSERT(value(c2) != l_undef);
+                    m_reason_lits.push_back(literal(m_col2var[c2], value(c2) == l_false));
+                }
+            }
+        }
+        return idx;
+    }
+
+    void xor_extension::propagate_column(unsigned r, unsigned c) {
+        if (s().inconsistent())
+            return;
+        literal l(m_col2var[c], !parity(r, c));
+        TRACE("sat_xor", tout << "propagate " << l << " by row " << r << "\n";);
+        ++m_stats.m_num_propagations;
+        s().assign(l, justification::mk_ext_justification(mk_reason(r, c)));
+    }
+
+    void xor_extension::check_row(unsigned r) {
+        if (s().inconsistent() || !parity(r, UINT_MAX))
+            return;
+        TRACE("sat_xor", tout << "conflict in row " << r << "\n";);
+        ++m_stats.m_num_conflicts;
+        s().set_conflict(justification::mk_ext_justification(mk_reason(r, UINT_MAX)));
+    }
+
+    /**
+       \brief Make column c the basic column of r. The rows watching
+       the previous basic column exclude the column c_it whose watch
+       list is traversed.
+    */
+    void xor_extension::pivot(unsigned r, unsigned c, unsigned c_it) {
+        SASSERT(has(r, c));
+        ++m_stats.m_num_pivots;
+        unsigned b = m_basic[r];
+        if (b != c_it) {
+            m_col_watch[b].erase(r);
+        }
+        m_basic[r] = c;
+        if (m_watch[r] != c) {
+            m_col_watch[c].push_back(r);
+        }
+        eliminate(r, c);
+    }
+
+    void xor_extension::set_watch(unsigned r, unsigned c, unsigned c_it) {
+        unsigned w = m_watch[r];
+        if (w == c)
+            return;
+        if (w != c_it && w != m_basic[r]) {
+            m_col_watch[w].erase(r);
+        }
+        m_watch[r] = c;
+        if (c != c_it) {
+            m_col_watch[c].push_back(r);
+        }
+    }
+
+    /**
+       \brief Restore the invariant of r after some of its columns were
+       assigned or its watched column was eliminated: the basic and
+       watched columns are unassigned, if possible. Otherwise r
+       propagates its only unassigned column or checks for a conflict.
+       This includes the case where the elimination of a pivot reduced
+       r to its basic column, which is then propagated right away at
+       the current level.
+
+       c_it is the column whose watch list is traversed, and r is kept
+       in that list if the result is true.
+    */
+    bool xor_extension::update_row(unsigned r, unsigned c_it) {
+        if (value(m_basic[r]) != l_undef) {
+            unsigned c = find_unassigned(r, UINT_MAX);
+            if (c != UINT_MAX) {
+                pivot(r, c, c_it);
+            }
+        }
+        unsigned b = m_basic[r];
+        unsigned w = m_watch[r];
+        if (w == b || !has(r, w) || value(w) != l_undef) {
+            unsigned c = find_unassigned(r, UINT_MAX);
+            if (c == UINT_MAX && (w == b || !has(r, w))) {
+                c = find_last_assigned(r);
+            }
+            if (c != UINT_MAX) {
+                set_watch(r, c, c_it);
+            }
+        }
+        w = m_watch[r];
+        if (w == b || !has(r, w) || value(w) != l_undef) {
+            // all non-basic columns are assigned, or r has no
+            // non-basic column.
+            if (value(b) == l_undef) {
+                propagate_column(r, b);
+            }
+            else {
+                check_row(r);
+            }
+        }
+        return b == c_it || m_watch[r] == c_it;
+    }
+
+    void xor_extension::init() {
+        SASSERT(m_solver && s().scope_lvl() == 0);
+        m_var2col.resize(s().num_vars(), UINT_MAX);
+        for (unsigned i = 0; i < m_xor_vars.size(); ++i) {
+            bool_var v = m_xor_vars[i];
+            if (s().value(v) == l_undef && m_var2col[v] == UINT_MAX) {
+                m_var2col[v] = m_col2var.size();
+                m_col2var.push_back(v);
+            }
+        }
+        unsigned num_cols = m_col2var.size();
+        m_num_words = (num_cols + 31) / 32;
+        unsigned num_xors = m_xor_rhs.size();
+        m_matrix.resize(num_xors * m_num_words, 0);
+        m_rhs.resize(num_xors, false);
+        m_basic.resize(num_xors, UINT_MAX);
+        m_watch.resize(num_xors, UINT_MAX);
+        for (unsigned r = 0, i = 0; r < num_xors; ++r) {
+            bool rhs = m_xor_rhs[r];
+            for (; i < m_xor_lim[r]; ++i) {
+                bool_var v = m_xor_vars[i];
+                if (s().value(v) == l_undef) {
+                    unsigned c = m_var2col[v];
+                    row(r)[c / 32] ^= (1u << (c % 32));
+                }
+                else if (s().value(v) == l_true) {
+                    rhs = !rhs;
+                }
+            }
+            m_rhs[r] = rhs;
+        }
+        m_xor_vars.finalize();
+        m_xor_lim.finalize();
+        m_xor_rhs.finalize();
+
+        // Gauss-Jordan elimination. Empty rows are removed, and rows
+        // with only one column are units.
+        for (unsigned r = 0; r < num_xors; ++r) {
+            unsigned c = 0;
+            for (unsigned i = 0; i < m_num_words && m_basic[r] == UINT_MAX; ++i) {
+                if (row(r)[i] != 0) {
+                    c = i * 32 + ntz_core(row(r)[i]);
+                    m_basic[r] = c;
+                }
+            }
+            if (m_basic[r] == UINT_MAX) {
+                if (m_rhs[r] && !s().inconsistent()) {
+                    TRACE("sat_xor", tout << "inconsistent XOR constraints\n";);
+                    s().set_conflict(justification());
+                }
+                continue;
+            }
+            for (unsigned r2 = 0; r2 < num_xors; ++r2) {
+                if (r2 != r && has(r2, c)) {
+                    add_row(r2, r);
+                }
+            }
+        }
+        unsigned j = 0;
+        for (unsigned r = 0; r < num_xors; ++r) {
+            unsigned b = m_basic[r];
+            if (b == UINT_MAX) {
+                continue;
+            }
+            unsigned w = find_unassigned(r, UINT_MAX);
+            if (w == UINT_MAX) {
+                if (!s().inconsistent()) {
+                    s().assign(literal(m_col2var[b], !m_rhs[r]), justification());
+                }
+                continue;
+            }
+            if (j != r) {
+                for (unsigned i = 0; i < m_num_words; ++i) {
+                    row(j)[i] = row(r)[i];
+                }
+                m_rhs[j] = m_rhs[r];
+                m_basic[j] = b;
+            }
+            m_watch[j] = w;
+            ++j;
+        }
+        m_matrix.shrink(j * m_num_words);
+        m_rhs.shrink(j);
+        m_basic.shrink(j);
+        m_watch.shrink(j);
+
+        m_col_watch.resize(num_cols);
+        for (unsigned r = 0; r < num_rows(); ++r) {
+            m_col_watch[m_basic[r]].push_back(r);
+            m_col_watch[m_watch[r]].push_back(r);
+        }
+        for (unsigned c = 0; c < num_cols; ++c) {
+            bool_var v = m_col2var[c];
+            s().set_external(v);
+            s().get_wlist(literal(v, false)).push_back(watched(c));
+            s().get_wlist(literal(v, true)).push_back(watched(c));
+        }
+        TRACE("sat_xor", display(tout););
+    }
+
+    void xor_extension::propagate(literal l, ext_constraint_idx idx, bool & keep) {
+        keep = true;
+        unsigned c = idx;
+        SASSERT(m_col2var[c] == l.var());
+        unsigned_vector & rows = m_col_watch[c];
+        unsigned j = 0;
+        for (unsigned i = 0; i < rows.size(); ++i) {
+            unsigned r = rows[i];
+            if (update_row(r, c)) {
+                rows[j++] = r;
+            }
+        }
+        rows.shrink(j);
+        while (!m_todo.empty()) {
+            unsigned r = m_todo.back();
+            m_todo.pop_back();
+            update_row(r, UINT_MAX);
+        }
+    }
+
+    void xor_extension::get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) {
+        unsigned end = idx + 1 < m_reason_start.size() ? m_reason_start[idx + 1] : m_reason_lits.size();
+        for (unsigned i = m_reason_start[idx]; i < end; ++i) {
+            r.push_back(m_reason_lits[i]);
+        }
+        TRACE("sat_xor", tout << l << " " << idx << ": " << r << "\n";);
+    }
+
+    void xor_extension::asserted(literal l) {
+        bool_var v = l.var();
+        if (v >= m_trail_pos.size()) {
+            m_trail_pos.resize(v + 1, 0);
+        }
+        m_trail_pos[v] = s().m_trail.size() - 1;
+    }
+
+    check_result xor_extension::check() {
+        // rows are propagated by update_row, this is a safety net.
+        for (unsigned r = 0; r < num_rows(); ++r) {
+            if (find_unassigned(r, UINT_MAX) != UINT_MAX)
+                continue;
+            if (value(m_basic[r]) == l_undef) {
+                propagate_column(r, m_basic[r]);
+                return CR_CONTINUE;
+            }
+            if (parity(r, UINT_MAX)) {
+                check_row(r);
+                return CR_CONTINUE;
+            }
+        }
+        return CR_DONE;
+    }
+
+    void xor_extension::push() {
+        m_reason_lim.push_back(m_reason_start.size());
+    }
+
+    void xor_extension::pop(unsigned n) {
+        unsigned new_lvl = m_reason_lim.size() - n;
+        unsigned lim = m_reason_lim[new_lvl];
+        m_reason_lim.shrink(new_lvl);
+        if (lim < m_reason_start.size()) {
+            m_reason_lits.shrink(m_reason_start[lim]);
+            m_reason_start.shrink(lim);
+        }
+    }
+
+    void xor_extension::collect_statistics(statistics& st) const {
+        st.update("xor constraints", m_stats.m_num_xors);
+        st.update("xor propagations", m_stats.m_num_propagations);
+        st.update("xor conflicts", m_stats.m_num_conflicts);
+        st.update("xor pivots", m_stats.m_num_pivots);
+    }
+
+    void xor_extension::display(std::ostream& out) const {
+        for (unsigned r = 0; r < num_rows(); ++r) {
+            out << r << ": ";
+            for (unsigned c = 0; c < m_col2var.size(); ++c) {
+                if (has(r, c)) {
+                    out << (c == m_basic[r] ? "*" : "") << m_col2var[c] << " ";
+                }
+            }
+            out << "= " << (m_rhs[r] ? 1 : 0) << "\n";
+        }
+    }
+
+};
@@ -0,0 +1,130 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_extension.h
+
+Abstract:
+
+    Propagation of XOR constraints using Gauss-Jordan elimination.
+
+    The constraints form a matrix over GF(2) whose columns are the
+    variables of the constraints. The rows are stored as bit-vectors
+    and kept in reduced row echelon form: every row has a basic
+    column that occurs in no other row.
+
+Notes:
+
+    Each row watches its basic column and one non-basic column.
+    When a watched non-basic column is assigned, the row watches
+    another unassigned non-basic column, or propagates its basic
+    column if there is none. When the basic column is assigned,
+    the row pivots on an unassigned non-basic column, which is
+    eliminated from the other rows. The matrix is not restored on
+    backtracking, since all pivots yield equivalent systems.
+
+    Explanations are recorded when a row propagates, because the
+    row may change afterwards. They are removed on backtracking.
+
+    The constraints are added at the base level and are not
+    removed by user scopes.
+
+--*/
+#ifndef SAT_XOR_EXTENSION_H_
+#define SAT_XOR_EXTENSION_H_
+
+#include"sat_extension.h"
+#include"sat_solver.h"
+
+namespace sat {
+
+    class xor_extension : public extension {
+        struct stats {
+            unsigned m_num_xors;
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            unsigned m_num_pivots;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        solver*                 m_solver;
+        bool_var_vector         m_xor_vars;       // constraints added before init
+        unsigned_vector         m_xor_lim;
+        svector<bool>           m_xor_rhs;
+
+        bool_var_vector         m_col2var;
+        unsigned_vector         m_var2col;
+        unsigned                m_num_words;      // words per row
+        unsigned_vector         m_matrix;
+        svector<bool>           m_rhs;
+        unsigned_vector         m_basic;          // basic column of a row
+        unsigned_vector         m_watch;          // watched non-basic column of a row
+        vector<unsigned_vector> m_col_watch;      // rows watching a column
+        unsigned_vector         m_todo;           // rows changed by a pivot
+
+        literal_vector          m_reason_lits;
+        unsigned_vector         m_reason_start;
+        unsigned_vector         m_reason_lim;
+        unsigned_vector         m_trail_pos;
+        stats                   m_stats;
+
+        solver& s() const { return *m_solver; }
+        unsigned num_rows() const { return m_basic.size(); }
+        unsigned * row(unsigned r) { return m_matrix.c_ptr() + r * m_num_words; }
+        unsigned const * row(unsigned r) const { return m_matrix.c_ptr() + r * m_num_words; }
+        bool has(unsigned r, unsigned c) const { return (row(r)[c / 32] & (1u << (c % 32))) != 0; }
+        lbool value(unsigned c) const { return s().value(m_col2var[c]); }
+        unsigned trail_pos(unsigned c) const;
+
+        void add_row(unsigned r, unsigned src);
+        void eliminate(unsigned r, unsigned c);
+        unsigned find_unassigned(unsigned r, unsigned c) const;
+        unsigned find_last_assigned(unsigned r) const;
+        bool parity(unsigned r, unsigned c) const;
+        unsigned mk_reason(unsigned r, unsigned c);
+        void propagate_column(unsigned r, unsigned c);
+        void check_row(unsigned r);
+        void pivot(unsigned r, unsigned c, unsigned c_it);
+        void set_watch(unsigned r, unsigned c, unsigned c_it);
+        bool update_row(unsigned r, unsigned c_it);
+
+    public:
+        xor_extension();
+        virtual ~xor_extension();
+
+        /**
+           \brief Add the constraint vars[0] xor ... xor vars[n-1] = rhs.
+           Constraints are added before init is called.
+        */
+        void add_xor(bool_var_vector const& vars, bool rhs);
+        unsigned num_xors() const { return m_stats.m_num_xors; }
+
+        /**
+           \brief Build the matrix and reduce it at the base level.
+           Implied units are assigned, and a conflict is set if the
+           constraints are inconsistent.
+        */
+        void init();
+
+        virtual void set_solver(solver* s) { m_solver = s; }
+        virtual void propagate(literal l, ext_constraint_idx idx, bool & keep);
+        virtual void get_antecedents(literal l, ext_justification_idx idx, literal_vector & r);
+        virtual void asserted(literal l);
+        virtual check_result check();
+        virtual void push();
+        virtual void pop(unsigned n);
+        virtual void simplify() {}
+        virtual void clauses_modifed() {}
+        virtual lbool get_phase(bool_var v) { return l_undef; }
+        virtual void user_push() {}
+        virtual void user_pop(unsigned num_scopes) {}
+        virtual void collect_statistics(statistics& st) const;
+
+        void display(std::ostream& out) const;
+    };
+
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_finder.cpp
+
+Abstract:
+
+    Find XOR constraints among the clauses.
+
+Notes:
+
+--*/
+#include"sat_xor_finder.h"
+#include"sat_xor_extension.h"
+#include"sat_solver.h"
+
+namespace sat {
+
+    xor_finder::xor_finder(solver & _s):
+        s(_s) {
+    }
+
+    struct lit_var_lt {
+        bool operator()(literal l1, literal l2) const { return l1.var() < l2.var(); }
+    };
+
+    /**
+       \brief Order candidates by size, variables and signs, such that
+       the clauses over the same variables are consecutive.
+    */
+    struct xor_finder::candidate_lt {
+        xor_finder const & f;
+        candidate_lt(xor_finder const & f):f(f) {}
+        bool operator()(unsigned i, unsigned j) const {
+            if (f.m_size[i] != f.m_size[j])
+                return f.m_size[i] < f.m_size[j];
+            bool_var const * v1 = f.m_vars.c_ptr() + f.m_start[i];
+            bool_var const * v2 = f.m_vars.c_ptr() + f.m_start[j];
+            for (unsigned k = 0; k < f.m_size[i]; ++k) {
+                if (v1[k] != v2[k])
+                    return v1[k] < v2[k];
+            }
+            return f.m_signs[i] < f.m_signs[j];
+        }
+    };
+
+    bool xor_finder::same_vars(unsigned i, unsigned j) const {
+        if (m_size[i] != m_size[j])
+            return false;
+        for (unsigned k = 0; k < m_size[i]; ++k) {
+            if (m_vars[m_start[i] + k] != m_vars[m_start[j] + k])
+                return false;
+        }
+        return true;
+    }
+
+    void xor_finder::collect_candidates() {
+        literal_vector lits;
+        unsigned max_size = s.m_config.m_xor_max_size;
+        clause_vector::const_iterator it  = s.m_clauses.begin();
+        clause_vector::const_iterator end = s.m_clauses.end();
+        for (; it != end; ++it) {
+            clause const & c = *(*it);
+            unsigned sz = c.size();
+            if (sz < 3 || sz > max_size)
+                continue;
+            lits.reset();
+            bool assigned = false;
+            for (unsigned i = 0; i < sz && !assigned; ++i) {
+                assigned = s.value(c[i]) != l_undef;
+                lits.push_back(c[i]);
+            }
+            if (assigned)
+                continue;
+            std::sort(lits.begin(), lits.end(), lit_var_lt());
+            unsigned signs = 0;
+            m_candidates.push_back(m_start.size());
+            m_start.push_back(m_vars.size());
+            m_size.push_back(sz);
+            for (unsigned i = 0; i < sz; ++i) {
+                m_vars.push_back(lits[i].var());
+                if (lits[i].sign())
+                    signs |= (1u << i);
+            }
+            m_signs.push_back(signs);
+        }
+    }
+
+    void xor_finder::operator()() {
+        SASSERT(s.scope_lvl() == 0);
+        SASSERT(!s.get_extension());
+        if (s.m_config.m_xor_max_size < 3)
+            return;
+        collect_candidates();
+        std::sort(m_candidates.begin(), m_candidates.end(), candidate_lt(*this));
+        xor_extension * ext = 0;
+        bool_var_vector vars;
+        unsigned num_cands = m_candidates.size();
+        for (unsigned i = 0; i < num_cands; ) {
+            unsigned first = m_candidates[i];
+            unsigned sz    = m_size[first];
+            // count the distinct sign patterns of even and odd parity.
+            unsigned num_even = 0, num_odd = 0;
+            unsigned j = i;
+            for (; j < num_cands && same_vars(first, m_candidates[j]); ++j) {
+                unsigned signs = m_signs[m_candidates[j]];
+                if (j > i && signs == m_signs[m_candidates[j-1]])
+                    continue;
+                if (get_num_1bits(signs) % 2 == 0)
+                    ++num_even;
+                else
+                    ++num_odd;
+            }
+            i = j;
+            unsigned num_needed = 1u << (sz - 1);
+            if (num_even < num_needed && num_odd < num_needed)
+                continue;
+            if (!ext)
+                ext = alloc(xor_extension);
+            vars.reset();
+            vars.append(sz, m_vars.c_ptr() + m_start[first]);
+            if (num_even == num_needed)
+                ext->add_xor(vars, true);
+            if (num_odd == num_needed)
+                ext->add_xor(vars, false);
+        }
+        if (!ext)
+            return;
+        IF_VERBOSE(2, verbose_stream() << "(sat.xor-finder :num-xors " << ext->num_xors() << ")\n";);
+        s.set_extension(ext);
+        ext->init();
+    }
+
+};
@@ -0,0 +1,66 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_finder.h
+
+Abstract:
+
+    Find constraints of the form  x_1 xor ... xor x_n = rhs
+    among the clauses. An XOR constraint over n variables is
+    encoded by the 2^(n-1) clauses over the same variables that
+    exclude the assignments of the wrong parity. That is, the
+    clauses whose number of negative literals is even (rhs = 1) or
+    odd (rhs = 0).
+
+    The constraints found are passed to an xor_extension that is
+    attached to the solver.
+
+Notes:
+
+    The solver runs the finder once, in the first call to check,
+    over the problem clauses at that point. Clauses added by later
+    calls are not searched for XOR constraints and are only handled
+    by the clausal propagation. Since the rows of the extension are
+    never removed, this also keeps constraints found among clauses
+    of a user scope from outliving the scope.
+
+    Only the problem clauses are considered, and XOR constraints
+    that are split into shorter constraints with auxiliary
+    variables are found as several constraints. Gauss-Jordan
+    elimination in the extension removes the auxiliary variables.
+
+--*/
+#ifndef SAT_XOR_FINDER_H_
+#define SAT_XOR_FINDER_H_
+
+#include"sat_types.h"
+
+namespace sat {
+
+    class xor_finder {
+        solver &        s;
+        bool_var_vector m_vars;    // variables of candidate clauses, sorted per clause
+        unsigned_vector m_start;   // start of a candidate in m_vars
+        unsigned_vector m_size;
+        unsigned_vector m_signs;   // bit i is set if the i-th literal is negative
+        unsigned_vector m_candidates;
+
+        struct candidate_lt;
+        bool same_vars(unsigned i, unsigned j) const;
+        void collect_candidates();
+    public:
+        xor_finder(solver & s);
+
+        /**
+           \brief Attach an xor_extension to the solver if XOR constraints
+           are found. The solver must be at the base level and must not
+           have an extension.
+        */
+        void operator()();
+    };
+
+};
+
+#endif
@@ -27,6 +27,9 @@ Notes:
 
 --*/
 #include"goal2sat.h"
+#include"sat_card_extension.h"
+#include"sat_params.hpp"
+#include"pb_decl_plugin.h"
 #include"ast_smt2_pp.h"
 #include"ref_util.h"
 #include"cooperate.h"
@@ -39,6 +42,7 @@ Notes:
 #include<sstream>
 
 struct goal2sat::imp {
+    typedef sat::card_extension::wliteral wliteral;
     struct frame {
         app *    m_t;
         unsigned m_root:1;
@@ -61,6 +65,11 @@ struct goal2sat::imp {
     expr_ref_vector             m_trail;
     expr_ref_vector             m_interpreted_atoms;
     bool                        m_default_external;
+    pb_util                     pb;
+    sat::card_extension *       m_ext;
+    bool                        m_cardinality_solver;
+    svector<wliteral>           m_wlits;
+    svector<wliteral>           m_neg_wlits;
     
     imp(ast_manager & _m, params_ref const & p, sat::solver & s, atom2bool_var & map, dep2asm_map& dep2asm, bool default_external):
         m(_m),
@@ -69,7 +78,9 @@ struct goal2sat::imp {
         m_dep2asm(dep2asm),
         m_trail(m),
         m_interpreted_atoms(m),
-        m_default_external(default_external) {
+        m_default_external(default_external),
+        pb(m),
+        m_ext(0) {
         updt_params(p);
         m_true = sat::null_bool_var;
     }
@@ -77,6 +88,7 @@ struct goal2sat::imp {
     void updt_params(params_ref const & p) {
         m_ite_extra       = p.get_bool("ite_extra", true);
         m_max_memory      = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
+        m_cardinality_solver = sat_params(p).cardinality_solver();
     }
 
     void throw_op_not_handled(std::string const& s) {
@@ -167,6 +179,10 @@ struct goal2sat::imp {
         }
         if (process_cached(to_app(t), root, sign))
             return true;
+        if (is_native_pb(to_app(t))) {
+            m_frame_stack.push_back(frame(to_app(t), root, sign, 0));
+            return false;
+        }
         if (to_app(t)->get_family_id() != m.get_basic_family_id()) {
             convert_atom(t, root, sign);
             return true;
@@ -310,7 +326,113 @@ struct goal2sat::imp {
         }
     }
 
+    bool is_native_pb(app * t) const {
+        return
+            m_cardinality_solver &&
+            t->get_family_id() == pb.get_family_id() &&
+            t->get_decl_kind() != OP_PB_AUX_BOOL &&
+            pb.has_unsigned_coefficients(t->get_decl());
+    }
+
+    void ensure_extension() {
+        if (m_ext)
+            return;
+        sat::extension * ext = m_solver.get_extension();
+        if (ext) {
+            m_ext = dynamic_cast<sat::card_extension*>(ext);
+            if (!m_ext)
+                throw tactic_exception("cardinality constraints are not supported by the SAT solver extension");
+        }
+        else {
+            m_ext = alloc(sat::card_extension);
+            m_solver.set_extension(m_ext);
+        }
+    }
+
+    /**
+       \brief Add the constraint l => sum of m_wlits >= k, where the
+       literals of m_wlits are negated if negate is true, and sum is
+       the sum of the coefficients.
+    */
+    void add_pb_ge(sat::literal l, bool negate, rational const & sum, rational const & k) {
+        if (!k.is_pos())
+            return;
+        if (k > sum) {
+            mk_clause(~l);
+            return;
+        }
+        if (negate) {
+            m_neg_wlits.reset();
+            for (unsigned i = 0; i < m_wlits.size(); ++i) {
+                m_neg_wlits.push_back(wliteral(m_wlits[i].first, ~m_wlits[i].second));
+            }
+            m_ext->add_pb_ge(l, m_neg_wlits, k.get_unsigned());
+        }
+        else {
+            m_ext->add_pb_ge(l, m_wlits, k.get_unsigned());
+        }
+    }
+
+    void convert_pb(app * t, bool root, bool sign) {
+        TRACE("goal2sat", tout << "convert_pb " << root << " " << sign << "\n" << mk_ismt2_pp(t, m) << "\n";);
+        ensure_extension();
+        unsigned num = t->get_num_args();
+        unsigned sz  = m_result_stack.size();
+        SASSERT(num <= sz);
+        rational sum(0), k = pb.get_k(t);
+        m_wlits.reset();
+        for (unsigned i = 0; i < num; ++i) {
+            rational c = pb.get_coeff(t, i);
+            sum += c;
+            m_wlits.push_back(wliteral(c.get_unsigned(), m_result_stack[sz - num + i]));
+        }
+        m_result_stack.shrink(sz - num);
+        sat::literal l(m_solver.mk_var(), false);
+        // l => C is required if the constraint C occurs positively,
+        // and ~l => ~C if it occurs negatively.
+        bool pos = !root || !sign;
+        bool neg = !root || sign;
+        switch (t->get_decl_kind()) {
+        case OP_AT_LEAST_K:
+        case OP_PB_GE:
+            if (pos) add_pb_ge(l, false, sum, k);
+            if (neg) add_pb_ge(~l, true, sum, sum - k + rational::one());
+            break;
+        case OP_AT_MOST_K:
+        case OP_PB_LE:
+            if (pos) add_pb_ge(l, true, sum, sum - k);
+            if (neg) add_pb_ge(~l, false, sum, k + rational::one());
+            break;
+        case OP_PB_EQ:
+            if (pos) {
+                add_pb_ge(l, false, sum, k);
+                add_pb_ge(l, true, sum, sum - k);
+            }
+            if (neg) {
+                sat::literal l1(m_solver.mk_var(), false);
+                sat::literal l2(m_solver.mk_var(), false);
+                add_pb_ge(l1, false, sum, k + rational::one());
+                add_pb_ge(l2, true, sum, sum - k + rational::one());
+                mk_clause(l, l1, l2);
+            }
+            break;
+        default:
+            UNREACHABLE();
+        }
+        if (root) {
+            mk_clause(sign ? ~l : l);
+        }
+        else {
+            m_cache.insert(t, l);
+            m_result_stack.push_back(sign ? ~l : l);
+        }
+    }
+
     void convert(app * t, bool root, bool sign) {
+        if (t->get_family_id() == pb.get_family_id()) {
+            convert_pb(t, root, sign);
+            return;
+        }
         SASSERT(t->get_family_id() == m.get_basic_family_id());
         switch (to_app(t)->get_decl_kind()) {
         case OP_OR:
@@ -693,6 +815,8 @@ struct sat2goal::imp {
     }
 
     void operator()(sat::solver const & s, atom2bool_var const & map, goal & r, model_converter_ref & mc) {
+        if (dynamic_cast<sat::card_extension const*>(s.get_extension()))
+            throw tactic_exception("cannot convert cardinality constraints handled by the SAT solver into a goal");
         if (s.inconsistent()) {
             r.assert_expr(m.mk_false());
             return;
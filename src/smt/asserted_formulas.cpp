@@ -55,7 +55,11 @@ asserted_formulas::asserted_formulas(ast_manager & m, smt_params & p):
     m_macro_manager(m, m_simplifier),
     m_bit2int(m),
     m_bv_sharing(m),
-    m_inconsistent(false){
+    m_inconsistent(false),
+    m_value_lhs(m),
+    m_value_rhs(m),
+    m_value_prs(m),
+    m_value_qhead(0) {
 
     m_bsimp = 0;
     m_bvsimp = 0;
@@ -192,6 +196,8 @@ void asserted_formulas::push_scope() {
     s.m_asserted_formulas_lim    = m_asserted_formulas.size();
     SASSERT(inconsistent() || s.m_asserted_formulas_lim == m_asserted_qhead);
     s.m_inconsistent_old         = m_inconsistent;
+    s.m_value_eqs_lim            = m_value_lhs.size();
+    s.m_value_qhead_old          = m_value_qhead;
     m_defined_names.push();
     m_bv_sharing.push_scope();
     commit();
@@ -209,6 +215,10 @@ void asserted_formulas::pop_scope(unsigned num_scopes) {
     if (m_manager.proofs_enabled())
         m_asserted_formula_prs.shrink(s.m_asserted_formulas_lim);
     m_asserted_qhead    = s.m_asserted_formulas_lim;
+    m_value_lhs.shrink(s.m_value_eqs_lim);
+    m_value_rhs.shrink(s.m_value_eqs_lim);
+    m_value_prs.shrink(s.m_value_eqs_lim);
+    m_value_qhead       = s.m_value_qhead_old;
     m_scopes.shrink(new_lvl);
     flush_cache();
     TRACE("asserted_formulas_scopes", tout << "after pop " << num_scopes << "\n"; display(tout););
@@ -222,6 +232,10 @@ void asserted_formulas::reset() {
     m_macro_manager.reset();
     m_bv_sharing.reset();
     m_inconsistent = false;
+    m_value_lhs.reset();
+    m_value_rhs.reset();
+    m_value_prs.reset();
+    m_value_qhead = 0;
 }
 
 
@@ -245,6 +259,8 @@ void asserted_formulas::reduce() {
     if (!m_params.m_preprocess)
         return;
 
+    m_stats.m_num_reduce++;
+    m_stats.m_num_reduced_formulas += m_asserted_formulas.size() - m_asserted_qhead;
     if (m_macro_manager.has_macros())
         expand_macros();
     TRACE("before_reduce", display(tout););
@@ -340,6 +356,9 @@ void asserted_formulas::display_ll(std::ostream & out, ast_mark & pp_visited) co
 }
 
 void asserted_formulas::collect_statistics(statistics & st) const {
+    st.update("preprocess rounds", m_stats.m_num_reduce);
+    st.update("preprocess formulas", m_stats.m_num_reduced_formulas);
+    st.update("preprocess value eqs reused", m_stats.m_num_value_eqs_reused);
 }
 
 void asserted_formulas::reduce_asserted_formulas() {
@@ -588,11 +607,46 @@ void asserted_formulas::eliminate_term_ite() {
     TRACE("after_elim_term_ite", display(tout););
 }
 
+/**
+   \brief Collect the value equations of the formulas committed since the last call.
+   Committed formulas are not modified by the preprocessor, so each of them
+   is scanned only once (per scope).
+*/
+void asserted_formulas::collect_value_eqs() {
+    for (; m_value_qhead < m_asserted_qhead; m_value_qhead++) {
+        expr * n   = m_asserted_formulas.get(m_value_qhead);
+        proof * pr = m_asserted_formula_prs.get(m_value_qhead, 0);
+        expr* lhs, *rhs;
+        if (m_manager.is_eq(n, lhs, rhs) &&
+            (m_manager.is_value(lhs) || m_manager.is_value(rhs))) {
+            if (m_manager.is_value(lhs)) {
+                std::swap(lhs, rhs);
+                pr = m_manager.mk_symmetry(pr);
+            }
+            if (!m_manager.is_value(lhs)) {
+                m_value_lhs.push_back(lhs);
+                m_value_rhs.push_back(rhs);
+                if (m_manager.proofs_enabled())
+                    m_value_prs.push_back(pr);
+            }
+        }
+    }
+}
+
 void asserted_formulas::propagate_values() {
     IF_IVERBOSE(10, verbose_stream() << "(smt.constant-propagation)\n";);
     TRACE("propagate_values", tout << "before:\n"; display(tout););
     flush_cache();
     bool found = false;
+    collect_value_eqs();
+    for (unsigned i = 0; i < m_value_lhs.size(); i++) {
+        expr * lhs = m_value_lhs.get(i);
+        if (!m_simplifier.is_cached(lhs)) {
+            m_simplifier.cache_result(lhs, m_value_rhs.get(i), m_value_prs.get(i, 0));
+            m_stats.m_num_value_eqs_reused++;
+            found = true;
+        }
+    }
     // Separate the formulas in two sets: C and R
     // C is a set which contains formulas of the form
     // { x = n }, where x is a variable and n a numeral.
@@ -607,7 +661,7 @@ void asserted_formulas::propagate_values() {
     expr_ref_vector  new_exprs2(m_manager);
     proof_ref_vector new_prs2(m_manager);
     unsigned sz = m_asserted_formulas.size();
-    for (unsigned i = 0; i < sz; i++) {
+    for (unsigned i = m_asserted_qhead; i < sz; i++) {
         expr_ref   n(m_asserted_formulas.get(i), m_manager);
         proof_ref pr(m_asserted_formula_prs.get(i, 0), m_manager);
         TRACE("simplifier", tout << mk_pp(n, m_manager) << "\n";);
@@ -620,11 +674,9 @@ void asserted_formulas::propagate_values() {
                 pr = m_manager.mk_symmetry(pr);
             }
             if (!m_manager.is_value(lhs) && !m_simplifier.is_cached(lhs)) {
-                if (i >= m_asserted_qhead) {
-                    new_exprs1.push_back(n);
-                    if (m_manager.proofs_enabled())
-                        new_prs1.push_back(pr);
-                }
+                new_exprs1.push_back(n);
+                if (m_manager.proofs_enabled())
+                    new_prs1.push_back(pr);
                 TRACE("propagate_values", tout << "found:\n" << mk_pp(lhs, m_manager) << "\n->\n" << mk_pp(rhs, m_manager) << "\n";
                       if (pr) tout << "proof: " << mk_pp(pr, m_manager) << "\n";);
                 m_simplifier.cache_result(lhs, rhs, pr);
@@ -632,11 +684,9 @@ void asserted_formulas::propagate_values() {
                 continue;
             }
         }
-        if (i >= m_asserted_qhead) {
-            new_exprs2.push_back(n);
-            if (m_manager.proofs_enabled())
-                new_prs2.push_back(pr);
-        }
+        new_exprs2.push_back(n);
+        if (m_manager.proofs_enabled())
+            new_prs2.push_back(pr);
     }
     TRACE("propagate_values", tout << "found: " << found << "\n";);
     // If C is not empty, then reduce R using the updated simplifier cache with entries
@@ -56,8 +56,26 @@ class asserted_formulas {
 
     bool                        m_inconsistent;
 
+    // equations (= x n) where n is a value, found in the committed formulas.
+    // They are collected once, and reused by propagate_values on the new formulas.
+    expr_ref_vector             m_value_lhs;
+    expr_ref_vector             m_value_rhs;
+    proof_ref_vector            m_value_prs;
+    unsigned                    m_value_qhead; // committed formulas before m_value_qhead were scanned for value equations
+
+    struct stats {
+        unsigned m_num_reduce;
+        unsigned m_num_reduced_formulas;
+        unsigned m_num_value_eqs_reused;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+    stats                       m_stats;
+
     struct scope {
         unsigned                m_asserted_formulas_lim;
+        unsigned                m_value_eqs_lim;
+        unsigned                m_value_qhead_old;
         bool                    m_inconsistent_old;
     };
     svector<scope>              m_scopes;
@@ -76,6 +94,7 @@ class asserted_formulas {
     void flush_cache() { m_pre_simplifier.reset(); m_simplifier.reset(); }
     void set_eliminate_and(bool flag);
     void propagate_values();
+    void collect_value_eqs();
     void propagate_booleans();
     bool pull_cheap_ite_trees();
     bool pull_nested_quantifiers();
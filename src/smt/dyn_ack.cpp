@@ -103,10 +103,32 @@ namespace smt {
 
     };
 
+    unsigned dyn_ack_sketch::inc(unsigned h) {
+        if (m_counters.empty())
+            m_counters.resize(c_num_rows << c_log_width, 0);
+        unsigned est = UINT_MAX;
+        for (unsigned r = 0; r < c_num_rows; r++)
+            est = std::min(est, m_counters[idx(r, h)]);
+        est++;
+        // conservative update: only counters below the new estimate are increased.
+        for (unsigned r = 0; r < c_num_rows; r++) {
+            unsigned & c = m_counters[idx(r, h)];
+            if (c < est)
+                c = est;
+        }
+        return est;
+    }
+
+    void dyn_ack_sketch::decay(double f) {
+        for (unsigned i = 0; i < m_counters.size(); i++)
+            m_counters[i] = static_cast<unsigned>(m_counters[i] * f);
+    }
+
     dyn_ack_manager::dyn_ack_manager(context & ctx, dyn_ack_params & p):
         m_context(ctx),
         m_manager(ctx.get_manager()),
-        m_params(p) {
+        m_params(p),
+        m_stamp(0) {
     }
 
     dyn_ack_manager::~dyn_ack_manager() {
@@ -133,11 +155,34 @@ namespace smt {
         m_qhead = 0;
         m_num_instances = 0;
         m_num_propagations_since_last_gc = 0;
+        m_sketch.reset();
+        m_stamp = 0;
+        m_evict_lim = 0;
 
         m_triple.m_app2num_occs.reset();
         reset_app_triples();
         m_triple.m_to_instantiate.reset();
         m_triple.m_qhead = 0;
+        m_triple.m_sketch.reset();
+        m_triple.m_evict_lim = 0;
+    }
+
+    /**
+       \brief Candidates are first counted in the sketch \c s, and only
+       tracked exactly (and referenced) once they occur a second time.
+       Return true if the candidate with hash \c h should be tracked,
+       and store its estimated number of occurrences in \c num_occs.
+    */
+    bool dyn_ack_manager::promote(dyn_ack_sketch & s, unsigned h, unsigned & num_occs) {
+        if (m_params.m_dack_max_tracked == 0) {
+            num_occs = 1;
+            return true;
+        }
+        unsigned est = s.inc(h);
+        if (est < 2 && m_params.m_dack_threshold > 1)
+            return false;
+        num_occs = std::min(est, m_params.m_dack_threshold);
+        return true;
     }
 
     void dyn_ack_manager::cg_eh(app * n1, app * n2) {
@@ -151,22 +196,28 @@ namespace smt {
         app_pair p(n1, n2);
         if (m_instantiated.contains(p))
             return;
+        occs o;
         unsigned num_occs = 0;
-        if (m_app_pair2num_occs.find(n1, n2, num_occs)) {
+        if (m_app_pair2num_occs.find(n1, n2, o)) {
+            num_occs = o.m_num_occs;
             TRACE("dyn_ack", tout << "used_cg_eh:\n" << mk_pp(n1, m_manager) << "\n" << mk_pp(n2, m_manager) << "\nnum_occs: " << num_occs << "\n";);
             num_occs++;
         }
         else {
-            num_occs = 1;
+            if (!promote(m_sketch, hash_u_u(n1->get_id(), n2->get_id()), num_occs))
+                return;
             m_manager.inc_ref(n1);
             m_manager.inc_ref(n2);
             m_app_pairs.push_back(p);
         }
+        if (num_occs == m_params.m_dack_threshold && is_queue_full(m_to_instantiate.size() - m_qhead)) {
+            // the pair may reach the threshold again when the queue has room.
+            num_occs--;
+        }
         SASSERT(num_occs > 0);
-        m_app_pair2num_occs.insert(n1, n2, num_occs);
+        m_app_pair2num_occs.insert(n1, n2, occs(num_occs, m_stamp++));
 #ifdef Z3DEBUG
-        unsigned num_occs2 = 0;
-        SASSERT(m_app_pair2num_occs.find(n1, n2, num_occs2) && num_occs == num_occs2);
+        SASSERT(m_app_pair2num_occs.find(n1, n2, o) && num_occs == o.m_num_occs);
 #endif
         if (num_occs == m_params.m_dack_threshold) {
             TRACE("dyn_ack", tout << "found candidate:\n" << mk_pp(n1, m_manager) << "\n" << mk_pp(n2, m_manager) << "\nnum_occs: " << num_occs << "\n";);
@@ -186,24 +237,29 @@ namespace smt {
         app_triple tr(n1, n2, r);
         if (m_triple.m_instantiated.contains(tr))
             return;
+        occs o;
         unsigned num_occs = 0;
-        if (m_triple.m_app2num_occs.find(n1, n2, r, num_occs)) {
+        if (m_triple.m_app2num_occs.find(n1, n2, r, o)) {
+            num_occs = o.m_num_occs;
             TRACE("dyn_ack", tout << mk_pp(n1, m_manager) << "\n" << mk_pp(n2, m_manager) 
                   << mk_pp(r, m_manager) << "\n" << "\nnum_occs: " << num_occs << "\n";);
             num_occs++;
         }
         else {
-            num_occs = 1;
+            if (!promote(m_triple.m_sketch, combine_hash(hash_u_u(n1->get_id(), n2->get_id()), hash_u(r->get_id())), num_occs))
+                return;
             m_manager.inc_ref(n1);
             m_manager.inc_ref(n2);
             m_manager.inc_ref(r);
             m_triple.m_apps.push_back(tr);
         }
+        if (num_occs == m_params.m_dack_threshold && is_queue_full(m_triple.m_to_instantiate.size() - m_triple.m_qhead)) {
+            num_occs--;
+        }
         SASSERT(num_occs > 0);
-        m_triple.m_app2num_occs.insert(n1, n2, r, num_occs);
+        m_triple.m_app2num_occs.insert(n1, n2, r, occs(num_occs, m_stamp++));
 #ifdef Z3DEBUG
-        unsigned num_occs2 = 0;
-        SASSERT(m_triple.m_app2num_occs.find(n1, n2, r, num_occs2) && num_occs == num_occs2);
+        SASSERT(m_triple.m_app2num_occs.find(n1, n2, r, o) && num_occs == o.m_num_occs);
 #endif
         if (num_occs == m_params.m_dack_threshold) {
             TRACE("dyn_ack", tout << "found candidate:\n" << mk_pp(n1, m_manager) << "\n" << mk_pp(n2, m_manager) 
@@ -214,9 +270,10 @@ namespace smt {
         
     }
 
+    template<typename occs>
     struct app_pair_lt { 
         typedef std::pair<app *, app *>          app_pair;
-        typedef obj_pair_map<app, app, unsigned> app_pair2num_occs;
+        typedef obj_pair_map<app, app, occs>     app_pair2num_occs;
         app_pair2num_occs &  m_app_pair2num_occs;
         
         app_pair_lt(app_pair2num_occs & m):
@@ -224,13 +281,13 @@ namespace smt {
         }
         
         bool operator()(app_pair const & p1, app_pair const & p2) const {
-            unsigned n1 = 0;
-            unsigned n2 = 0;
+            occs n1;
+            occs n2;
             m_app_pair2num_occs.find(p1.first, p1.second, n1);
             m_app_pair2num_occs.find(p2.first, p2.second, n2);
-            SASSERT(n1 > 0);
-            SASSERT(n2 > 0);
-            return n1 > n2;
+            SASSERT(n1.m_num_occs > 0);
+            SASSERT(n2.m_num_occs > 0);
+            return n1.m_num_occs > n2.m_num_occs;
         }
     };
 
@@ -251,8 +308,9 @@ namespace smt {
                 SASSERT(!m_app_pair2num_occs.contains(p.first, p.second));
                 continue;
             }
-            unsigned num_occs = 0;
-            m_app_pair2num_occs.find(p.first, p.second, num_occs);
+            occs o;
+            m_app_pair2num_occs.find(p.first, p.second, o);
+            unsigned num_occs = o.m_num_occs;
             // The following invariant is not true. p.first and
             // p.second may have been instantiated, and removed from
             // m_app_pair2num_occs, but not from m_app_pairs.
@@ -270,15 +328,24 @@ namespace smt {
             *it2 = p;
             ++it2;
             SASSERT(num_occs > 0);
-            m_app_pair2num_occs.insert(p.first, p.second, num_occs);
+            m_app_pair2num_occs.insert(p.first, p.second, occs(num_occs, o.m_stamp));
             if (num_occs >= m_params.m_dack_threshold)
                 m_to_instantiate.push_back(p);
         }
         m_app_pairs.set_end(it2);
-        app_pair_lt f(m_app_pair2num_occs);
+        m_sketch.decay(m_params.m_dack_gc_inv_decay);
+        app_pair_lt<occs> f(m_app_pair2num_occs);
         // app_pair_lt is not a total order on pairs of expressions.
         // So, we should use stable_sort to avoid different behavior in different platforms.
         std::stable_sort(m_to_instantiate.begin(), m_to_instantiate.end(), f);
+        // keep the most frequent pairs, the others are counted below the threshold again.
+        for (unsigned i = m_to_instantiate.size(); i > 0 && is_queue_full(i - 1); --i) {
+            app_pair & p = m_to_instantiate[i - 1];
+            occs o;
+            VERIFY(m_app_pair2num_occs.find(p.first, p.second, o));
+            m_app_pair2num_occs.insert(p.first, p.second, occs(m_params.m_dack_threshold - 1, o.m_stamp));
+            m_to_instantiate.pop_back();
+        }
         // IF_VERBOSE(10, if (num_deleted > 0) verbose_stream() << "dynamic ackermann GC: " << num_deleted << "\n";);
     }
 
@@ -321,8 +388,20 @@ namespace smt {
         m_num_propagations_since_last_gc++;
         if (m_num_propagations_since_last_gc > m_params.m_dack_gc) {
             gc();
+            gc_triples();
             m_num_propagations_since_last_gc = 0;
         }
+        unsigned num_tracked = std::max(m_app_pairs.size(), m_triple.m_apps.size());
+        if (num_tracked > m_context.m_stats.m_max_dyn_ack_tracked)
+            m_context.m_stats.m_max_dyn_ack_tracked = num_tracked;
+        if (should_evict(m_app_pairs.size(), m_evict_lim)) {
+            evict_app_pairs();
+            m_evict_lim = m_app_pairs.size();
+        }
+        if (should_evict(m_triple.m_apps.size(), m_triple.m_evict_lim)) {
+            evict_app_triples();
+            m_triple.m_evict_lim = m_triple.m_apps.size();
+        }
         unsigned max_instances  = static_cast<unsigned>(m_context.get_num_conflicts() * m_params.m_dack_factor);
         while (m_num_instances < max_instances && m_qhead < m_to_instantiate.size()) {
             app_pair & p = m_to_instantiate[m_qhead];
@@ -330,12 +409,20 @@ namespace smt {
             m_num_instances++;
             instantiate(p.first, p.second);
         }
+        if (m_qhead == m_to_instantiate.size()) {
+            m_to_instantiate.reset();
+            m_qhead = 0;
+        }
         while (m_num_instances < max_instances && m_triple.m_qhead < m_triple.m_to_instantiate.size()) {
             app_triple & p = m_triple.m_to_instantiate[m_triple.m_qhead];
             m_triple.m_qhead++;
             m_num_instances++;
             instantiate(p.first, p.second, p.third);
         }
+        if (m_triple.m_qhead == m_triple.m_to_instantiate.size()) {
+            m_triple.m_to_instantiate.reset();
+            m_triple.m_qhead = 0;
+        }
     }
 
     literal dyn_ack_manager::mk_eq(expr * n1, expr * n2) {
@@ -436,9 +523,10 @@ namespace smt {
     }
 
 
+    template<typename occs>
     struct app_triple_lt { 
         typedef triple<app *, app *, app*>          app_triple;
-        typedef obj_triple_map<app, app, app, unsigned> app_triple2num_occs;
+        typedef obj_triple_map<app, app, app, occs> app_triple2num_occs;
         app_triple2num_occs &  m_app_triple2num_occs;
         
         app_triple_lt(app_triple2num_occs & m):
@@ -446,13 +534,13 @@ namespace smt {
         }
         
         bool operator()(app_triple const & p1, app_triple const & p2) const {
-            unsigned n1 = 0;
-            unsigned n2 = 0;
+            occs n1;
+            occs n2;
             m_app_triple2num_occs.find(p1.first, p1.second, p1.third, n1);
             m_app_triple2num_occs.find(p2.first, p2.second, p2.third, n2);
-            SASSERT(n1 > 0);
-            SASSERT(n2 > 0);
-            return n1 > n2;
+            SASSERT(n1.m_num_occs > 0);
+            SASSERT(n2.m_num_occs > 0);
+            return n1.m_num_occs > n2.m_num_occs;
         }
     };
 
@@ -474,8 +562,9 @@ namespace smt {
                 SASSERT(!m_triple.m_app2num_occs.contains(p.first, p.second, p.third));
                 continue;
             }
-            unsigned num_occs = 0;
-            m_triple.m_app2num_occs.find(p.first, p.second, p.third, num_occs);
+            occs o;
+            m_triple.m_app2num_occs.find(p.first, p.second, p.third, o);
+            unsigned num_occs = o.m_num_occs;
             // The following invariant is not true. p.first and
             // p.second may have been instantiated, and removed from
             // m_app_triple2num_occs, but not from m_app_triples.
@@ -494,18 +583,132 @@ namespace smt {
             *it2 = p;
             ++it2;
             SASSERT(num_occs > 0);
-            m_triple.m_app2num_occs.insert(p.first, p.second, p.third, num_occs);
+            m_triple.m_app2num_occs.insert(p.first, p.second, p.third, occs(num_occs, o.m_stamp));
             if (num_occs >= m_params.m_dack_threshold)
                 m_triple.m_to_instantiate.push_back(p);
         }
         m_triple.m_apps.set_end(it2);
-        app_triple_lt f(m_triple.m_app2num_occs);
+        m_triple.m_sketch.decay(m_params.m_dack_gc_inv_decay);
+        app_triple_lt<occs> f(m_triple.m_app2num_occs);
         // app_triple_lt is not a total order
         std::stable_sort(m_triple.m_to_instantiate.begin(), m_triple.m_to_instantiate.end(), f);
+        for (unsigned i = m_triple.m_to_instantiate.size(); i > 0 && is_queue_full(i - 1); --i) {
+            app_triple & p = m_triple.m_to_instantiate[i - 1];
+            occs o;
+            VERIFY(m_triple.m_app2num_occs.find(p.first, p.second, p.third, o));
+            m_triple.m_app2num_occs.insert(p.first, p.second, p.third, occs(m_params.m_dack_threshold - 1, o.m_stamp));
+            m_triple.m_to_instantiate.pop_back();
+        }
         // IF_VERBOSE(10, if (num_deleted > 0) verbose_stream() << "dynamic ackermann GC: " << num_deleted << "\n";);
     }
 
 
+    /**
+       \brief Return the stamp such that \c num_keep of the given stamps are not smaller than it.
+    */
+    unsigned dyn_ack_manager::mk_stamp_cutoff(svector<unsigned> & stamps, unsigned num_keep) const {
+        if (stamps.size() <= num_keep)
+            return 0;
+        unsigned * nth = stamps.begin() + (stamps.size() - num_keep);
+        std::nth_element(stamps.begin(), nth, stamps.end());
+        return *nth;
+    }
+
+    /**
+       \brief Return true if the tracked candidates should be evicted.
+       Eviction leaves at most dack.max_tracked candidates, and it runs
+       again only after a quarter of the budget was added since, so its
+       cost is amortized over the insertions. At most 5/4 of
+       dack.max_tracked candidates are tracked when propagate_eh runs.
+    */
+    bool dyn_ack_manager::should_evict(unsigned num_tracked, unsigned evict_lim) const {
+        unsigned max_tracked = m_params.m_dack_max_tracked;
+        return max_tracked > 0 && num_tracked > max_tracked && num_tracked >= evict_lim + max_tracked / 4;
+    }
+
+    /**
+       \brief Return true if no more candidates may wait for instantiation.
+       At most half of dack.max_tracked candidates wait, so that eviction,
+       which keeps them, can bring the table below the budget. With
+       dack.threshold 1 every tracked candidate is instantiated and the
+       queue is not bounded.
+    */
+    bool dyn_ack_manager::is_queue_full(unsigned num_queued) const {
+        return m_params.m_dack_max_tracked > 0 && m_params.m_dack_threshold > 1 && num_queued >= m_params.m_dack_max_tracked / 2;
+    }
+
+    /**
+       \brief Stop tracking the least recently used pairs, keeping at most
+       half of the budget for pairs that did not reach the threshold yet.
+       Pairs waiting to be instantiated are never evicted.
+    */
+    void dyn_ack_manager::evict_app_pairs() {
+        TRACE("dyn_ack", tout << "dyn_ack evict " << m_app_pairs.size() << "\n";);
+        svector<unsigned> stamps;
+        occs o;
+        svector<app_pair>::iterator it  = m_app_pairs.begin();
+        svector<app_pair>::iterator end = m_app_pairs.end();
+        for (; it != end; ++it) {
+            if (!m_instantiated.contains(*it) && m_app_pair2num_occs.find(it->first, it->second, o) && o.m_num_occs < m_params.m_dack_threshold)
+                stamps.push_back(o.m_stamp);
+        }
+        unsigned cutoff = mk_stamp_cutoff(stamps, m_params.m_dack_max_tracked / 2);
+        it = m_app_pairs.begin();
+        svector<app_pair>::iterator it2 = it;
+        for (; it != end; ++it) {
+            app_pair & p = *it;
+            if (m_instantiated.contains(p) || !m_app_pair2num_occs.find(p.first, p.second, o)) {
+                m_manager.dec_ref(p.first);
+                m_manager.dec_ref(p.second);
+                continue;
+            }
+            if (o.m_num_occs < m_params.m_dack_threshold && o.m_stamp < cutoff) {
+                m_context.m_stats.m_num_dyn_ack_evicted++;
+                m_app_pair2num_occs.erase(p.first, p.second);
+                m_manager.dec_ref(p.first);
+                m_manager.dec_ref(p.second);
+                continue;
+            }
+            *it2 = p;
+            ++it2;
+        }
+        m_app_pairs.set_end(it2);
+    }
+
+    void dyn_ack_manager::evict_app_triples() {
+        TRACE("dyn_ack", tout << "dyn_ack evict triples " << m_triple.m_apps.size() << "\n";);
+        svector<unsigned> stamps;
+        occs o;
+        svector<app_triple>::iterator it  = m_triple.m_apps.begin();
+        svector<app_triple>::iterator end = m_triple.m_apps.end();
+        for (; it != end; ++it) {
+            if (!m_triple.m_instantiated.contains(*it) && m_triple.m_app2num_occs.find(it->first, it->second, it->third, o) && o.m_num_occs < m_params.m_dack_threshold)
+                stamps.push_back(o.m_stamp);
+        }
+        unsigned cutoff = mk_stamp_cutoff(stamps, m_params.m_dack_max_tracked / 2);
+        it = m_triple.m_apps.begin();
+        svector<app_triple>::iterator it2 = it;
+        for (; it != end; ++it) {
+            app_triple & p = *it;
+            if (m_triple.m_instantiated.contains(p) || !m_triple.m_app2num_occs.find(p.first, p.second, p.third, o)) {
+                m_manager.dec_ref(p.first);
+                m_manager.dec_ref(p.second);
+                m_manager.dec_ref(p.third);
+                continue;
+            }
+            if (o.m_num_occs < m_params.m_dack_threshold && o.m_stamp < cutoff) {
+                m_context.m_stats.m_num_dyn_ack_evicted++;
+                m_triple.m_app2num_occs.erase(p.first, p.second, p.third);
+                m_manager.dec_ref(p.first);
+                m_manager.dec_ref(p.second);
+                m_manager.dec_ref(p.third);
+                continue;
+            }
+            *it2 = p;
+            ++it2;
+        }
+        m_triple.m_apps.set_end(it2);
+    }
 
 #ifdef Z3DEBUG
     bool dyn_ack_manager::check_invariant() const {
@@ -30,15 +30,48 @@ namespace smt {
 
     class context;
 
+    /**
+       \brief Count-min sketch used to approximate the number of
+       occurrences of candidates that are not tracked exactly.
+       It uses a fixed amount of memory, and estimates never
+       underapproximate the number of (decayed) occurrences.
+    */
+    class dyn_ack_sketch {
+        static const unsigned c_num_rows = 4;
+        static const unsigned c_log_width = 12;
+        svector<unsigned> m_counters;
+        unsigned idx(unsigned row, unsigned h) const {
+            return (row << c_log_width) + (hash_u_u(h, row) & ((1u << c_log_width) - 1));
+        }
+    public:
+        /**
+           \brief Record one occurrence of the candidate with hash \c h and
+           return the estimated number of its occurrences.
+        */
+        unsigned inc(unsigned h);
+        void decay(double f);
+        void reset() { m_counters.reset(); }
+    };
+
     class dyn_ack_manager {
+        /**
+           \brief Exact number of occurrences of a tracked candidate, and
+           the time it was last used in a conflict.
+        */
+        struct occs {
+            unsigned m_num_occs;
+            unsigned m_stamp;
+            occs(): m_num_occs(0), m_stamp(0) {}
+            occs(unsigned n, unsigned s): m_num_occs(n), m_stamp(s) {}
+        };
         typedef std::pair<app *, app *>           app_pair;
-        typedef obj_pair_map<app, app, unsigned>  app_pair2num_occs;
+        typedef obj_pair_map<app, app, occs>      app_pair2num_occs;
         typedef svector<app_pair>                 app_pair_vector;
         typedef obj_pair_hashtable<app, app>      app_pair_set;
         typedef obj_map<clause, app_pair>         clause2app_pair;
 
         typedef triple<app *, app *,app *>        app_triple;
-        typedef obj_triple_map<app, app, app, unsigned>  app_triple2num_occs;
+        typedef obj_triple_map<app, app, app, occs>      app_triple2num_occs;
         typedef svector<app_triple>                 app_triple_vector;
         typedef obj_triple_hashtable<app, app, app>      app_triple_set;
         typedef obj_map<clause, app_triple>         clause2app_triple;
@@ -54,6 +87,9 @@ namespace smt {
         unsigned                                   m_num_propagations_since_last_gc;
         app_pair_set                               m_instantiated;
         clause2app_pair                            m_clause2app_pair;
+        dyn_ack_sketch                             m_sketch;
+        unsigned                                   m_stamp;
+        unsigned                                   m_evict_lim; // number of pairs after the last eviction
 
         struct _triple {
             app_triple2num_occs                    m_app2num_occs;
@@ -64,6 +100,8 @@ namespace smt {
             unsigned                               m_num_propagations_since_last_gc;
             app_triple_set                         m_instantiated;
             clause2app_triple                      m_clause2apps;
+            dyn_ack_sketch                         m_sketch;
+            unsigned                               m_evict_lim;
         };
         _triple                                    m_triple;
         
@@ -71,6 +109,12 @@ namespace smt {
 
         void gc();
         void reset_app_pairs();
+        bool promote(dyn_ack_sketch & s, unsigned h, unsigned & num_occs);
+        unsigned mk_stamp_cutoff(svector<unsigned> & stamps, unsigned num_keep) const;
+        bool should_evict(unsigned num_tracked, unsigned evict_lim) const;
+        bool is_queue_full(unsigned num_queued) const;
+        void evict_app_pairs();
+        void evict_app_triples();
         friend class dyn_ack_clause_del_eh;
         void del_clause_eh(clause * cls);
         void instantiate(app * n1, app * n2);
@@ -34,6 +34,7 @@ struct dyn_ack_params {
     unsigned         m_dack_threshold;
     unsigned         m_dack_gc;
     double           m_dack_gc_inv_decay;
+    unsigned         m_dack_max_tracked;
 
 public:
     dyn_ack_params(params_ref const & p = params_ref()) :
@@ -42,7 +43,8 @@ public:
         m_dack_factor(0.1),
         m_dack_threshold(10),
         m_dack_gc(2000), 
-        m_dack_gc_inv_decay(0.8) {
+        m_dack_gc_inv_decay(0.8),
+        m_dack_max_tracked(100000) {
         updt_params(p);
     }
 
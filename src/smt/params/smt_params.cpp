@@ -38,6 +38,7 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_rlimit  = p.rlimit();
     m_max_conflicts = p.max_conflicts();
     m_core_validate = p.core_validate();
+    m_seq_max_automata_states = p.seq_max_automata_states();
     m_logic = _p.get_sym("logic", m_logic);
     model_params mp(_p);
     m_model_compact = mp.compact();
@@ -197,6 +197,13 @@ struct smt_params : public preprocessor_params,
     bool             m_display_installed_theories;
     bool             m_core_validate;
 
+    // -----------------------------------
+    //
+    // Sequences
+    //
+    // -----------------------------------
+    unsigned         m_seq_max_automata_states;
+
     // -----------------------------------
     //
     // From front_end_params
@@ -272,6 +279,7 @@ struct smt_params : public preprocessor_params,
         m_progress_sampling_freq(0),
         m_display_installed_theories(false),
         m_core_validate(false),
+        m_seq_max_automata_states(1000000),
         m_preprocess(true), // temporary hack for disabling all preprocessing..
         m_user_theory_preprocess_axioms(false),
         m_user_theory_persist_axioms(false),
@@ -385,6 +385,8 @@ namespace smt {
         st.update("mk clause", m_stats.m_num_mk_clause);
         st.update("del clause", m_stats.m_num_del_clause);
         st.update("dyn ack", m_stats.m_num_dyn_ack);
+        st.update("dyn ack evicted", m_stats.m_num_dyn_ack_evicted);
+        st.update("dyn ack max tracked", m_stats.m_max_dyn_ack_tracked);
         st.update("interface eqs", m_stats.m_num_interface_eqs);
         st.update("max generation", m_stats.m_max_generation);
         st.update("minimized lits", m_stats.m_num_minimized_lits);
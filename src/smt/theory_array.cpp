@@ -93,6 +93,21 @@ namespace smt {
         return r;
     }
     
+    /**
+       \brief Return true if s is congruent to a select that was already
+       registered with add_parent_select. Both selects have the same array
+       class and index classes, so they produce the same axiom 2 fingerprints
+       for every store, and it suffices to instantiate the axioms for the
+       congruence root.
+
+       Only the walk for such selects is skipped. The selects that are not
+       congruent are still combined eagerly with every store of their class,
+       whether or not the pair matters for the current model.
+    */
+    bool theory_array::is_redundant_select(enode * s) const {
+        return !s->is_cgr() && m_registered_selects.contains(s->get_cg());
+    }
+
     void theory_array::add_parent_select(theory_var v, enode * s) {
         if (m_params.m_array_cg && !s->is_cgr())
             return;
@@ -102,6 +117,15 @@ namespace smt {
         d->m_parent_selects.push_back(s);
         TRACE("array", tout << mk_pp(s->get_owner(), get_manager()) << " " << mk_pp(get_enode(v)->get_owner(), get_manager()) << "\n";);
         m_trail_stack.push(push_back_trail<theory_array, enode *, false>(d->m_parent_selects));
+        if (!m_registered_selects.contains(s)) {
+            m_registered_selects.insert(s);
+            m_trail_stack.push(insert_obj_trail<theory_array, enode>(m_registered_selects, s));
+        }
+        if (is_redundant_select(s)) {
+            TRACE("array", tout << "skipping congruent select #" << s->get_owner_id() << "\n";);
+            m_stats.m_num_axiom2_skipped += d->m_stores.size();
+            return;
+        }
         ptr_vector<enode>::iterator it  = d->m_stores.begin();
         ptr_vector<enode>::iterator end = d->m_stores.end();
         for (; it != end; ++it) {
@@ -435,6 +459,7 @@ namespace smt {
         m_trail_stack.reset();
         std::for_each(m_var_data.begin(), m_var_data.end(), delete_proc<var_data>());
         m_var_data.reset();
+        m_registered_selects.reset();
         theory_array_base::reset_eh();
     }
 
@@ -483,6 +508,7 @@ namespace smt {
         st.update("array exp ax2", m_stats.m_num_axiom2b);
         st.update("array ext ax", m_stats.m_num_extensionality);
         st.update("array splits", m_stats.m_num_eq_splits);
+        st.update("array ax2 skipped", m_stats.m_num_axiom2_skipped);
     }
 
 };
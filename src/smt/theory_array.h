@@ -30,6 +30,7 @@ namespace smt {
         unsigned   m_num_map_axiom, m_num_default_map_axiom;
         unsigned   m_num_select_const_axiom, m_num_default_store_axiom, m_num_default_const_axiom, m_num_default_as_array_axiom;
         unsigned   m_num_select_as_array_axiom;
+        unsigned   m_num_axiom2_skipped;
         void reset() { memset(this, 0, sizeof(theory_array_stats)); }
         theory_array_stats() { reset(); }
     };
@@ -54,6 +55,7 @@ namespace smt {
         th_union_find                   m_find;
         th_trail_stack                  m_trail_stack;
         unsigned                        m_final_check_idx;
+        obj_hashtable<enode>            m_registered_selects; // selects passed to add_parent_select
 
         virtual void init(context * ctx);
         virtual theory_var mk_var(enode * n);
@@ -79,6 +81,7 @@ namespace smt {
         bool is_root(theory_var v) const { return m_find.is_root(v); }
 
         virtual void add_parent_select(theory_var v, enode * s);
+        bool is_redundant_select(enode * s) const;
         void add_parent_store(theory_var v, enode * s);
         void add_store(theory_var v, enode * s);
 
@@ -395,6 +395,9 @@ namespace smt {
               display_var(tout, v);
               );
         theory_array::add_parent_select(v,s);
+        // the congruence root of s produces the same axioms.
+        if (is_redundant_select(s))
+            return;
         v = find(v);
         var_data_full* d_full = m_var_data_full[v];
         var_data* d = m_var_data[v];
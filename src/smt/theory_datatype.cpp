@@ -206,6 +206,7 @@ namespace smt {
         ctx.attach_th_var(n, this, r);
         if (is_constructor(n)) {
             d->m_constructor = n;
+            m_oc_dirty = true;
             assert_accessor_axioms(n);
         }
         else if (is_update_field(n)) {
@@ -396,10 +397,17 @@ namespace smt {
     final_check_status theory_datatype::final_check_eh() {
         int num_vars = get_num_vars();
         final_check_status r = FC_DONE;
+        // Backtracking only removes constructors and merges, so the classes
+        // remain acyclic if nothing was added since the last successful check.
+        bool check_cycles = m_oc_dirty;
+        if (check_cycles)
+            init_occurs_check();
+        else
+            m_stats.m_occurs_check_skipped++;
         for (int v = 0; v < num_vars; v++) {
             if (v == static_cast<int>(m_find.find(v))) {
                 enode * node = get_enode(v);
-                if (occurs_check(node)) {
+                if (check_cycles && occurs_check(node)) {
                     // conflict was detected... 
                     // return...
                     return FC_CONTINUE;
@@ -414,9 +422,18 @@ namespace smt {
                 }
             }
         }
+        m_oc_dirty = false;
         return r;
     }
 
+    void theory_datatype::init_occurs_check() {
+        unsigned num_vars = get_num_vars();
+        m_oc_mark.reset();
+        m_oc_mark.resize(num_vars, OC_UNVISITED);
+        m_oc_start.resize(num_vars, 0);
+        m_oc_entry.resize(num_vars, 0);
+    }
+
     /**
        \brief Check if n can be reached starting from n and following equalities and constructors.
        For example, occur_check(a1) returns true in the following set of equalities:
@@ -426,11 +443,8 @@ namespace smt {
     */
     bool theory_datatype::occurs_check(enode * n) {
         TRACE("datatype", tout << "occurs check: #" << n->get_owner_id() << "\n";);
-        m_to_unmark.reset();
         m_used_eqs.reset();
-        m_main   = n;
-        bool res = occurs_check_core(m_main);
-        unmark_enodes(m_to_unmark.size(), m_to_unmark.c_ptr());
+        bool res = occurs_check_core(n);
         if (res) {
             context & ctx = get_context();
             region & r    = ctx.get_region();
@@ -450,43 +464,62 @@ namespace smt {
 
     /**
        \brief Auxiliary method for occurs_check.
-       TODO: improve performance.
+       
+       The marks are shared by all occurs checks of a final check: a class
+       that was completely explored without finding a cycle cannot reach a
+       class that has not been visited yet, so it does not need to be explored
+       again. A cycle is detected when a class that is still being explored is
+       reached again; m_used_eqs then contains the path starting at that class.
     */
     bool theory_datatype::occurs_check_core(enode * app) {
-        if (app->is_marked())
+        theory_var v = app->get_root()->get_th_var(get_id());
+        if (v == null_theory_var)
             return false;
-        
+        v = m_find.find(v);
+        if (m_oc_mark[v] != OC_UNVISITED)
+            return false;
+
         m_stats.m_occurs_check++;
-        app->set_mark();
-        m_to_unmark.push_back(app);
-        
-        TRACE("datatype", tout << "occurs check_core: #" << app->get_owner_id() << " #" << m_main->get_owner_id() << "\n";);
+        TRACE("datatype", tout << "occurs check_core: #" << app->get_owner_id() << "\n";);
 
-        theory_var v = app->get_root()->get_th_var(get_id());
-        if (v != null_theory_var) {
-            v = m_find.find(v);
-            var_data * d = m_var_data[v];
-            if (d->m_constructor) {
-                if (app != d->m_constructor)
-                    m_used_eqs.push_back(enode_pair(app, d->m_constructor));
-                unsigned num_args = d->m_constructor->get_num_args();
-                for (unsigned i = 0; i < num_args; i++) {
-                    enode * arg = d->m_constructor->get_arg(i);
-                    if (arg->get_root() == m_main->get_root()) {
-                        if (arg != m_main)
-                            m_used_eqs.push_back(enode_pair(arg, m_main));
-                        return true;
-                    }
-                    if (m_util.is_datatype(get_manager().get_sort(arg->get_owner())) && occurs_check_core(arg))
-                        return true;
-                }
-                if (app != d->m_constructor) {
-                    SASSERT(m_used_eqs.back().first  == app);
-                    SASSERT(m_used_eqs.back().second == d->m_constructor);
-                    m_used_eqs.pop_back();
-                }
+        var_data * d = m_var_data[v];
+        if (!d->m_constructor) {
+            m_oc_mark[v] = OC_DONE;
+            return false;
+        }
+        m_oc_mark[v]  = OC_IN_PROGRESS;
+        m_oc_start[v] = m_used_eqs.size();
+        m_oc_entry[v] = app;
+        if (app != d->m_constructor)
+            m_used_eqs.push_back(enode_pair(app, d->m_constructor));
+        unsigned num_args = d->m_constructor->get_num_args();
+        for (unsigned i = 0; i < num_args; i++) {
+            enode * arg = d->m_constructor->get_arg(i);
+            if (!m_util.is_datatype(get_manager().get_sort(arg->get_owner())))
+                continue;
+            theory_var w = arg->get_root()->get_th_var(get_id());
+            if (w != null_theory_var && m_oc_mark[m_find.find(w)] == OC_IN_PROGRESS) {
+                w = m_find.find(w);
+                enode * entry = m_oc_entry[w];
+                if (arg != entry)
+                    m_used_eqs.push_back(enode_pair(arg, entry));
+                // keep only the equalities on the cycle.
+                unsigned start = m_oc_start[w];
+                unsigned sz    = m_used_eqs.size();
+                for (unsigned j = start; j < sz; j++)
+                    m_used_eqs[j - start] = m_used_eqs[j];
+                m_used_eqs.shrink(sz - start);
+                return true;
             }
+            if (occurs_check_core(arg))
+                return true;
+        }
+        if (app != d->m_constructor) {
+            SASSERT(m_used_eqs.back().first  == app);
+            SASSERT(m_used_eqs.back().second == d->m_constructor);
+            m_used_eqs.pop_back();
         }
+        m_oc_mark[v] = OC_DONE;
         return false;
     }
         
@@ -494,6 +527,7 @@ namespace smt {
         m_trail_stack.reset();
         std::for_each(m_var_data.begin(), m_var_data.end(), delete_proc<var_data>());
         m_var_data.reset();
+        m_oc_dirty = true;
         theory::reset_eh();
         m_util.reset();
         m_stats.reset();
@@ -512,7 +546,8 @@ namespace smt {
         m_params(p),
         m_util(m),
         m_find(*this),
-        m_trail_stack(*this) {
+        m_trail_stack(*this),
+        m_oc_dirty(true) {
     }
 
     theory_datatype::~theory_datatype() {
@@ -530,6 +565,7 @@ namespace smt {
 
     void theory_datatype::collect_statistics(::statistics & st) const {
         st.update("datatype occurs check", m_stats.m_occurs_check);
+        st.update("datatype occurs check skipped", m_stats.m_occurs_check_skipped);
         st.update("datatype splits", m_stats.m_splits);
         st.update("datatype constructor ax", m_stats.m_assert_cnstr);
         st.update("datatype accessor ax", m_stats.m_assert_accessor);
@@ -589,6 +625,7 @@ namespace smt {
         // v1 is the new root
         TRACE("datatype", tout << "merging v" << v1 << " v" << v2 << "\n";);
         SASSERT(v1 == static_cast<int>(m_find.find(v1)));
+        m_oc_dirty = true;
         var_data * d1 = m_var_data[v1];
         var_data * d2 = m_var_data[v2];
         if (d2->m_constructor != 0) {
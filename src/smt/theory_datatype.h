@@ -40,7 +40,7 @@ namespace smt {
         };
 
         struct stats {
-            unsigned   m_occurs_check, m_splits;
+            unsigned   m_occurs_check, m_occurs_check_skipped, m_splits;
             unsigned   m_assert_cnstr, m_assert_accessor, m_assert_update_field;
             void reset() { memset(this, 0, sizeof(stats)); }
             stats() { reset(); }
@@ -73,9 +73,15 @@ namespace smt {
         void propagate_recognizer(theory_var v, enode * r);
         void sign_recognizer_conflict(enode * c, enode * r);
 
-        ptr_vector<enode>    m_to_unmark;
+        // occurs check: depth-first search over the equivalence classes,
+        // following the arguments of their constructors.
+        enum oc_mark { OC_UNVISITED, OC_IN_PROGRESS, OC_DONE };
+        svector<oc_mark>     m_oc_mark;      // state of each root variable
+        unsigned_vector      m_oc_start;     // size of m_used_eqs when the class was entered
+        ptr_vector<enode>    m_oc_entry;     // node through which the class was entered
+        bool                 m_oc_dirty;     // constructors or classes changed since the last successful check
         enode_pair_vector    m_used_eqs;
-        enode *              m_main;
+        void init_occurs_check();
         bool occurs_check(enode * n);
         bool occurs_check_core(enode * n);
 
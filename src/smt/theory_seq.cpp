@@ -212,6 +212,9 @@ theory_seq::theory_seq(ast_manager& m):
     m_trail_stack(*this),
     m_ls(m), m_rs(m),
     m_lhs(m), m_rhs(m),
+    m_res(m),
+    m_num_automata_states(0),
+    m_num_failed_automata(0),
     m_atoms_qhead(0),
     m_new_solution(false),
     m_new_propagation(false),
@@ -1187,12 +1190,10 @@ bool theory_seq::is_solved() {
         IF_VERBOSE(10, verbose_stream() << "(seq.giveup " << m_eqs[0].ls() << " = " << m_eqs[0].rs() << " is unsolved)\n";);
         return false;
     }
-    for (unsigned i = 0; i < m_automata.size(); ++i) {
-        if (!m_automata[i]) {
-            TRACE("seq", tout  << "(seq.giveup regular expression did not compile to automaton)\n";);
-            IF_VERBOSE(10, verbose_stream() << "(seq.giveup regular expression did not compile to automaton)\n";);
-            return false;
-        }
+    if (m_num_failed_automata > 0) {
+        TRACE("seq", tout  << "(seq.giveup regular expression did not compile to automaton)\n";);
+        IF_VERBOSE(10, verbose_stream() << "(seq.giveup regular expression did not compile to automaton)\n";);
+        return false;
     }
     if (false && !m_nqs.empty()) {
         TRACE("seq", display_disequation(tout << "(seq.giveup ", m_nqs[0]); tout << " is unsolved)\n";);
@@ -2431,6 +2432,10 @@ void theory_seq::collect_statistics(::statistics & st) const {
     st.update("seq extensionality", m_stats.m_extensionality);
     st.update("seq fixed length", m_stats.m_fixed_length);
     st.update("seq int.to.str", m_stats.m_int_string);
+    st.update("seq automata", m_stats.m_automata_built);
+    st.update("seq automata states", m_stats.m_automata_states);
+    st.update("seq automata cache hits", m_stats.m_automata_hits);
+    st.update("seq automata flushes", m_stats.m_automata_flushes);
 }
 
 void theory_seq::init_model(expr_ref_vector const& es) {
@@ -3838,21 +3843,51 @@ void theory_seq::relevant_eh(app* n) {
 eautomaton* theory_seq::get_automaton(expr* re) {
     eautomaton* result = 0;
     if (m_re2aut.find(re, result)) {
-        return result;
+        ++m_stats.m_automata_hits;
+    }
+    else {
+        result = m_mk_aut(re);
+        ++m_stats.m_automata_built;
+        if (result) {
+            display_expr disp(m);
+            TRACE("seq", result->display(tout, disp););
+            if (!m_automata.empty() &&
+                m_num_automata_states + result->num_states() > get_context().get_fparams().m_seq_max_automata_states) {
+                reset_automata();
+            }
+            m_num_automata_states += result->num_states();
+            m_stats.m_automata_states += result->num_states();
+        }
+        m_automata.push_back(result);
+        m_re2aut.insert(re, result);
+        m_res.push_back(re);
     }
-    result = m_mk_aut(re);
-    if (result) {
-        display_expr disp(m);
-        TRACE("seq", result->display(tout, disp););
+    if (!result) {
+        // failures are scoped: the regular expression may not be used after backtracking.
+        m_trail_stack.push(value_trail<theory_seq, unsigned>(m_num_failed_automata));
+        ++m_num_failed_automata;
     }
-    m_automata.push_back(result);
-    m_trail_stack.push(push_back_vector<theory_seq, scoped_ptr_vector<eautomaton> >(m_automata));
-
-    m_re2aut.insert(re, result);
-    m_trail_stack.push(insert_obj_map<theory_seq, expr, eautomaton*>(m_re2aut, re));
     return result;
 }
 
+/**
+   \brief Remove all cached automata.
+   It is called from get_automaton before an automaton that would exceed
+   seq.max_automata_states is inserted. Each caller of get_automaton uses
+   only the automaton it obtained, while it processes one predicate, and
+   automata are rebuilt on demand from the regular expression, so no
+   automaton in use is removed. An automaton that alone exceeds the bound
+   is still kept until the next insertion.
+*/
+void theory_seq::reset_automata() {
+    TRACE("seq", tout << "flush " << m_automata.size() << " automata with " << m_num_automata_states << " states\n";);
+    m_re2aut.reset();
+    m_automata.reset();
+    m_res.reset();
+    m_num_automata_states = 0;
+    ++m_stats.m_automata_flushes;
+}
+
 literal theory_seq::mk_accept(expr* s, expr* idx, expr* re, expr* state) {
     expr_ref_vector args(m);
     args.push_back(s).push_back(idx).push_back(re).push_back(state);
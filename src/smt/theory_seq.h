@@ -288,6 +288,10 @@ namespace smt {
             unsigned m_fixed_length;
             unsigned m_propagate_contains;
             unsigned m_int_string;
+            unsigned m_automata_built;
+            unsigned m_automata_states;
+            unsigned m_automata_hits;
+            unsigned m_automata_flushes;
         };
         typedef hashtable<rational, rational::hash_proc, rational::eq_proc> rational_set;
 
@@ -326,8 +330,15 @@ namespace smt {
         expr_ref_vector  m_ls, m_rs, m_lhs, m_rhs;
 
         // maintain automata with regular expressions.
+        // The automata are not backtracked: they only depend on the regular
+        // expression, so they are reused across scopes and check-sat calls.
+        // The cache is flushed before an insertion would make it exceed
+        // seq.max_automata_states.
         scoped_ptr_vector<eautomaton>  m_automata;
         obj_map<expr, eautomaton*>     m_re2aut;
+        expr_ref_vector                m_res;
+        unsigned                       m_num_automata_states;
+        unsigned                       m_num_failed_automata; // regular expressions in scope without automaton
 
         // queue of asserted atoms
         ptr_vector<expr>               m_atoms;
@@ -526,6 +537,7 @@ namespace smt {
         // automata utilities
         void propagate_in_re(expr* n, bool is_true);
         eautomaton* get_automaton(expr* e);
+        void reset_automata();
         literal mk_accept(expr* s, expr* idx, expr* re, expr* state);
         literal mk_accept(expr* s, expr* idx, expr* re, unsigned i) { return mk_accept(s, idx, re, m_autil.mk_int(i)); }
         bool is_accept(expr* acc) const {  return is_skolem(m_accept, acc); }
@@ -20,6 +20,7 @@ Notes:
 #include"goal.h"
 #include"ast_smt2_pp.h"
 #include"cooperate.h"
+#include"sat_solver.h"
 
 #define USE_TWO_LEVEL_RULES
 #define FIRST_NODE_ID (UINT_MAX/2)
@@ -1548,6 +1549,334 @@ public:
         return p(l);
     }
 
+    /**
+       \brief SAT sweeping (fraiging): merge nodes that are functionally equivalent.
+
+       Nodes are simulated using random 64-bit patterns. Nodes with the same
+       signature (modulo negation) are candidates to be equivalent, and the
+       candidates are checked using an incremental SAT solver encoding the whole AIG.
+       Counterexamples are used as additional simulation patterns in the next round.
+    */
+    struct fraig_proc {
+        typedef unsigned long long word;
+        static const unsigned c_num_random_words = 2;
+        static const unsigned c_max_rounds = 8;
+
+        imp &                  m;
+        aig_fraig_stats &      m_stats;
+        ptr_vector<aig>        m_nodes;      // nodes in topological order, m_nodes[0] is the true node.
+        u_map<unsigned>        m_id2idx;
+        unsigned               m_num_words;
+        svector<word>          m_sim;        // m_num_words words per node
+        svector<word>          m_var_patterns; // m_num_words words per node, only used for variables
+        svector<aig_lit>       m_repr;       // literal equivalent to the node, or null
+        svector<bool>          m_undecided;  // the check of the node exhausted its conflict budget.
+        unsigned               m_max_conflicts; // conflict budget of each equivalence check.
+        svector<sat::bool_var> m_node2var;
+        params_ref             m_params;
+        sat::solver            m_solver;
+        random_gen             m_rand;
+        svector<word>          m_cex_word;   // one word per node, only used for variables
+        unsigned               m_num_cex;
+
+        static params_ref mk_params() {
+            params_ref p;
+            p.set_bool("elim_vars", false);
+            return p;
+        }
+
+        fraig_proc(imp & _m, unsigned max_conflicts, aig_fraig_stats & st):
+            m(_m), 
+            m_stats(st), 
+            m_num_words(0),
+            m_max_conflicts(max_conflicts),
+            m_params(mk_params()),
+            m_solver(m_params, m.m().limit(), 0),
+            m_num_cex(0) {
+        }
+
+        unsigned idx(aig * n) const { 
+            unsigned r = UINT_MAX;
+            VERIFY(m_id2idx.find(n->m_id, r));
+            return r;
+        }
+
+        void collect(aig * root) {
+            m_nodes.push_back(m.m_true.ptr());
+            m_id2idx.insert(0, 0);
+            ptr_vector<aig> todo;
+            todo.push_back(root);
+            while (!todo.empty()) {
+                m.checkpoint();
+                aig * n = todo.back();
+                if (m_id2idx.contains(n->m_id)) {
+                    todo.pop_back();
+                    continue;
+                }
+                if (!is_var(n) && !n->m_mark) {
+                    n->m_mark = true;
+                    todo.push_back(left(n).ptr());
+                    todo.push_back(right(n).ptr());
+                    continue;
+                }
+                todo.pop_back();
+                n->m_mark = false;
+                m_id2idx.insert(n->m_id, m_nodes.size());
+                m_nodes.push_back(n);
+            }
+            m_repr.resize(m_nodes.size(), aig_lit::null);
+            m_undecided.resize(m_nodes.size(), false);
+            m_cex_word.resize(m_nodes.size(), 0);
+        }
+
+        word random_word() {
+            word r = 0;
+            for (unsigned i = 0; i < 5; i++)
+                r = (r << 15) ^ static_cast<word>(m_rand());
+            return r;
+        }
+
+        // add a simulation pattern to every variable, the pattern of a variable is w(i) for the variable with index i.
+        template<typename F>
+        void add_word(F const & w) {
+            unsigned num_words = m_num_words + 1;
+            svector<word> new_patterns;
+            new_patterns.resize(m_nodes.size() * num_words, 0);
+            for (unsigned i = 0; i < m_nodes.size(); i++) {
+                if (!is_var(m_nodes[i]))
+                    continue;
+                for (unsigned j = 0; j < m_num_words; j++)
+                    new_patterns[i * num_words + j] = m_var_patterns[i * m_num_words + j];
+                new_patterns[i * num_words + m_num_words] = i == 0 ? ~static_cast<word>(0) : w(i);
+            }
+            m_var_patterns.swap(new_patterns);
+            m_num_words = num_words;
+        }
+
+        struct random_pattern {
+            fraig_proc & p;
+            random_pattern(fraig_proc & p):p(p) {}
+            word operator()(unsigned i) const { return p.random_word(); }
+        };
+
+        struct cex_pattern {
+            fraig_proc & p;
+            cex_pattern(fraig_proc & p):p(p) {}
+            // bits without counterexample are random.
+            word operator()(unsigned i) const { 
+                word mask = p.m_num_cex == 64 ? ~static_cast<word>(0) : ((static_cast<word>(1) << p.m_num_cex) - 1);
+                return (p.m_cex_word[i] & mask) | (p.random_word() & ~mask);
+            }
+        };
+
+        word sim(aig_lit const & l, unsigned w) const {
+            word r = m_sim[idx(l.ptr()) * m_num_words + w];
+            return l.is_inverted() ? ~r : r;
+        }
+
+        void simulate() {
+            m_sim.reset();
+            m_sim.resize(m_nodes.size() * m_num_words, 0);
+            for (unsigned i = 0; i < m_nodes.size(); i++) {
+                aig * n = m_nodes[i];
+                for (unsigned w = 0; w < m_num_words; w++) {
+                    if (is_var(n))
+                        m_sim[i * m_num_words + w] = m_var_patterns[i * m_num_words + w];
+                    else
+                        m_sim[i * m_num_words + w] = sim(left(n), w) & sim(right(n), w);
+                }
+            }
+        }
+
+        // the signature of a node is normalized such that the first bit is 0.
+        bool phase(unsigned i) const { return (m_sim[i * m_num_words] & 1) != 0; }
+
+        unsigned sig_hash(unsigned i) const {
+            word neg = phase(i) ? ~static_cast<word>(0) : 0;
+            unsigned h = 17;
+            for (unsigned w = 0; w < m_num_words; w++) {
+                word s = m_sim[i * m_num_words + w] ^ neg;
+                h = combine_hash(h, hash_ull(s));
+            }
+            return h;
+        }
+
+        bool same_sig(unsigned i, unsigned j) const {
+            word neg = phase(i) != phase(j) ? ~static_cast<word>(0) : 0;
+            for (unsigned w = 0; w < m_num_words; w++) 
+                if (m_sim[i * m_num_words + w] != (m_sim[j * m_num_words + w] ^ neg))
+                    return false;
+            return true;
+        }
+
+        sat::literal to_lit(aig_lit const & l) const {
+            return sat::literal(m_node2var[idx(l.ptr())], l.is_inverted());
+        }
+
+        void encode() {
+            // the variables are used as assumptions, so they must not be eliminated.
+            for (unsigned i = 0; i < m_nodes.size(); i++) 
+                m_node2var.push_back(m_solver.mk_var(true, true));
+            sat::literal t(m_node2var[0], false);
+            m_solver.mk_clause(1, &t);
+            for (unsigned i = 0; i < m_nodes.size(); i++) {
+                aig * n = m_nodes[i];
+                if (is_var(n))
+                    continue;
+                sat::literal x(m_node2var[i], false);
+                sat::literal a = to_lit(left(n));
+                sat::literal b = to_lit(right(n));
+                m_solver.mk_clause(~x, a);
+                m_solver.mk_clause(~x, b);
+                m_solver.mk_clause(x, ~a, ~b);
+            }
+        }
+
+        void save_cex() {
+            sat::model const & mdl = m_solver.get_model();
+            for (unsigned i = 1; i < m_nodes.size(); i++) {
+                if (!is_var(m_nodes[i]))
+                    continue;
+                if (m_num_cex == 0)
+                    m_cex_word[i] = 0;
+                if (mdl[m_node2var[i]] == l_true)
+                    m_cex_word[i] |= static_cast<word>(1) << m_num_cex;
+            }
+            m_num_cex++;
+            if (m_num_cex == 64) 
+                flush_cex();
+        }
+
+        void flush_cex() {
+            if (m_num_cex == 0)
+                return;
+            add_word(cex_pattern(*this));
+            m_num_cex = 0;
+        }
+
+        // return l_true if x and y are equivalent, l_false if a counterexample was found,
+        // and l_undef if the conflict budget of the check was exhausted.
+        lbool check(sat::literal x, sat::literal y) {
+            for (unsigned k = 0; k < 2; k++) {
+                sat::literal asms[2] = { x, ~y };
+                m_stats.m_num_sat_calls++;
+                m_params.set_uint("max_conflicts", m_solver.num_conflicts() + m_max_conflicts);
+                m_solver.updt_params(m_params);
+                lbool r = m_solver.check(2, asms);
+                if (r == l_true) {
+                    save_cex();
+                    return l_false;
+                }
+                if (r == l_undef)
+                    return l_undef;
+                std::swap(x, y);
+            }
+            return l_true;
+        }
+
+        // return true if some candidate was refuted.
+        bool sweep() {
+            u_map<unsigned> hash2first;
+            unsigned_vector next;
+            next.resize(m_nodes.size(), UINT_MAX);
+            bool refuted = false;
+            for (unsigned i = 0; i < m_nodes.size(); i++) {
+                m.checkpoint();
+                unsigned h = sig_hash(i);
+                unsigned j = UINT_MAX;
+                if (!hash2first.find(h, j)) {
+                    hash2first.insert(h, i);
+                    continue;
+                }
+                // find the first node with the same signature.
+                while (j != UINT_MAX && !same_sig(i, j))
+                    j = next[j];
+                if (j == UINT_MAX) {
+                    unsigned first = UINT_MAX;
+                    hash2first.find(h, first);
+                    next[i] = first;
+                    hash2first.insert(h, i);
+                    continue;
+                }
+                if (!m_repr[i].is_null() || m_undecided[i] || is_var(m_nodes[i]))
+                    continue;
+                aig_lit r(m_nodes[j]);
+                if (phase(i) != phase(j))
+                    r.invert();
+                switch (check(sat::literal(m_node2var[i], false), to_lit(r))) {
+                case l_true: 
+                    m_stats.m_num_merged++;
+                    m_repr[i] = r;
+                    // the equivalence is valid, and helps the next checks.
+                    m_solver.mk_clause(sat::literal(m_node2var[i], true), to_lit(r));
+                    m_solver.mk_clause(sat::literal(m_node2var[i], false), ~to_lit(r));
+                    break;
+                case l_false:
+                    m_stats.m_num_refuted++;
+                    refuted = true;
+                    break;
+                default:
+                    // the node is not checked again, the remaining candidates are still checked.
+                    m_stats.m_num_undef++;
+                    m_undecided[i] = true;
+                    break;
+                }
+            }
+            return refuted;
+        }
+
+        aig_lit translate(svector<aig_lit> const & new_nodes, aig_lit const & l) const {
+            aig_lit r = new_nodes[idx(l.ptr())];
+            if (l.is_inverted())
+                r.invert();
+            return r;
+        }
+
+        aig_lit rebuild(aig_lit const & root) {
+            svector<aig_lit> new_nodes;
+            for (unsigned i = 0; i < m_nodes.size(); i++) {
+                aig * n = m_nodes[i];
+                aig_lit r;
+                if (!m_repr[i].is_null())
+                    r = translate(new_nodes, m_repr[i]);
+                else if (is_var(n))
+                    r = aig_lit(n);
+                else
+                    r = m.mk_node(translate(new_nodes, left(n)), translate(new_nodes, right(n)));
+                m.inc_ref(r);
+                new_nodes.push_back(r);
+            }
+            aig_lit r = translate(new_nodes, root);
+            m.inc_ref(r);
+            for (unsigned i = 0; i < new_nodes.size(); i++)
+                m.dec_ref(new_nodes[i]);
+            m.dec_ref_result(r);
+            return r;
+        }
+
+        aig_lit operator()(aig_lit const & root) {
+            if (is_var(root))
+                return root;
+            collect(root.ptr());
+            for (unsigned i = 0; i < c_num_random_words; i++)
+                add_word(random_pattern(*this));
+            encode();
+            for (unsigned round = 0; round < c_max_rounds; round++) {
+                m_stats.m_num_rounds++;
+                simulate();
+                if (!sweep())
+                    break;
+                flush_cex();
+            }
+            return rebuild(root);
+        }
+    };
+
+    aig_lit fraig(aig_lit l, unsigned max_conflicts, aig_fraig_stats & st) {
+        fraig_proc p(*this, max_conflicts, st);
+        return p(l);
+    }
+
     void display_ref(std::ostream & out, aig * r) const {
         if (is_var(r)) 
             out << "#" << r->m_id;
@@ -1729,6 +2058,18 @@ void aig_manager::max_sharing(aig_ref & r) {
     r = aig_ref(*this, m_imp->max_sharing(aig_lit(r)));
 }
 
+void aig_manager::fraig(aig_ref & r, unsigned max_conflicts, aig_fraig_stats & st) {
+    r = aig_ref(*this, m_imp->fraig(aig_lit(r), max_conflicts, st));
+}
+
+void aig_fraig_stats::collect_statistics(statistics & st) const {
+    st.update("fraig rounds", m_num_rounds);
+    st.update("fraig sat calls", m_num_sat_calls);
+    st.update("fraig merged", m_num_merged);
+    st.update("fraig refuted", m_num_refuted);
+    st.update("fraig undecided", m_num_undef);
+}
+
 void aig_manager::to_formula(aig_ref const & r, goal & g) {
     SASSERT(!g.proofs_enabled());
     SASSERT(!g.unsat_core_enabled());
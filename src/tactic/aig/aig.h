@@ -21,6 +21,7 @@ Notes:
 
 #include"ast.h"
 #include"tactic_exception.h"
+#include"statistics.h"
 
 class goal;
 class aig_lit;
@@ -45,6 +46,17 @@ public:
     bool operator!=(aig_ref const & r) const { return m_ref != r.m_ref; }
 };
 
+struct aig_fraig_stats {
+    unsigned m_num_rounds;
+    unsigned m_num_sat_calls;
+    unsigned m_num_merged;
+    unsigned m_num_refuted;
+    unsigned m_num_undef;
+    aig_fraig_stats() { reset(); }
+    void reset() { memset(this, 0, sizeof(*this)); }
+    void collect_statistics(statistics & st) const;
+};
+
 class aig_manager {
     struct imp;
     imp *  m_imp;
@@ -68,6 +80,12 @@ public:
     aig_ref mk_iff(aig_ref const & r1, aig_ref const & r2);
     aig_ref mk_ite(aig_ref const & r1, aig_ref const & r2, aig_ref const & r3);
     void max_sharing(aig_ref & r);
+    /**
+       \brief Merge functionally equivalent nodes of \c r (SAT sweeping).
+       \c max_conflicts bounds the number of conflicts used by the SAT solver
+       to check each candidate equivalence.
+    */
+    void fraig(aig_ref & r, unsigned max_conflicts, aig_fraig_stats & st);
     void to_formula(aig_ref const & r, expr_ref & result);
     void to_formula(aig_ref const & r, goal & result);
     void display(std::ostream & out, aig_ref const & r) const;
@@ -25,6 +25,9 @@ class aig_tactic : public tactic {
     unsigned long long m_max_memory;
     bool               m_aig_gate_encoding;
     bool               m_aig_per_assertion;
+    bool               m_fraig;
+    unsigned           m_fraig_max_conflicts;
+    aig_fraig_stats    m_fraig_stats;
     aig_manager *      m_aig_manager;
 
     struct mk_aig_manager {
@@ -51,6 +54,8 @@ public:
         t->m_max_memory = m_max_memory;
         t->m_aig_gate_encoding = m_aig_gate_encoding;
         t->m_aig_per_assertion = m_aig_per_assertion;
+        t->m_fraig = m_fraig;
+        t->m_fraig_max_conflicts = m_fraig_max_conflicts;
         return t;
     }
 
@@ -58,11 +63,23 @@ public:
         m_max_memory        = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
         m_aig_gate_encoding = p.get_bool("aig_default_gate_encoding", true);
         m_aig_per_assertion = p.get_bool("aig_per_assertion", true); 
+        m_fraig             = p.get_bool("aig_fraig", false);
+        m_fraig_max_conflicts = p.get_uint("aig_fraig_max_conflicts", 1000);
     }
 
     virtual void collect_param_descrs(param_descrs & r) { 
         insert_max_memory(r);
         r.insert("aig_per_assertion", CPK_BOOL, "(default: true) process one assertion at a time.");
+        r.insert("aig_fraig", CPK_BOOL, "(default: false) merge functionally equivalent nodes using simulation and SAT (fraiging).");
+        r.insert("aig_fraig_max_conflicts", CPK_UINT, "(default: 1000) maximum number of conflicts used by fraiging to check each candidate equivalence.");
+    }
+
+    void simplify(aig_ref & r) {
+        m_aig_manager->max_sharing(r);
+        if (m_fraig) {
+            m_aig_manager->fraig(r, m_fraig_max_conflicts, m_fraig_stats);
+            m_aig_manager->max_sharing(r);
+        }
     }
 
     void operator()(goal_ref const & g) {
@@ -73,7 +90,7 @@ public:
         if (m_aig_per_assertion) {
             for (unsigned i = 0; i < g->size(); i++) {
                 aig_ref r = m_aig_manager->mk_aig(g->form(i));
-                m_aig_manager->max_sharing(r);
+                simplify(r);
                 expr_ref new_f(g->m());
                 m_aig_manager->to_formula(r, new_f);
                 expr_dependency * ed = g->dep(i);
@@ -84,7 +101,7 @@ public:
             fail_if_unsat_core_generation("aig", g);
             aig_ref r = m_aig_manager->mk_aig(*(g.get()));
             g->reset(); // save memory
-            m_aig_manager->max_sharing(r);
+            simplify(r);
             m_aig_manager->to_formula(r, *(g.get()));
         }
         SASSERT(g->is_well_sorted());
@@ -102,6 +119,14 @@ public:
         result.push_back(g.get());
     }
 
+    virtual void collect_statistics(statistics & st) const {
+        m_fraig_stats.collect_statistics(st);
+    }
+
+    virtual void reset_statistics() {
+        m_fraig_stats.reset();
+    }
+
     virtual void cleanup() {}
 
 };
@@ -109,3 +134,9 @@ public:
 tactic * mk_aig_tactic(params_ref const & p) {
     return clean(alloc(aig_tactic, p));
 }
+
+tactic * mk_fraig_tactic(params_ref const & p) {
+    params_ref fraig_p;
+    fraig_p.set_bool("aig_fraig", true);
+    return using_params(mk_aig_tactic(p), fraig_p);
+}
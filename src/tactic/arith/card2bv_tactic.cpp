@@ -48,6 +48,8 @@ public:
     }
 
     virtual void collect_param_descrs(param_descrs & r) {  
+        r.insert("keep_cardinality_constraints", CPK_BOOL, "(default: false) retain cardinality and pseudo-Boolean constraints with non-negative coefficients for a solver that handles them natively.");
+        r.insert("min_cardinality_size", CPK_UINT, "(default: 0) constraints with fewer arguments are compiled even when keep_cardinality_constraints is set.");
     }
 
     
@@ -267,6 +267,8 @@ void goal::update(unsigned i, expr * f, proof * pr, expr_dependency * d) {
     // SASSERT(proofs_enabled() == (pr != 0 && !m().is_undef_proof(pr)));
     if (m_inconsistent)
         return;
+    // Updates that do not change the i-th entry are skipped. Otherwise, the
+    // goal would stop sharing its formulas with copies produced by copy_to.
     if (proofs_enabled()) {
         expr_ref out_f(m());
         proof_ref out_pr(m());
@@ -275,7 +277,7 @@ void goal::update(unsigned i, expr * f, proof * pr, expr_dependency * d) {
             if (m().is_false(out_f)) {
                 push_back(out_f, out_pr, d);
             }
-            else {
+            else if (out_f != form(i) || out_pr != this->pr(i) || (unsat_core_enabled() && d != dep(i))) {
                 m().set(m_forms, i, out_f);
                 m().set(m_proofs, i, out_pr);
                 if (unsat_core_enabled())
@@ -290,7 +292,7 @@ void goal::update(unsigned i, expr * f, proof * pr, expr_dependency * d) {
             if (m().is_false(fr)) {
                 push_back(f, 0, d);
             }
-            else {
+            else if (fr != form(i) || (unsat_core_enabled() && d != dep(i))) {
                 m().set(m_forms, i, fr);
                 if (unsat_core_enabled())
                     m().set(m_dependencies, i, d);
@@ -677,6 +679,8 @@ bool goal::is_decided() const {
 bool is_equal(goal const & s1, goal const & s2) {
     if (s1.size() != s2.size())
         return false;
+    if (s1.shares_formulas(s2))
+        return true;
     unsigned num1 = 0; // num unique ASTs in s1
     unsigned num2 = 0; // num unique ASTs in s2
     expr_fast_mark1 visited1;
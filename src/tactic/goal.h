@@ -119,6 +119,12 @@ public:
 
     void update(unsigned i, expr * f, proof * pr = 0, expr_dependency * dep = 0);
 
+    /**
+       \brief Return true if this goal and \c g share the same version of the array of formulas.
+       Goals copied with copy_to share their formulas until one of them is updated.
+    */
+    bool shares_formulas(goal const & g) const { return m().same(m_forms, g.m_forms); }
+
     void get_formulas(ptr_vector<expr> & result);
     
     void elim_true();
@@ -31,8 +31,10 @@ Notes:
 #include"qfaufbv_tactic.h"
 #include"qfauflia_tactic.h"
 #include"qfufnra_tactic.h"
+#include"strategy_selector_tactic.h"
+#include"strategy_selector_params.hpp"
 
-tactic * mk_default_tactic(ast_manager & m, params_ref const & p) {
+tactic * mk_builtin_default_tactic(ast_manager & m, params_ref const & p) {
     tactic * st = using_params(and_then(mk_simplify_tactic(m),
                                         cond(mk_is_qfbv_probe(),  mk_qfbv_tactic(m),
                                         cond(mk_is_qfaufbv_probe(), mk_qfaufbv_tactic(m),                                        
@@ -50,3 +52,10 @@ tactic * mk_default_tactic(ast_manager & m, params_ref const & p) {
     return st;
 }
 
+
+tactic * mk_default_tactic(ast_manager & m, params_ref const & p) {
+    strategy_selector_params sp(p);
+    if (*sp.model())
+        return mk_strategy_selector_tactic(m, p);
+    return mk_builtin_default_tactic(m, p);
+}
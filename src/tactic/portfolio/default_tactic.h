@@ -25,6 +25,10 @@ class tactic;
 
 tactic * mk_default_tactic(ast_manager & m, params_ref const & p = params_ref());
 
+// Default strategy given by a fixed decision tree over probes. mk_default_tactic
+// uses it unless a trained model is given by selector.model.
+tactic * mk_builtin_default_tactic(ast_manager & m, params_ref const & p = params_ref());
+
 /*
 ADD_TACTIC("default", "default strategy used when no logic is specified.", "mk_default_tactic(m, p)")
 */
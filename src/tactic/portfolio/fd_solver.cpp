@@ -23,11 +23,18 @@ Notes:
 #include "enum2bv_solver.h"
 #include "pb2bv_solver.h"
 #include "bounded_int2bv_solver.h"
+#include "sat_params.hpp"
 
 solver * mk_fd_solver(ast_manager & m, params_ref const & p) {
     solver* s = mk_inc_sat_solver(m, p);
     s = mk_enum2bv_solver(m, p, s);
-    s = mk_pb2bv_solver(m, p, s);
+    // cardinality and pseudo-Boolean constraints are left to the SAT
+    // solver when it handles them natively.
+    sat_params sp(p);
+    params_ref pb_p(p);
+    pb_p.set_bool("keep_cardinality_constraints", sp.cardinality_solver());
+    pb_p.set_uint("min_cardinality_size", sp.cardinality_min_size());
+    s = mk_pb2bv_solver(m, pb_p, s);
     s = mk_bounded_int2bv_solver(m, p, s);
     return s;
 }
@@ -0,0 +1,36 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    qfbv_sls_portfolio_tactic.cpp
+
+Abstract:
+
+    Run stochastic local search for QF_BV next to the
+    systematic QF_BV strategy.
+
+Notes:
+
+    Each branch runs in its own thread on a copy of the goal
+    (see par_tactical). Local search can only establish
+    satisfiability, so its branch fails when it gives up
+    without a model; this leaves the systematic branch as the
+    only one that can finish. Whichever branch finishes first
+    cancels the other one.
+
+--*/
+#include"tactical.h"
+#include"qfbv_tactic.h"
+#include"sls_tactic.h"
+#include"qfbv_sls_portfolio_tactic.h"
+
+tactic * mk_qfbv_sls_portfolio_tactic(ast_manager & m, params_ref const & p) {
+    // The systematic strategy is the first branch, so that its
+    // exceptions are the ones reported when no branch succeeds.
+    tactic * st = par(mk_qfbv_tactic(m, p),
+                      and_then(mk_qfbv_sls_tactic(m, p),
+                               mk_fail_if_undecided_tactic()));
+    st->updt_params(p);
+    return st;
+}
@@ -0,0 +1,29 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    qfbv_sls_portfolio_tactic.h
+
+Abstract:
+
+    Run stochastic local search for QF_BV next to the
+    systematic QF_BV strategy.
+
+Notes:
+
+--*/
+#ifndef QFBV_SLS_PORTFOLIO_TACTIC_H_
+#define QFBV_SLS_PORTFOLIO_TACTIC_H_
+
+#include"params.h"
+class ast_manager;
+class tactic;
+
+tactic * mk_qfbv_sls_portfolio_tactic(ast_manager & m, params_ref const & p = params_ref());
+
+/*
+  ADD_TACTIC("qfbv-sls-portfolio", "run the qfbv strategy and stochastic local search (qfbv-sls) in parallel, and use the first one that solves the goal.", "mk_qfbv_sls_portfolio_tactic(m, p)")
+*/
+
+#endif
@@ -41,9 +41,16 @@ Notes:
 #include"fd_solver.h"
 #include"bv_rewriter.h"
 #include"solver2tactic.h"
+#include"strategy_selector_tactic.h"
+#include"strategy_selector_params.hpp"
 
 
 tactic * mk_tactic_for_logic(ast_manager & m, params_ref const & p, symbol const & logic) {
+    // a decision model replaces the strategies of the SMT logics, but
+    // not the engines used for HORN and QF_FD.
+    strategy_selector_params sp(p);
+    if (*sp.model() && logic != "HORN" && logic != "QF_FD")
+        return mk_strategy_selector_tactic(m, p);
     if (logic=="QF_UF")
         return mk_qfuf_tactic(m, p);
     else if (logic=="QF_BV")
@@ -0,0 +1,376 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    strategy_selector_tactic.cpp
+
+Abstract:
+
+    Select the strategy for a goal using a decision tree over
+    features of the goal. The decision tree is trained offline
+    on local benchmark runs.
+
+Notes:
+
+    The features of a goal are the values of a fixed set of
+    probes followed by the entries of static_features.
+
+    The decision model is a text file with one entry per line.
+    Everything after '#' is a comment.
+
+        node <id> <feature> <threshold> <id-if-le> <id-if-gt>
+        leaf <id> <strategy>
+
+    Ids are 0, 1, ..., n-1, where n is the number of entries, and
+    0 is the root. The children of a node must have larger ids than
+    the node itself, so every model is a finite DAG. Strategies are
+    names of the tactics in g_strategies.
+    scripts/train_strategy_selector.py produces models in this
+    format. The model is loaded when the tactic is created, so a
+    malformed model is reported as an error by the command that
+    creates the solver or the tactic.
+
+--*/
+#include<fstream>
+#include<sstream>
+#include<iomanip>
+#include"tactical.h"
+#include"simplify_tactic.h"
+#include"static_features.h"
+#include"probe_arith.h"
+#include"smt_tactic.h"
+#include"default_tactic.h"
+#include"qfbv_tactic.h"
+#include"qfaufbv_tactic.h"
+#include"qfufbv_tactic.h"
+#include"qfidl_tactic.h"
+#include"qflia_tactic.h"
+#include"qfauflia_tactic.h"
+#include"qflra_tactic.h"
+#include"qfnia_tactic.h"
+#include"qfnra_tactic.h"
+#include"qfuf_tactic.h"
+#include"nra_tactic.h"
+#include"quant_tactics.h"
+#include"qffp_tactic.h"
+#include"qfbv_sls_portfolio_tactic.h"
+#include"strategy_selector_tactic.h"
+#include"strategy_selector_params.hpp"
+
+static tactic * mk_smt_strategy(ast_manager & m, params_ref const & p) {
+    return mk_smt_tactic(p);
+}
+
+struct strategy {
+    char const * m_name;
+    tactic * (*m_mk)(ast_manager & m, params_ref const & p);
+};
+
+/**
+   \brief Strategies the decision model can select. The names are the names of the
+   corresponding tactics, so the training harness can run them with check-sat-using.
+*/
+static strategy g_strategies[] = {
+    { "default",            mk_builtin_default_tactic },
+    { "smt",                mk_smt_strategy },
+    { "qfbv",               mk_qfbv_tactic },
+    { "qfaufbv",            mk_qfaufbv_tactic },
+    { "qfufbv",             mk_qfufbv_tactic },
+    { "qfbv-sls-portfolio", mk_qfbv_sls_portfolio_tactic },
+    { "qfidl",              mk_qfidl_tactic },
+    { "qflia",              mk_qflia_tactic },
+    { "qfauflia",           mk_qfauflia_tactic },
+    { "qflra",              mk_qflra_tactic },
+    { "qfnia",              mk_qfnia_tactic },
+    { "qfnra",              mk_qfnra_tactic },
+    { "qfuf",               mk_qfuf_tactic },
+    { "nra",                mk_nra_tactic },
+    { "lra",                mk_lra_tactic },
+    { "lia",                mk_lia_tactic },
+    { "lira",               mk_lira_tactic },
+    { "ufnia",              mk_ufnia_tactic },
+    { "qffp",               mk_qffp_tactic },
+};
+
+static const unsigned g_num_strategies = sizeof(g_strategies) / sizeof(strategy);
+
+class strategy_selector_tactic : public tactic {
+    enum node_kind { UNDEF, NODE, LEAF };
+
+    struct node {
+        node_kind m_kind;
+        unsigned  m_feature;
+        double    m_threshold;
+        unsigned  m_le;       // successor when feature <= threshold
+        unsigned  m_gt;       // successor when feature > threshold
+        unsigned  m_strategy;
+        node():m_kind(UNDEF), m_feature(0), m_threshold(0.0), m_le(0), m_gt(0), m_strategy(0) {}
+    };
+
+    ast_manager &            m;
+    params_ref               m_params;
+    std::string              m_model_file;
+    bool                     m_features_only;
+    svector<node>            m_nodes;
+    svector<char const *>    m_probe_names;
+    sref_vector<probe>       m_probes;
+    sref_vector<tactic>      m_tactics;      // strategy index -> tactic, created on demand
+    unsigned_vector          m_num_selected; // strategy index -> number of goals
+    vector<double>           m_features;
+
+    void add_probe(char const * name, probe * p) {
+        m_probe_names.push_back(name);
+        m_probes.push_back(p);
+    }
+
+    unsigned num_features() const {
+        return m_probe_names.size() + static_features::get_num_features();
+    }
+
+    char const * get_feature_name(unsigned i) const {
+        if (i < m_probe_names.size())
+            return m_probe_names[i];
+        return static_features::get_feature_name(i - m_probe_names.size());
+    }
+
+    bool find_feature(std::string const & name, unsigned & idx) const {
+        for (idx = 0; idx < num_features(); ++idx)
+            if (name == get_feature_name(idx))
+                return true;
+        return false;
+    }
+
+    static bool find_strategy(std::string const & name, unsigned & idx) {
+        for (idx = 0; idx < g_num_strategies; ++idx)
+            if (name == g_strategies[idx].m_name)
+                return true;
+        return false;
+    }
+
+    void throw_model_error(unsigned line, char const * msg) {
+        std::ostringstream strm;
+        strm << "invalid strategy selector model '" << m_model_file << "'";
+        if (line > 0)
+            strm << ", line " << line;
+        strm << ": " << msg;
+        m_nodes.reset();
+        throw default_exception(strm.str());
+    }
+
+    void load_model() {
+        m_nodes.reset();
+        if (m_model_file.empty())
+            return;
+        std::ifstream in(m_model_file.c_str());
+        if (in.bad() || in.fail())
+            throw default_exception(std::string("could not open strategy selector model '") + m_model_file + "'");
+        // the ids are checked once the number of entries is known.
+        svector<node>   entries;
+        unsigned_vector ids;
+        unsigned_vector line_nos;
+        std::string line;
+        unsigned line_no = 0;
+        while (std::getline(in, line)) {
+            ++line_no;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos)
+                line.erase(comment);
+            std::istringstream strm(line);
+            std::string kind, name, extra;
+            unsigned id;
+            node n;
+            if (!(strm >> kind))
+                continue;
+            if (kind == "node") {
+                n.m_kind = NODE;
+                if (!(strm >> id >> name >> n.m_threshold >> n.m_le >> n.m_gt))
+                    throw_model_error(line_no, "expected 'node <id> <feature> <threshold> <id-if-le> <id-if-gt>'");
+                if (!find_feature(name, n.m_feature))
+                    throw_model_error(line_no, "unknown feature");
+                if (n.m_le <= id || n.m_gt <= id)
+                    throw_model_error(line_no, "successors must have larger ids");
+            }
+            else if (kind == "leaf") {
+                n.m_kind = LEAF;
+                if (!(strm >> id >> name))
+                    throw_model_error(line_no, "expected 'leaf <id> <strategy>'");
+                if (!find_strategy(name, n.m_strategy))
+                    throw_model_error(line_no, "unknown strategy");
+            }
+            else {
+                throw_model_error(line_no, "expected 'node' or 'leaf'");
+            }
+            if (strm >> extra)
+                throw_model_error(line_no, "unexpected text at end of line");
+            entries.push_back(n);
+            ids.push_back(id);
+            line_nos.push_back(line_no);
+        }
+        unsigned num_nodes = entries.size();
+        if (num_nodes == 0)
+            throw_model_error(0, "model is empty");
+        m_nodes.resize(num_nodes, node());
+        for (unsigned i = 0; i < num_nodes; ++i) {
+            node const & n = entries[i];
+            if (ids[i] >= num_nodes)
+                throw_model_error(line_nos[i], "id is not smaller than the number of entries");
+            if (n.m_kind == NODE && (n.m_le >= num_nodes || n.m_gt >= num_nodes))
+                throw_model_error(line_nos[i], "successor id is not smaller than the number of entries");
+            if (m_nodes[ids[i]].m_kind != UNDEF)
+                throw_model_error(line_nos[i], "duplicate id");
+            m_nodes[ids[i]] = n;
+        }
+    }
+
+    void compute_features(goal & g) {
+        m_features.reset();
+        for (unsigned i = 0; i < m_probes.size(); ++i)
+            m_features.push_back((*m_probes.get(i))(g).get_value());
+        ptr_vector<expr> fmls;
+        g.get_formulas(fmls);
+        static_features sf(m);
+        sf.collect(fmls.size(), fmls.c_ptr());
+        vector<double> sfs;
+        sf.get_feature_vector(sfs);
+        m_features.append(sfs);
+        SASSERT(m_features.size() == num_features());
+    }
+
+    void display_features(std::ostream & out) const {
+        // the features are training data, so they are printed at full
+        // precision, independently of the settings of out.
+        std::ostringstream strm;
+        strm << std::setprecision(17) << "(selector-features";
+        for (unsigned i = 0; i < m_features.size(); ++i)
+            strm << " :" << get_feature_name(i) << " " << m_features[i];
+        strm << ")\n";
+        out << strm.str();
+    }
+
+    unsigned select() const {
+        if (m_nodes.empty())
+            return 0;
+        unsigned i = 0;
+        while (m_nodes[i].m_kind == NODE) {
+            node const & n = m_nodes[i];
+            i = m_features[n.m_feature] <= n.m_threshold ? n.m_le : n.m_gt;
+        }
+        SASSERT(m_nodes[i].m_kind == LEAF);
+        return m_nodes[i].m_strategy;
+    }
+
+    tactic * get_tactic(unsigned s) {
+        if (!m_tactics.get(s)) {
+            tactic * t = g_strategies[s].m_mk(m, m_params);
+            t->updt_params(m_params);
+            m_tactics.set(s, t);
+        }
+        return m_tactics.get(s);
+    }
+
+public:
+    // the parameters are set by updt_params, which loads the model
+    // and may throw.
+    strategy_selector_tactic(ast_manager & m):
+        m(m),
+        m_features_only(false) {
+        add_probe("size",             mk_size_probe());
+        add_probe("num_consts",       mk_num_consts_probe());
+        add_probe("num_bool_consts",  mk_num_bool_consts_probe());
+        add_probe("num_arith_consts", mk_num_arith_consts_probe());
+        add_probe("num_bv_consts",    mk_num_bv_consts_probe());
+        add_probe("arith_max_deg",    mk_arith_max_degree_probe());
+        add_probe("arith_avg_deg",    mk_arith_avg_degree_probe());
+        add_probe("arith_max_bw",     mk_arith_max_bw_probe());
+        add_probe("arith_avg_bw",     mk_arith_avg_bw_probe());
+        add_probe("is_propositional", mk_is_propositional_probe());
+        add_probe("is_qfbv",          mk_is_qfbv_probe());
+        add_probe("is_qfaufbv",       mk_is_qfaufbv_probe());
+        add_probe("is_qflia",         mk_is_qflia_probe());
+        add_probe("is_qfauflia",      mk_is_qfauflia_probe());
+        add_probe("is_qflra",         mk_is_qflra_probe());
+        add_probe("is_qfnia",         mk_is_qfnia_probe());
+        add_probe("is_qfnra",         mk_is_qfnra_probe());
+        add_probe("is_nra",           mk_is_nra_probe());
+        add_probe("is_lira",          mk_is_lira_probe());
+        for (unsigned i = 0; i < g_num_strategies; ++i) {
+            m_tactics.push_back(0);
+            m_num_selected.push_back(0);
+        }
+    }
+
+    virtual tactic * translate(ast_manager & m) {
+        strategy_selector_tactic * t = alloc(strategy_selector_tactic, m);
+        t->updt_params(m_params);
+        return t;
+    }
+
+    virtual void updt_params(params_ref const & p) {
+        m_params = p;
+        strategy_selector_params sp(p);
+        m_features_only = sp.features_only();
+        std::string model_file = sp.model();
+        if (model_file != m_model_file) {
+            m_model_file = model_file;
+            load_model();
+        }
+        for (unsigned i = 0; i < m_tactics.size(); ++i)
+            if (m_tactics.get(i))
+                m_tactics.get(i)->updt_params(p);
+    }
+
+    virtual void collect_param_descrs(param_descrs & r) {
+        strategy_selector_params::collect_param_descrs(r);
+    }
+
+    virtual void operator()(goal_ref const & in,
+                            goal_ref_buffer & result,
+                            model_converter_ref & mc,
+                            proof_converter_ref & pc,
+                            expr_dependency_ref & core) {
+        compute_features(*(in.get()));
+        if (m_features_only) {
+            display_features(verbose_stream());
+            mc = 0; pc = 0; core = 0;
+            result.push_back(in.get());
+            return;
+        }
+        unsigned s = select();
+        IF_VERBOSE(10, verbose_stream() << "(select-strategy " << g_strategies[s].m_name << ")\n";
+                   display_features(verbose_stream()););
+        m_num_selected[s]++;
+        (*get_tactic(s))(in, result, mc, pc, core);
+    }
+
+    virtual void cleanup() {
+        for (unsigned i = 0; i < m_tactics.size(); ++i)
+            if (m_tactics.get(i))
+                m_tactics.get(i)->cleanup();
+    }
+
+    virtual void collect_statistics(statistics & st) const {
+        for (unsigned i = 0; i < m_tactics.size(); ++i) {
+            if (m_tactics.get(i))
+                m_tactics.get(i)->collect_statistics(st);
+            if (m_num_selected[i] > 0) {
+                std::string key = std::string("selected ") + g_strategies[i].m_name;
+                st.update(symbol(key.c_str()).bare_str(), m_num_selected[i]);
+            }
+        }
+    }
+
+    virtual void reset_statistics() {
+        for (unsigned i = 0; i < m_tactics.size(); ++i) {
+            if (m_tactics.get(i))
+                m_tactics.get(i)->reset_statistics();
+            m_num_selected[i] = 0;
+        }
+    }
+};
+
+tactic * mk_strategy_selector_tactic(ast_manager & m, params_ref const & p) {
+    tactic_ref t = alloc(strategy_selector_tactic, m);
+    t->updt_params(p);
+    return and_then(mk_simplify_tactic(m, p), t.get());
+}
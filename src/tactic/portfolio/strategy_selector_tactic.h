@@ -0,0 +1,30 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    strategy_selector_tactic.h
+
+Abstract:
+
+    Select the strategy for a goal using a decision tree over
+    features of the goal. The decision tree is trained offline
+    on local benchmark runs.
+
+Notes:
+
+--*/
+#ifndef STRATEGY_SELECTOR_TACTIC_H_
+#define STRATEGY_SELECTOR_TACTIC_H_
+
+#include"params.h"
+class ast_manager;
+class tactic;
+
+tactic * mk_strategy_selector_tactic(ast_manager & m, params_ref const & p = params_ref());
+
+/*
+  ADD_TACTIC("select-strategy", "select a strategy using the decision model given by selector.model, and use the default strategy if there is no model.", "mk_strategy_selector_tactic(m, p)")
+*/
+
+#endif
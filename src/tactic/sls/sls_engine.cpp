@@ -91,6 +91,7 @@ void sls_engine::collect_statistics(statistics& st) const {
     st.update("sls INV moves", m_stats.m_invs);
     st.update("sls moves", m_stats.m_moves);
     st.update("sls moves/sec", m_stats.m_moves / seconds);
+    st.update("sls word evals", m_evaluator.get_num_word_evals());
 }
 
 void sls_engine::checkpoint() {
@@ -154,6 +155,12 @@ double sls_engine::incremental_score(func_decl * fd, const mpz & new_value) {
     return m_tracker.get_top_sum();
 }
 
+double sls_engine::incremental_score(func_decl * fd, uint64 new_value) {
+    m_evaluator.update(fd, new_value);
+    m_stats.m_incr_evals++;
+    return m_tracker.get_top_sum();
+}
+
 double sls_engine::incremental_score_prune(func_decl * fd, const mpz & new_value) {
     m_stats.m_incr_evals++;
     if (m_evaluator.update_prune(fd, new_value))
@@ -162,6 +169,14 @@ double sls_engine::incremental_score_prune(func_decl * fd, const mpz & new_value
         return -DBL_MAX;
 }
 
+double sls_engine::incremental_score_prune(func_decl * fd, uint64 new_value) {
+    m_stats.m_incr_evals++;
+    if (m_evaluator.update_prune(fd, new_value))
+        return m_tracker.get_top_sum();
+    else
+        return -DBL_MAX;
+}
+
 // checks whether the score outcome of a given move is better than the previous score
 bool sls_engine::what_if(
     func_decl * fd, 
@@ -202,6 +217,31 @@ bool sls_engine::what_if(
     return false;
 }
 
+// what_if for a constant whose value is stored as a machine word.
+bool sls_engine::what_if(
+    func_decl * fd, 
+    const unsigned & fd_inx, 
+    uint64 temp,
+    double & best_score, 
+    unsigned & best_const, 
+    mpz & best_value) {
+
+    double r;
+    if (m_early_prune)
+        r = incremental_score_prune(fd, temp);
+    else
+        r = incremental_score(fd, temp);
+
+    if (r > best_score) {
+        best_score = r;
+        best_const = fd_inx;
+        m_mpz_manager.set(best_value, temp);
+        return true;
+    }
+
+    return false;
+}
+
 void sls_engine::mk_add(unsigned bv_sz, const mpz & old_value, mpz & add_value, mpz & result) {
     mpz temp, mask, mask2;
     m_mpz_manager.add(old_value, add_value, temp);
@@ -339,6 +379,33 @@ double sls_engine::find_best_move(
         func_decl * fd = to_evaluate[i];
         sort * srt = fd->get_range();
         bv_sz = (m_manager.is_bool(srt)) ? 1 : m_bv_util.get_bv_size(srt);
+
+        if (m_tracker.is_word(fd)) {
+            // the same moves as below, on machine words.
+            uint64 old_word = m_tracker.get_word(fd);
+            uint64 mask = bv_sz == 64 ? ~static_cast<uint64>(0) : (static_cast<uint64>(1) << bv_sz) - 1;
+            for (unsigned j = 0; j < bv_sz; j++) {
+                if (what_if(fd, i, old_word ^ (static_cast<uint64>(1) << j), new_score, best_const, best_value)) {
+                    new_bit = j;
+                    move = MV_FLIP;
+                }
+            }
+            if (m_bv_util.is_bv_sort(srt) && bv_sz > 1) {
+                if ((old_word & 1) != 0) {
+                    if (what_if(fd, i, (old_word + 1) & mask, new_score, best_const, best_value))
+                        move = MV_INC;
+                }
+                else {
+                    if (what_if(fd, i, (old_word - 1) & mask, new_score, best_const, best_value))
+                        move = MV_DEC;
+                }
+                if (what_if(fd, i, ~old_word & mask, new_score, best_const, best_value))
+                    move = MV_INV;
+            }
+            incremental_score(fd, old_word);
+            continue;
+        }
+
         m_mpz_manager.set(old_value, m_tracker.get_value(fd));
 
         // first try to flip every bit
@@ -397,6 +464,25 @@ double sls_engine::find_best_move_mc(ptr_vector<func_decl> & to_evaluate, double
         func_decl * fd = to_evaluate[i];
         sort * srt = fd->get_range();
         bv_sz = (m_manager.is_bool(srt)) ? 1 : m_bv_util.get_bv_size(srt);
+
+        if (m_tracker.is_word(fd)) {
+            uint64 old_word = m_tracker.get_word(fd);
+            if (m_bv_util.is_bv_sort(srt) && bv_sz > 2) {
+                for (unsigned j = 0; j < bv_sz; j++) {
+                    uint64 flipped = old_word ^ (static_cast<uint64>(1) << j);
+                    for (unsigned l = 0; l < m_vns_mc && l < bv_sz / 2; l++)
+                    {
+                        unsigned k = m_tracker.get_random_uint(16) % bv_sz;
+                        while (k == j)
+                            k = m_tracker.get_random_uint(16) % bv_sz;
+                        what_if(fd, i, flipped ^ (static_cast<uint64>(1) << k), new_score, best_const, best_value);
+                    }
+                }
+            }
+            incremental_score(fd, old_word);
+            continue;
+        }
+
         m_mpz_manager.set(old_value, m_tracker.get_value(fd));
 
         if (m_bv_util.is_bv_sort(srt) && bv_sz > 2) {
@@ -510,13 +596,13 @@ lbool sls_engine::search() {
                     // smooth weights with probability sp / 1024
                     if (m_tracker.get_random_uint(10) < m_paws_sp)
                     {
-                        if (m_mpz_manager.eq(m_tracker.get_value(q),m_one))
+                        if (m_tracker.is_true(q))
                             m_tracker.decrease_weight(q);
                     }
                     // increase weights otherwise
                     else
                     {
-                        if (m_mpz_manager.eq(m_tracker.get_value(q),m_zero))
+                        if (!m_tracker.is_true(q))
                             m_tracker.increase_weight(q);
                     }
                 }
@@ -99,7 +99,7 @@ public:
 
     // stats const & get_stats(void) { return m_stats; }
     void collect_statistics(statistics & st) const;
-    void reset_statistics(void) { m_stats.reset(); }    
+    void reset_statistics(void) { m_stats.reset(); m_evaluator.reset_statistics(); }    
 
     bool full_eval(model & mdl);
 
@@ -119,13 +119,17 @@ protected:
 
     bool what_if(func_decl * fd, const unsigned & fd_inx, const mpz & temp,
                  double & best_score, unsigned & best_const, mpz & best_value);
+    bool what_if(func_decl * fd, const unsigned & fd_inx, uint64 temp,
+                 double & best_score, unsigned & best_const, mpz & best_value);
 
     double top_score();
     double rescore();
     double serious_score(func_decl * fd, const mpz & new_value);
     double incremental_score(func_decl * fd, const mpz & new_value);
+    double incremental_score(func_decl * fd, uint64 new_value);
 
     double incremental_score_prune(func_decl * fd, const mpz & new_value);
+    double incremental_score_prune(func_decl * fd, uint64 new_value);
     double find_best_move(ptr_vector<func_decl> & to_evaluate, double score,
                           unsigned & best_const, mpz & best_value, unsigned & new_bit, move_type & move);
 
@@ -37,6 +37,216 @@ class sls_evaluator {
     expr_ref_buffer       m_temp_exprs;
     vector<ptr_vector<expr> > m_traversal_stack;
     vector<ptr_vector<expr> > m_traversal_stack_bool;
+    unsigned              m_num_word_evals;
+
+    static uint64 word_mask(unsigned bv_sz) {
+        SASSERT(0 < bv_sz && bv_sz <= 64);
+        return bv_sz == 64 ? ~static_cast<uint64>(0) : (static_cast<uint64>(1) << bv_sz) - 1;
+    }
+
+    static int64 word_to_signed(unsigned bv_sz, uint64 v) {
+        if (bv_sz < 64 && (v >> (bv_sz - 1)) != 0)
+            v |= ~word_mask(bv_sz);
+        return static_cast<int64>(v);
+    }
+
+    uint64 word_value(expr * e) {
+        return m_tracker.get_word(e);
+    }
+
+    /**
+       \brief Evaluate n on the machine words of its arguments, see sls_tracker::is_word.
+       Return false if an argument is not stored as a word, or if the operation is not
+       handled by the word evaluator.
+    */
+    bool eval_word(app * n, uint64 & r) {
+        unsigned n_args = n->get_num_args();
+        expr * const * args = n->get_args();
+        for (unsigned i = 0; i < n_args; i++) {
+            if (!m_tracker.is_word(args[i]))
+                return false;
+        }
+
+        r = 0;
+        if (n->get_family_id() == m_basic_fid) {
+            switch (n->get_decl_kind()) {
+            case OP_AND:
+                r = 1;
+                for (unsigned i = 0; i < n_args && r == 1; i++)
+                    r = word_value(args[i]);
+                break;
+            case OP_OR:
+                for (unsigned i = 0; i < n_args && r == 0; i++)
+                    r = word_value(args[i]);
+                break;
+            case OP_NOT:
+                r = word_value(args[0]) ^ 1;
+                break;
+            case OP_EQ:
+            case OP_IFF:
+                r = 1;
+                for (unsigned i = 1; i < n_args && r == 1; i++)
+                    r = word_value(args[i]) == word_value(args[0]);
+                break;
+            case OP_ITE:
+                r = word_value(args[0]) == 1 ? word_value(args[1]) : word_value(args[2]);
+                break;
+            default:
+                return false;
+            }
+            m_num_word_evals++;
+            return true;
+        }
+        if (n->get_family_id() != m_bv_fid)
+            return false;
+
+        switch (n->get_decl_kind()) {
+        case OP_CONCAT:
+            for (unsigned i = 0; i < n_args; i++) {
+                if (i != 0)
+                    r <<= m_bv_util.get_bv_size(args[i]);
+                r |= word_value(args[i]);
+            }
+            break;
+        case OP_EXTRACT: {
+            unsigned h = m_bv_util.get_extract_high(n);
+            unsigned l = m_bv_util.get_extract_low(n);
+            r = (word_value(args[0]) >> l) & word_mask(h - l + 1);
+            break;
+        }
+        case OP_BADD:
+            for (unsigned i = 0; i < n_args; i++)
+                r += word_value(args[i]);
+            r &= word_mask(m_bv_util.get_bv_size(n));
+            break;
+        case OP_BSUB:
+            r = (word_value(args[0]) - word_value(args[1])) & word_mask(m_bv_util.get_bv_size(n));
+            break;
+        case OP_BMUL:
+            r = word_value(args[0]);
+            for (unsigned i = 1; i < n_args; i++)
+                r *= word_value(args[i]);
+            r &= word_mask(m_bv_util.get_bv_size(n));
+            break;
+        case OP_BNEG:
+            r = (0 - word_value(args[0])) & word_mask(m_bv_util.get_bv_size(n));
+            break;
+        case OP_BUDIV:
+        case OP_BUDIV0:
+        case OP_BUDIV_I: {
+            uint64 y = word_value(args[1]);
+            r = y == 0 ? word_mask(m_bv_util.get_bv_size(n)) : word_value(args[0]) / y;
+            break;
+        }
+        case OP_BUREM:
+        case OP_BUREM0:
+        case OP_BUREM_I: {
+            uint64 y = word_value(args[1]);
+            r = y == 0 ? word_value(args[0]) : word_value(args[0]) % y;
+            break;
+        }
+        case OP_BAND:
+            r = word_value(args[0]);
+            for (unsigned i = 1; i < n_args; i++)
+                r &= word_value(args[i]);
+            break;
+        case OP_BOR:
+            r = word_value(args[0]);
+            for (unsigned i = 1; i < n_args; i++)
+                r |= word_value(args[i]);
+            break;
+        case OP_BXOR:
+            r = word_value(args[0]);
+            for (unsigned i = 1; i < n_args; i++)
+                r ^= word_value(args[i]);
+            break;
+        case OP_BNAND:
+        case OP_BNOR: {
+            uint64 mask = word_mask(m_bv_util.get_bv_size(n));
+            bool is_and = n->get_decl_kind() == OP_BNAND;
+            r = word_value(args[0]);
+            for (unsigned i = 1; i < n_args; i++)
+                r = ~(is_and ? (r & word_value(args[i])) : (r | word_value(args[i]))) & mask;
+            break;
+        }
+        case OP_BNOT:
+            r = ~word_value(args[0]) & word_mask(m_bv_util.get_bv_size(args[0]));
+            break;
+        case OP_ULT:
+        case OP_ULEQ:
+        case OP_UGT:
+        case OP_UGEQ: {
+            uint64 x = word_value(args[0]);
+            uint64 y = word_value(args[1]);
+            switch (n->get_decl_kind()) {
+            case OP_ULT:  r = x < y; break;
+            case OP_ULEQ: r = x <= y; break;
+            case OP_UGT:  r = x > y; break;
+            default:      r = x >= y; break;
+            }
+            break;
+        }
+        case OP_SLT:
+        case OP_SLEQ:
+        case OP_SGT:
+        case OP_SGEQ: {
+            unsigned bv_sz = m_bv_util.get_bv_size(args[0]);
+            int64 x = word_to_signed(bv_sz, word_value(args[0]));
+            int64 y = word_to_signed(bv_sz, word_value(args[1]));
+            switch (n->get_decl_kind()) {
+            case OP_SLT:  r = x < y; break;
+            case OP_SLEQ: r = x <= y; break;
+            case OP_SGT:  r = x > y; break;
+            default:      r = x >= y; break;
+            }
+            break;
+        }
+        case OP_BSHL: {
+            unsigned bv_sz = m_bv_util.get_bv_size(n);
+            uint64 shift = word_value(args[1]);
+            r = shift >= bv_sz ? 0 : (word_value(args[0]) << shift) & word_mask(bv_sz);
+            break;
+        }
+        case OP_BLSHR: {
+            unsigned bv_sz = m_bv_util.get_bv_size(n);
+            uint64 shift = word_value(args[1]);
+            r = shift >= bv_sz ? 0 : word_value(args[0]) >> shift;
+            break;
+        }
+        case OP_BASHR: {
+            unsigned bv_sz = m_bv_util.get_bv_size(n);
+            uint64 mask = word_mask(bv_sz);
+            uint64 x = word_value(args[0]);
+            uint64 shift = word_value(args[1]);
+            bool neg = (x >> (bv_sz - 1)) != 0;
+            if (shift >= bv_sz)
+                r = neg ? mask : 0;
+            else {
+                r = x >> shift;
+                if (neg)
+                    r |= mask & ~(mask >> shift);
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+        m_num_word_evals++;
+        return true;
+    }
+
+    // Evaluate n and store its value in the tracker.
+    void update_value(app * n, mpz & temp) {
+        if (m_tracker.is_word(n)) {
+            uint64 r;
+            if (eval_word(n, r)) {
+                m_tracker.set_word(n, r);
+                return;
+            }
+        }
+        (*this)(n, temp);
+        m_tracker.set_value(n, temp);
+    }
 
 public:
     sls_evaluator(ast_manager & m, bv_util & bvu, sls_tracker & t, unsynch_mpz_manager & mm, powers & p) : 
@@ -48,7 +258,8 @@ public:
         m_one(m_mpz_manager.mk_z(1)),
         m_two(m_mpz_manager.mk_z(2)),
         m_powers(p),
-        m_temp_exprs(m) {
+        m_temp_exprs(m),
+        m_num_word_evals(0) {
         m_bv_fid = m_bv_util.get_family_id();
         m_basic_fid = m_manager.get_basic_family_id();
     }
@@ -58,6 +269,9 @@ public:
         m_mpz_manager.del(m_one);
         m_mpz_manager.del(m_two);            
     }
+
+    unsigned get_num_word_evals() const { return m_num_word_evals; }
+    void reset_statistics() { m_num_word_evals = 0; }
     
     void operator()(app * n, mpz & result) {
         family_id nfid = n->get_family_id();
@@ -70,6 +284,12 @@ public:
         }
 
         expr * const * args = n->get_args(); 
+
+        uint64 r;
+        if (m_tracker.is_word(n) && eval_word(n, r)) {
+            m_mpz_manager.set(result, r);
+            return;
+        }
             
         m_mpz_manager.set(result, m_zero);
             
@@ -544,14 +764,13 @@ public:
             for (unsigned i = 0; i < cur_depth_exprs.size(); i++) {
                 expr * cur = cur_depth_exprs[i];
 
-                (*this)(to_app(cur), new_value);
-                m_tracker.set_value(cur, new_value);
+                update_value(to_app(cur), new_value);
 
                 new_score = m_tracker.score(cur);
                 if (m_tracker.is_top_expr(cur))
                 {
                     m_tracker.adapt_top_sum(cur, new_score, m_tracker.get_score(cur));
-                    if (m_mpz_manager.eq(new_value,m_one))
+                    if (m_tracker.is_true(cur))
                         m_tracker.make_assertion(cur);
                     else
                         m_tracker.break_assertion(cur);
@@ -595,8 +814,7 @@ public:
             for (unsigned i = 0; i < cur_depth_exprs.size(); i++) {
                 expr * cur = cur_depth_exprs[i];
 
-                (*this)(to_app(cur), new_value);
-                m_tracker.set_value(cur, new_value);
+                update_value(to_app(cur), new_value);
                 new_score = m_tracker.score(cur);
                 if (m_tracker.is_top_expr(cur))
                     m_tracker.adapt_top_sum(cur, new_score, m_tracker.get_score(cur));
@@ -640,6 +858,16 @@ public:
 
     void update(func_decl * fd, const mpz & new_value) {
         m_tracker.set_value(fd, new_value);
+        update(fd);
+    }
+
+    void update(func_decl * fd, uint64 new_value) {
+        m_tracker.set_word(fd, new_value);
+        update(fd);
+    }
+
+    // Propagate the value of fd, which is already set in the tracker.
+    void update(func_decl * fd) {
         expr * ep = m_tracker.get_entry_point(fd);
         unsigned cur_depth = m_tracker.get_distance(ep);
         if (m_traversal_stack.size() <= cur_depth) 
@@ -651,6 +879,15 @@ public:
 
     void serious_update(func_decl * fd, const mpz & new_value) {
         m_tracker.set_value(fd, new_value);
+        serious_update(fd);
+    }
+
+    void serious_update(func_decl * fd, uint64 new_value) {
+        m_tracker.set_word(fd, new_value);
+        serious_update(fd);
+    }
+
+    void serious_update(func_decl * fd) {
         expr * ep = m_tracker.get_entry_point(fd);
         unsigned cur_depth = m_tracker.get_distance(ep);
         if (m_traversal_stack.size() <= cur_depth) 
@@ -748,8 +985,7 @@ public:
             for (unsigned i = 0; i < cur_depth_exprs.size(); i++) {
                 expr * cur = cur_depth_exprs[i];
 
-                (*this)(to_app(cur), new_value);
-                m_tracker.set_value(cur, new_value);
+                update_value(to_app(cur), new_value);
                 // Andreas: Should actually always have uplinks ...
                 if (m_tracker.has_uplinks(cur)) {
                     ptr_vector<expr> & ups = m_tracker.get_uplinks(cur);
@@ -777,6 +1013,15 @@ public:
 
     unsigned update_prune(func_decl * fd, const mpz & new_value) {
         m_tracker.set_value(fd, new_value);
+        return update_prune(fd);
+    }
+
+    unsigned update_prune(func_decl * fd, uint64 new_value) {
+        m_tracker.set_word(fd, new_value);
+        return update_prune(fd);
+    }
+
+    unsigned update_prune(func_decl * fd) {
         expr * ep = m_tracker.get_entry_point(fd);
         unsigned cur_depth = m_tracker.get_distance(ep);
 
@@ -799,11 +1044,13 @@ public:
         // Randomize _one_ candidate:
         unsigned r = m_tracker.get_random_uint(16) % unsat_constants.size();
         func_decl * fd = unsat_constants[r];
-        mpz temp = m_tracker.get_random(fd->get_range());
-
-        serious_update(fd, temp);
-
-        m_mpz_manager.del(temp);
+        if (m_tracker.is_word(fd))
+            serious_update(fd, m_tracker.get_random_word(fd->get_range()));
+        else {
+            mpz temp = m_tracker.get_random(fd->get_range());
+            serious_update(fd, temp);
+            m_mpz_manager.del(temp);
+        }
 
         TRACE("sls",    tout << "Randomization candidate: " << unsat_constants[r]->get_name() << std::endl;
                         tout << "Locally randomized model: " << std::endl; 
@@ -38,12 +38,17 @@ class sls_tracker {
     unsigned              m_random_bits;
     unsigned              m_random_bits_cnt;
     mpz                   m_zero, m_one, m_two;
+    bool                  m_word_values;
         
+    // Values of Booleans and of bit-vectors of at most 64 bits are stored in word
+    // when is_word is set, value is then only a copy that is updated by get_value.
     struct value_score { 
-    value_score() : m(0), value(unsynch_mpz_manager::mk_z(0)), score(0.0), score_prune(0.0), has_pos_occ(0), has_neg_occ(0), distance(0), touched(1) {};
+    value_score() : m(0), value(unsynch_mpz_manager::mk_z(0)), word(0), is_word(false), score(0.0), score_prune(0.0), has_pos_occ(0), has_neg_occ(0), distance(0), touched(1) {};
         ~value_score() { if (m) m->del(value); }
         unsynch_mpz_manager * m;
         mpz value;
+        uint64 word;
+        bool is_word;
         double score;
         double score_prune;
         unsigned has_pos_occ;
@@ -54,6 +59,8 @@ class sls_tracker {
             SASSERT(m == 0 || m == other.m);
             if (m) m->set(value, 0); else m = other.m;
             m->set(value, other.value);
+            word = other.word;
+            is_word = other.is_word;
             score = other.score;
             distance = other.distance;
             touched = other.touched;
@@ -101,7 +108,8 @@ public:
         m_random_bits_cnt(0),        
         m_zero(m_mpz_manager.mk_z(0)),
         m_one(m_mpz_manager.mk_z(1)),
-        m_two(m_mpz_manager.mk_z(2)) {
+        m_two(m_mpz_manager.mk_z(2)),
+        m_word_values(false) {
     }
             
     ~sls_tracker() {
@@ -123,6 +131,7 @@ public:
         // Andreas: track_unsat is currently disabled because I cannot guarantee that it is not buggy.
         // If you want to use it, you will also need to change comments in the assertion selection.
         m_track_unsat = 0;//p.track_unsat();
+        m_word_values = p.word_values();
     }
 
     /* Andreas: Tried to give some measure for the formula size by the following two methods but both are not used currently.
@@ -171,14 +180,20 @@ public:
         for (obj_hashtable<expr>::iterator it = m_top_expr.begin();
              it != m_top_expr.end();
              it++)
-            if (!m_mpz_manager.is_one(get_value(*it)))
+            if (!is_true(*it))
                 return false;
         return true;
     }
 
     inline void set_value(expr * n, const mpz & r) {
         SASSERT(m_scores.contains(n));
-        m_mpz_manager.set(m_scores.find(n).value, r);
+        value_score & vs = m_scores.find(n);
+        if (vs.is_word) {
+            SASSERT(m_mpz_manager.is_uint64(r));
+            vs.word = m_mpz_manager.get_uint64(r);
+        }
+        else
+            m_mpz_manager.set(vs.value, r);
     }
 
     inline void set_value(func_decl * fd, const mpz & r) {
@@ -187,15 +202,52 @@ public:
         set_value(ep, r);
     }
 
-    inline mpz & get_value(expr * n) {            
+    inline mpz const & get_value(expr * n) {            
         SASSERT(m_scores.contains(n));
-        return m_scores.find(n).value;
+        value_score & vs = m_scores.find(n);
+        if (vs.is_word)
+            m_mpz_manager.set(vs.value, vs.word);
+        return vs.value;
     }
 
-    inline mpz & get_value(func_decl * fd) {
+    inline mpz const & get_value(func_decl * fd) {
         SASSERT(m_entry_points.contains(fd));
         expr * ep = get_entry_point(fd);
         return get_value(ep);
+    }
+
+    // Return true if the value of n is stored as a machine word.
+    inline bool is_word(expr * n) {
+        SASSERT(m_scores.contains(n));
+        return m_scores.find(n).is_word;
+    }
+
+    inline bool is_word(func_decl * fd) {
+        return is_word(get_entry_point(fd));
+    }
+
+    inline uint64 get_word(expr * n) {
+        SASSERT(is_word(n));
+        return m_scores.find(n).word;
+    }
+
+    inline uint64 get_word(func_decl * fd) {
+        return get_word(get_entry_point(fd));
+    }
+
+    inline void set_word(expr * n, uint64 w) {
+        SASSERT(is_word(n));
+        m_scores.find(n).word = w;
+    }
+
+    inline void set_word(func_decl * fd, uint64 w) {
+        set_word(get_entry_point(fd), w);
+    }
+
+    inline bool is_true(expr * n) {
+        SASSERT(m_scores.contains(n));
+        value_score & vs = m_scores.find(n);
+        return vs.is_word ? vs.word == 1 : m_mpz_manager.is_one(vs.value);
     }        
 
     inline void set_score(expr * n, double score) {
@@ -294,6 +346,7 @@ public:
         if (!m_scores.contains(n)) {
             value_score vs;
             vs.m = & m_mpz_manager;
+            vs.is_word = m_word_values && (m_manager.is_bool(n) || (m_bv_util.is_bv(n) && m_bv_util.get_bv_size(n) <= 64));
             m_scores.insert(n, vs);
         }
 
@@ -591,6 +644,18 @@ public:
         return r;
     }
 
+    // Return the same value as get_random as a machine word.
+    uint64 get_random_word(sort * s) {
+        unsigned bv_size = m_manager.is_bool(s) ? 1 : m_bv_util.get_bv_size(s);
+        SASSERT(bv_size <= 64);
+        uint64 r = 0;
+        do
+        {
+            r = (r << 1) | (m_mpz_manager.is_one(get_random_bool()) ? 1 : 0);
+        } while (--bv_size > 0);
+        return r;
+    }
+
     mpz & get_random_bool() {
         if (m_random_bits_cnt == 0) {
             m_random_bits = m_rng();
@@ -641,6 +706,10 @@ public:
         for (entry_point_type::iterator it = m_entry_points.begin(); it != m_entry_points.end(); it++) {
             func_decl * fd = it->m_key;
             sort * s = fd->get_range();
+            if (is_word(it->m_value)) {
+                set_word(it->m_value, get_random_word(s));
+                continue;
+            }
             mpz temp = get_random(s);
             set_value(it->m_value, temp);
             m_mpz_manager.del(temp);
@@ -707,11 +776,10 @@ public:
         double res = 0.0;
             
         if (is_uninterp_const(n)) {
-            const mpz & r = get_value(n);
             if (negated)
-                res = (m_mpz_manager.is_one(r)) ? 0.0 : 1.0;
+                res = is_true(n) ? 0.0 : 1.0;
             else
-                res = (m_mpz_manager.is_one(r)) ? 1.0 : 0.0;
+                res = is_true(n) ? 1.0 : 0.0;
         }            
         else if (m_manager.is_and(n)) {
             SASSERT(!negated);
@@ -744,10 +812,25 @@ public:
             SASSERT(!negated);
             app * a = to_app(n);
             SASSERT(a->get_num_args() == 3);
-            const mpz & cond = get_value(a->get_arg(0));
             double s_t = get_score(a->get_arg(1));
             double s_f = get_score(a->get_arg(2));
-            res = (m_mpz_manager.is_one(cond)) ? s_t : s_f;
+            res = is_true(a->get_arg(0)) ? s_t : s_f;
+        }
+        else if ((m_manager.is_eq(n) || m_manager.is_iff(n)) && is_word(to_app(n)->get_arg(0))) {
+            app * a = to_app(n);
+            SASSERT(a->get_num_args() == 2);
+            expr * arg0 = a->get_arg(0);
+            uint64 v0 = get_word(arg0);
+            uint64 v1 = get_word(a->get_arg(1));
+            if (negated)
+                res = (v0 == v1) ? 0.0 : 1.0;
+            else if (m_manager.is_bool(arg0))
+                res = (v0 == v1) ? 1.0 : 0.0;
+            else {
+                uint64 diff = v0 ^ v1;
+                unsigned hamming_distance = get_num_1bits(static_cast<unsigned>(diff)) + get_num_1bits(static_cast<unsigned>(diff >> 32));
+                res = 1.0 - (hamming_distance / (double) m_bv_util.get_bv_size(arg0));
+            }
         }
         else if (m_manager.is_eq(n) || m_manager.is_iff(n)) {                
             app * a = to_app(n);
@@ -789,6 +872,27 @@ public:
             else
                 NOT_IMPLEMENTED_YET();
         }            
+        else if ((m_bv_util.is_bv_ule(n) || m_bv_util.is_bv_sle(n)) && is_word(to_app(n)->get_arg(0))) {
+            app * a = to_app(n);
+            SASSERT(a->get_num_args() == 2);
+            uint64 x = get_word(a->get_arg(0));
+            uint64 y = get_word(a->get_arg(1));
+            unsigned bv_sz = m_bv_util.get_bv_size(a->get_decl()->get_domain()[0]);
+            if (m_bv_util.is_bv_sle(n)) {
+                // flipping the sign bits maps the signed order to the unsigned one.
+                uint64 sign = static_cast<uint64>(1) << (bv_sz - 1);
+                x ^= sign;
+                y ^= sign;
+            }
+            // the distances are below 2^53 for widths of at most 53 bits, and then
+            // they are the same as the ones computed with mpz.
+            double p = ldexp(1.0, bv_sz);
+            if (negated)
+                res = (x > y) ? 1.0 : 1.0 - ((double)(y - x) + 1.0) / p;
+            else
+                res = (x <= y) ? 1.0 : 1.0 - (double)(x - y) / p;
+            res = (res < 0.0) ? 0.0 : (res > 1.0) ? 1.0 : res;
+        }
         else if (m_bv_util.is_bv_ule(n)) { // x <= y
             app * a = to_app(n);
             SASSERT(a->get_num_args() == 2);
@@ -975,7 +1079,7 @@ public:
     ptr_vector<func_decl> & get_unsat_constants_gsat(ptr_vector<expr> const & as) {
         unsigned sz = as.size();
         if (sz == 1) {
-            if (m_mpz_manager.neq(get_value(as[0]), m_one))
+            if (!is_true(as[0]))
                 return get_constants();
         }
 
@@ -983,7 +1087,7 @@ public:
 
         for (unsigned i = 0; i < sz; i++) {
             expr * q = as[i];
-            if (m_mpz_manager.eq(get_value(q), m_one))
+            if (is_true(q))
                 continue;
             ptr_vector<func_decl> const & this_decls = m_constants_occ.find(q);
             unsigned sz2 = this_decls.size();
@@ -1029,7 +1133,7 @@ public:
     expr * get_unsat_assertion(ptr_vector<expr> const & as) {
         unsigned sz = as.size();
         if (sz == 1) {
-            if (m_mpz_manager.neq(get_value(as[0]), m_one))
+            if (!is_true(as[0]))
                 return as[0];
             else
                 return 0;
@@ -1046,7 +1150,7 @@ public:
                 expr * e = m_list_false[i]; */
             for (unsigned i = 0; i < sz; i++) {
                 expr * e = as[i];
-                if (m_mpz_manager.neq(get_value(e), m_one))
+                if (!is_true(e))
                 {
                     vscore = m_scores.find(e);
                     // Andreas: Select the assertion with the greatest ucb score. Potentially add some noise.
@@ -1075,7 +1179,7 @@ public:
 
             unsigned cnt_unsat = 0;
             for (unsigned i = 0; i < sz; i++)
-                if (m_mpz_manager.neq(get_value(as[i]), m_one) && (get_random_uint(16) % ++cnt_unsat == 0)) pos = i;	
+                if (!is_true(as[i]) && (get_random_uint(16) % ++cnt_unsat == 0)) pos = i;	
             if (pos == static_cast<unsigned>(-1))
                 return 0;
         }
@@ -1092,7 +1196,7 @@ public:
         
         unsigned cnt_unsat = 0, pos = -1;
         for (unsigned i = 0; i < sz; i++)
-            if ((i != m_last_pos) && m_mpz_manager.neq(get_value(as[i]), m_one) && (get_random_uint(16) % ++cnt_unsat == 0)) pos = i;	
+            if ((i != m_last_pos) && !is_true(as[i]) && (get_random_uint(16) % ++cnt_unsat == 0)) pos = i;	
 
         if (pos == static_cast<unsigned>(-1))
             return 0;
@@ -93,6 +93,7 @@ public:
     virtual void collect_statistics(statistics & st) const {
         ackermannization_params p(m_p);
         if (!p.eager()) st.update("lackr-its", m_st.m_it);
+        if (!p.eager()) st.update("ackr-constraints-avoided", m_st.m_ackrs_avoided);
         st.update("ackr-constraints", m_st.m_ackrs_sz);
     }
 
@@ -30,6 +30,7 @@ Notes:
 #include"lbool.h"
 
 class progress_callback;
+class tactic_profile;
 
 typedef ptr_buffer<goal> goal_buffer;
 
@@ -92,6 +93,12 @@ public:
 
     // translate tactic to the given manager
     virtual tactic * translate(ast_manager & m) = 0;
+
+    /**
+       \brief Wrap the tactics this tactic is built from with profilers recording
+       into \c p, see profile_tactic. Only tacticals are built from other tactics.
+    */
+    virtual void profile_children(tactic_profile & p) {}
 protected:
     friend class nary_tactical;
     friend class binary_tactical;
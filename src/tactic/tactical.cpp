@@ -22,6 +22,12 @@ Notes:
 #include"cooperate.h"
 #include"scoped_ptr_vector.h"
 #include"z3_omp.h"
+#include"stopwatch.h"
+#include<iomanip>
+#include<sstream>
+#include<typeinfo>
+
+static void profile_child(tactic_profile & p, unsigned pos, tactic * & t);
 
 class binary_tactical : public tactic {
 protected:
@@ -84,6 +90,11 @@ public:
         m_t2->set_progress_callback(callback);
     }
 
+    virtual void profile_children(tactic_profile & p) {
+        profile_child(p, 1, m_t1);
+        profile_child(p, 2, m_t2);
+    }
+
 protected:
 
 
@@ -106,6 +117,18 @@ public:
     and_then_tactical(tactic * t1, tactic * t2):binary_tactical(t1, t2) {}
     virtual ~and_then_tactical() {}
 
+    virtual void profile_children(tactic_profile & p) {
+        // and_then(t1, ..., tn) is a chain of and-then tacticals, it is profiled as one sequence.
+        and_then_tactical * curr = this;
+        unsigned pos = 1;
+        while (typeid(*curr->m_t2) == typeid(and_then_tactical)) {
+            profile_child(p, pos++, curr->m_t1);
+            curr = static_cast<and_then_tactical*>(curr->m_t2);
+        }
+        profile_child(p, pos++, curr->m_t1);
+        profile_child(p, pos, curr->m_t2);
+    }
+
     virtual void operator()(goal_ref const & in, 
                             goal_ref_buffer & result, 
                             model_converter_ref & mc, 
@@ -346,6 +369,11 @@ public:
             (*it)->set_progress_callback(callback);
     }
 
+    virtual void profile_children(tactic_profile & p) {
+        for (unsigned i = 0; i < m_ts.size(); i++)
+            profile_child(p, i + 1, m_ts[i]);
+    }
+
 protected:
 
     template<typename T>
@@ -922,6 +950,7 @@ public:
     virtual void reset() { m_t->reset(); }
     virtual void set_logic(symbol const& l) { m_t->set_logic(l); }    
     virtual void set_progress_callback(progress_callback * callback) { m_t->set_progress_callback(callback); }
+    virtual void profile_children(tactic_profile & p);
 protected:
 
     template<typename T>
@@ -1229,6 +1258,262 @@ tactic * annotate_tactic(char const* name, tactic * t) {
     return alloc(annotate_tactical, name, t);
 }
 
+struct tactic_profile::node {
+    void const *     m_id;
+    std::string      m_name;
+    node *           m_parent;
+    ptr_vector<node> m_children;
+    unsigned         m_calls;
+    unsigned         m_failed;
+    double           m_time;
+    double           m_memory;   // largest memory growth of a call, in MB.
+    unsigned         m_size_in;
+    unsigned         m_size_out;
+    unsigned         m_subgoals;
+    node(void const * id, char const * name, node * parent):
+        m_id(id), m_name(name), m_parent(parent), m_calls(0), m_failed(0), m_time(0), m_memory(0),
+        m_size_in(0), m_size_out(0), m_subgoals(0) {}
+    ~node() {
+        for (unsigned i = 0; i < m_children.size(); i++)
+            dealloc(m_children[i]);
+    }
+    node * get_child(void const * id, char const * name) {
+        for (unsigned i = 0; i < m_children.size(); i++) {
+            if (m_children[i]->m_id == id && m_children[i]->m_name == name)
+                return m_children[i];
+        }
+        node * n = alloc(node, id, name, this);
+        m_children.push_back(n);
+        return n;
+    }
+};
+
+tactic_profile::tactic_profile():
+    m_ref_count(0),
+    m_root(alloc(node, 0, "profile", 0)),
+    m_current(m_root),
+    m_parent(0),
+    m_parent_node(0),
+    m_translation(0),
+    m_translation_depth(0) {
+}
+
+tactic_profile::tactic_profile(tactic_profile & parent):
+    m_ref_count(0),
+    m_root(alloc(node, 0, "profile", 0)),
+    m_current(m_root),
+    m_parent(&parent),
+    m_parent_node(parent.m_current),
+    m_translation(0),
+    m_translation_depth(0) {
+    parent.inc_ref();
+}
+
+tactic_profile::~tactic_profile() {
+    if (m_parent) {
+        // copies are deleted by the threads that used them.
+        #pragma omp critical (tactic_profile)
+        {
+            merge(*m_parent_node, *m_root);
+        }
+        m_parent->dec_ref();
+    }
+    dealloc(m_root);
+}
+
+void tactic_profile::merge(node & dst, node const & src) {
+    for (unsigned i = 0; i < src.m_children.size(); i++) {
+        node const & c = *src.m_children[i];
+        node & d = *dst.get_child(c.m_id, c.m_name.c_str());
+        d.m_calls    += c.m_calls;
+        d.m_failed   += c.m_failed;
+        d.m_time     += c.m_time;
+        d.m_memory    = std::max(d.m_memory, c.m_memory);
+        d.m_size_in  += c.m_size_in;
+        d.m_size_out += c.m_size_out;
+        d.m_subgoals += c.m_subgoals;
+        merge(d, c);
+    }
+}
+
+tactic_profile::node * tactic_profile::enter(void const * id, char const * name) {
+    m_current = m_current->get_child(id, name);
+    return m_current;
+}
+
+void tactic_profile::leave(node * n) {
+    SASSERT(m_current == n);
+    m_current = n->m_parent;
+}
+
+tactic_profile & tactic_profile::begin_translation() {
+    if (m_translation_depth++ == 0) {
+        m_translation = alloc(tactic_profile, *this);
+        m_translation->inc_ref();
+    }
+    return *m_translation;
+}
+
+void tactic_profile::end_translation() {
+    SASSERT(m_translation_depth > 0);
+    if (--m_translation_depth == 0) {
+        // the translated profilers keep the copy alive.
+        m_translation->dec_ref();
+        m_translation = 0;
+    }
+}
+
+void tactic_profile::reset() {
+    SASSERT(m_current == m_root);
+    dealloc(m_root);
+    m_root    = alloc(node, 0, "profile", 0);
+    m_current = m_root;
+}
+
+void tactic_profile::display(std::ostream & out, node const & n, unsigned indent) const {
+    out << std::string(indent, ' ') << "(" << n.m_name;
+    if (&n != m_root) {
+        out << " :calls " << n.m_calls << " :failed " << n.m_failed
+            << " :time " << n.m_time << " :max-memory " << n.m_memory
+            << " :size-in " << n.m_size_in << " :size-out " << n.m_size_out
+            << " :subgoals " << n.m_subgoals;
+    }
+    for (unsigned i = 0; i < n.m_children.size(); i++) {
+        out << "\n";
+        display(out, *n.m_children[i], indent + 2);
+    }
+    out << ")";
+}
+
+void tactic_profile::display(std::ostream & out) const {
+    std::ostringstream strm;
+    strm << std::fixed << std::setprecision(2);
+    display(strm, *m_root, 0);
+    out << strm.str() << "\n";
+}
+
+static char const * mk_profile_key(std::string const & path, char const * counter) {
+    // statistics keys must outlive the profile, so they are interned as symbols.
+    std::string key = "profile " + path + " " + counter;
+    return symbol(key.c_str()).bare_str();
+}
+
+void tactic_profile::collect_statistics(node const & n, std::string const & path, statistics & st) const {
+    if (&n != m_root) {
+        st.update(mk_profile_key(path, "calls"), n.m_calls);
+        st.update(mk_profile_key(path, "failed"), n.m_failed);
+        st.update(mk_profile_key(path, "time"), n.m_time);
+        st.update(mk_profile_key(path, "max memory"), n.m_memory);
+        st.update(mk_profile_key(path, "size in"), n.m_size_in);
+        st.update(mk_profile_key(path, "size out"), n.m_size_out);
+        st.update(mk_profile_key(path, "subgoals"), n.m_subgoals);
+    }
+    for (unsigned i = 0; i < n.m_children.size(); i++) {
+        node const & c = *n.m_children[i];
+        // siblings with the same name are numbered, so every node has a key of its own.
+        unsigned num_same = 0;
+        for (unsigned j = 0; j < i; j++)
+            if (n.m_children[j]->m_name == c.m_name)
+                num_same++;
+        std::string c_path = &n == m_root ? c.m_name : path + "/" + c.m_name;
+        if (num_same > 0)
+            c_path += "." + std::to_string(num_same + 1);
+        collect_statistics(c, c_path, st);
+    }
+}
+
+void tactic_profile::collect_statistics(statistics & st) const {
+    collect_statistics(*m_root, std::string(), st);
+}
+
+class profile_tactical : public unary_tactical {
+    ref<tactic_profile> m_profile;
+    void const *        m_id;      // the node of the profiler, shared with its translations.
+    std::string         m_name;
+
+    static double to_mb(unsigned long long sz) {
+        return static_cast<double>(sz) / static_cast<double>(1024*1024);
+    }
+
+public:
+    profile_tactical(tactic_profile & p, void const * id, char const* name, tactic* t):
+        unary_tactical(t),
+        m_profile(&p),
+        m_id(id ? id : this),
+        m_name(name) {
+    }
+
+    tactic_profile const & profile() const { return *m_profile; }
+
+    void set_name(char const * name) { m_name = name; }
+    
+    virtual void operator()(goal_ref const & in, 
+                            goal_ref_buffer & result, 
+                            model_converter_ref & mc, 
+                            proof_converter_ref & pc, 
+                            expr_dependency_ref & core) {        
+        tactic_profile::node * n = m_profile->enter(m_id, m_name.c_str());
+        n->m_calls++;
+        n->m_size_in += in->num_exprs();
+        unsigned long long mem_before = memory::get_allocation_size();
+        unsigned long long max_before = memory::get_max_used_memory();
+        stopwatch watch;
+        watch.start();
+        struct scope {
+            tactic_profile &       m_profile;
+            tactic_profile::node & m_node;
+            stopwatch &            m_watch;
+            unsigned long long     m_mem_before;
+            unsigned long long     m_max_before;
+            scope(tactic_profile & p, tactic_profile::node & n, stopwatch & w, unsigned long long mem, unsigned long long max):
+                m_profile(p), m_node(n), m_watch(w), m_mem_before(mem), m_max_before(max) {}
+            ~scope() {
+                m_watch.stop();
+                m_node.m_time += m_watch.get_seconds();
+                // the peak within the call is known only if the global peak was exceeded,
+                // otherwise the net growth is recorded.
+                unsigned long long max_after = memory::get_max_used_memory();
+                unsigned long long mem_after = max_after > m_max_before ? max_after : memory::get_allocation_size();
+                if (mem_after > m_mem_before)
+                    m_node.m_memory = std::max(m_node.m_memory, to_mb(mem_after - m_mem_before));
+                m_profile.leave(&m_node);
+            }
+        };
+        scope _scope(*m_profile, *n, watch, mem_before, max_before);
+        try {
+            m_t->operator()(in, result, mc, pc, core);
+        }
+        catch (...) {
+            n->m_failed++;
+            throw;
+        }
+        n->m_subgoals += result.size();
+        for (unsigned i = 0; i < result.size(); i++)
+            n->m_size_out += result[i]->num_exprs();
+    }
+
+    virtual void reset_statistics() { 
+        m_profile->reset();
+        m_t->reset_statistics(); 
+    }
+
+    virtual tactic * translate(ast_manager & m) { 
+        // the translated profilers below this one record into the same copy of the profile.
+        tactic_profile & p = m_profile->begin_translation();
+        tactic * new_t = 0;
+        try {
+            new_t = m_t->translate(m);
+        }
+        catch (...) {
+            m_profile->end_translation();
+            throw;
+        }
+        tactic * r = alloc(profile_tactical, p, m_id, m_name.c_str(), new_t);
+        m_profile->end_translation();
+        return r;
+    }
+};
+
 class cond_tactical : public binary_tactical {
     probe * m_p;
 public:
@@ -1393,4 +1678,44 @@ tactic * skip_if_failed(tactic * t) {
     return or_else(t, mk_skip_tactic());
 }
 
+static bool is_profiled(tactic * t) {
+    return dynamic_cast<profile_tactical*>(t) != 0;
+}
+
+void unary_tactical::profile_children(tactic_profile & p) {
+    if (!is_profiled(m_t))
+        m_t->profile_children(p);
+}
+
+static char const * get_tactical_name(tactic * t) {
+    std::type_info const & ti = typeid(*t);
+    if (ti == typeid(and_then_tactical))     return "and-then";
+    if (ti == typeid(par_and_then_tactical)) return "par-then";
+    if (ti == typeid(or_else_tactical))      return "or-else";
+    if (ti == typeid(par_tactical))          return "par";
+    if (ti == typeid(cond_tactical))         return "cond";
+    return 0;
+}
+
+static void profile_child(tactic_profile & p, unsigned pos, tactic * & t) {
+    if (is_profiled(t))
+        return;
+    char const * kind = get_tactical_name(t);
+    std::string name = kind ? std::string(kind) : "#" + std::to_string(pos);
+    tactic * new_t = profile_tactic(p, name.c_str(), t);
+    new_t->inc_ref();
+    t->dec_ref();
+    t = new_t;
+}
+
+tactic * profile_tactic(tactic_profile & p, char const* name, tactic * t) {
+    profile_tactical * pt = dynamic_cast<profile_tactical*>(t);
+    if (pt && &pt->profile() == &p) {
+        pt->set_name(name);
+        return t;
+    }
+    t->profile_children(p);
+    return alloc(profile_tactical, p, static_cast<void const*>(0), name, t);
+}
+
     
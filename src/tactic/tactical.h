@@ -65,6 +65,66 @@ tactic * clean(tactic * t);
 tactic * using_params(tactic * t, params_ref const & p);
 tactic * annotate_tactic(char const* name, tactic * t);
 
+/**
+   \brief Profile of tactics. It is a tree with a node for each profiled tactic
+   that ran, the children of a node are the profiled tactics that ran inside it.
+   A node records the number of calls and failures, the time, the largest memory
+   growth of a call, the size of the input goals, the size of the resulting
+   subgoals, and their number.
+
+   Translated tactics, such as the copies run by par and par-then, record into a
+   copy of the profile. The copy is merged into the profile, under the node that
+   was running when the tactics were translated, when the copy is deleted.
+*/
+class tactic_profile {
+public:
+    struct node;
+private:
+    unsigned         m_ref_count;
+    node *           m_root;
+    node *           m_current;
+    tactic_profile * m_parent;        // profile the copy is merged into.
+    node *           m_parent_node;
+    tactic_profile * m_translation;   // copy used by the translation in progress.
+    unsigned         m_translation_depth;
+
+    static void merge(node & dst, node const & src);
+    void display(std::ostream & out, node const & n, unsigned indent) const;
+    void collect_statistics(node const & n, std::string const & path, statistics & st) const;
+public:
+    tactic_profile();
+    tactic_profile(tactic_profile & parent);
+    ~tactic_profile();
+    void inc_ref() { ++m_ref_count; }
+    void dec_ref() { SASSERT(m_ref_count > 0); if (--m_ref_count == 0) dealloc(this); }
+
+    // Enter the node of the profiler identified by id, a child of the current node.
+    node * enter(void const * id, char const * name);
+    void leave(node * n);
+
+    // Return the copy of the profile that the tactics translated until the matching
+    // end_translation record into.
+    tactic_profile & begin_translation();
+    void end_translation();
+
+    void reset();
+    void display(std::ostream & out) const;
+    /**
+       \brief Report the profile using keys of the form "profile <path> <counter>",
+       where <path> are the names of the nodes from the root separated by /.
+    */
+    void collect_statistics(statistics & st) const;
+};
+
+/**
+   \brief Create a tactic that behaves like \c t, and records its invocations in \c p
+   under the given name. The tactics \c t is built from (the arguments of and-then,
+   or-else, par, par-then and cond) are profiled too, they are named after the
+   tactical or after their position (#1, #2, ...).
+   If \c t is a profiler recording into \c p, it is renamed instead.
+*/
+tactic * profile_tactic(tactic_profile & p, char const* name, tactic * t);
+
 // Create a tactic that fails if the result returned by probe p is true.
 tactic * fail_if(probe * p);
 tactic * fail_if_not(probe * p);
@@ -0,0 +1,64 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    aig.cpp
+
+Abstract:
+
+    SAT sweeping of AIGs. The two sides of the associativity of xor
+    are equivalent, but the equivalence can't be shown by unit
+    propagation.
+
+--*/
+
+#include "aig.h"
+#include "ast_pp.h"
+#include "reg_decl_plugins.h"
+#include "statistics.h"
+
+static expr_ref mk_xor(ast_manager & m, expr * a, expr * b) {
+    return expr_ref(m.mk_not(m.mk_iff(a, b)), m);
+}
+
+static void tst_fraig(unsigned max_conflicts, bool merged) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref a(m.mk_const(symbol("a"), m.mk_bool_sort()), m);
+    expr_ref b(m.mk_const(symbol("b"), m.mk_bool_sort()), m);
+    expr_ref c(m.mk_const(symbol("c"), m.mk_bool_sort()), m);
+    expr_ref d(m.mk_const(symbol("d"), m.mk_bool_sort()), m);
+    expr_ref x1 = mk_xor(m, a, mk_xor(m, b, c));
+    expr_ref x2 = mk_xor(m, mk_xor(m, a, b), c);
+    expr_ref y1 = mk_xor(m, b, mk_xor(m, c, d));
+    expr_ref y2 = mk_xor(m, mk_xor(m, b, c), d);
+    expr_ref fml(m.mk_and(m.mk_iff(x1, x2), m.mk_iff(y1, y2)), m);
+
+    aig_manager mng(m);
+    aig_ref r = mng.mk_aig(fml);
+    aig_fraig_stats st;
+    mng.fraig(r, max_conflicts, st);
+    expr_ref result(m);
+    mng.to_formula(r, result);
+    statistics stats;
+    st.collect_statistics(stats);
+    std::cout << result << "\n";
+    stats.display(std::cout);
+    if (merged) {
+        ENSURE(m.is_true(result));
+        ENSURE(st.m_num_merged >= 2);
+        ENSURE(st.m_num_undef == 0);
+    }
+    else {
+        // each undecided check leaves the remaining candidates to be checked.
+        ENSURE(!m.is_true(result));
+        ENSURE(st.m_num_merged == 0);
+        ENSURE(st.m_num_undef >= 2);
+    }
+}
+
+void tst_aig() {
+    tst_fraig(1000, true);
+    tst_fraig(0, false);
+}
@@ -20,6 +20,7 @@ Notes:
 #include"polynomial_var2value.h"
 #include"mpbq.h"
 #include"rlimit.h"
+#include"statistics.h"
 
 static void display_anums(std::ostream & out, scoped_anum_vector const & rs) {
     out << "numbers in decimal:\n";
@@ -385,6 +386,80 @@ static void tst_eval_sign() {
 
 }
 
+static unsigned get_stat(anum_manager & am, char const * key) {
+    statistics st;
+    am.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); i++) {
+        if (strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+// The sign of a polynomial at an irrational point is determined using
+// hardware float intervals when they are conclusive, and using exact
+// interval refinement otherwise.
+static void tst_float_filter() {
+    reslimit rl;
+    unsynch_mpq_manager        qm;
+    polynomial::manager        pm(rl, qm);
+    algebraic_numbers::manager am(rl, qm);
+    polynomial_ref x0(pm);
+    x0 = pm.mk_polynomial(pm.mk_var());
+    scoped_anum v0(am);
+    am.set(v0, 2);
+    am.root(v0, 2, v0);
+    polynomial::simple_var2value<anum_manager> x2v(am);
+    x2v.push_back(0, v0);
+    unsigned num_float = get_stat(am, "algebraic eval sign float");
+    unsigned num_fallback = get_stat(am, "algebraic eval sign fallback");
+
+    // fallback: x0^3 - 2*x0 vanishes at sqrt(2), so the float interval
+    // contains zero. The exact path refines the isolating interval of x0.
+    polynomial_ref p(pm);
+    p = (x0^3) - 2*x0;
+    ENSURE(am.eval_sign_at(p, x2v) == 0);
+    ENSURE(get_stat(am, "algebraic eval sign float") == num_float);
+    ENSURE(get_stat(am, "algebraic eval sign fallback") == num_fallback + 1);
+
+    // fast path: the float intervals exclude zero.
+    p = (x0^2) - 3;
+    ENSURE(am.eval_sign_at(p, x2v) < 0);
+    p = 1000*x0 - 1415;
+    ENSURE(am.eval_sign_at(p, x2v) < 0);
+    p = 1000*x0 - 1414;
+    ENSURE(am.eval_sign_at(p, x2v) > 0);
+    ENSURE(get_stat(am, "algebraic eval sign float") == num_float + 3);
+    ENSURE(get_stat(am, "algebraic eval sign fallback") == num_fallback + 1);
+
+    // fallback: the coefficients are too big for floats.
+    rational big = rational::power_of_two(3000);
+    p = big*(x0^2) - (big*rational(3) - rational(1));
+    ENSURE(am.eval_sign_at(p, x2v) < 0);
+    ENSURE(get_stat(am, "algebraic eval sign float") == num_float + 3);
+    ENSURE(get_stat(am, "algebraic eval sign fallback") == num_fallback + 2);
+
+    // the exact path computes the same signs.
+    params_ref ps;
+    ps.set_bool("float_filter", false);
+    algebraic_numbers::manager am2(rl, qm, ps);
+    scoped_anum v1(am2);
+    am2.set(v1, 2);
+    am2.root(v1, 2, v1);
+    polynomial::simple_var2value<anum_manager> x2v2(am2);
+    x2v2.push_back(0, v1);
+    p = (x0^3) - 2*x0;
+    ENSURE(am2.eval_sign_at(p, x2v2) == 0);
+    p = (x0^2) - 3;
+    ENSURE(am2.eval_sign_at(p, x2v2) < 0);
+    p = 1000*x0 - 1415;
+    ENSURE(am2.eval_sign_at(p, x2v2) < 0);
+    p = 1000*x0 - 1414;
+    ENSURE(am2.eval_sign_at(p, x2v2) > 0);
+    ENSURE(get_stat(am2, "algebraic eval sign float") == 0);
+    ENSURE(get_stat(am2, "algebraic eval sign fallback") == 0);
+}
+
 static void tst_isolate_roots(polynomial_ref const & p, anum_manager & am,
                               polynomial::var x0, anum const & v0, polynomial::var x1, anum const & v1, polynomial::var x2, anum const & v2) {
     polynomial::simple_var2value<anum_manager> x2v(am);
@@ -573,6 +648,7 @@ void tst_algebraic() {
     tst_isolate_roots();
     ex1();
     tst_eval_sign();
+    tst_float_filter();
     tst_select_small();
     tst_dejan();
     tst_wilkinson();
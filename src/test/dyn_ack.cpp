@@ -0,0 +1,91 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    dyn_ack.cpp
+
+Abstract:
+
+    Dynamic ackermannization with a bounded number of tracked
+    congruence pairs. Random clauses over equalities between
+    uninterpreted terms produce many congruence conflicts. The
+    number of tracked pairs must stay within 5/4 of
+    dack.max_tracked, and the results must not change.
+
+--*/
+
+#include"smt_kernel.h"
+#include"smt_params.h"
+#include"reg_decl_plugins.h"
+#include"statistics.h"
+
+static unsigned get_stat(statistics const & st, char const * key) {
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+static void mk_problem(unsigned seed, expr_ref_vector & fmls) {
+    ast_manager & m = fmls.get_manager();
+    random_gen rand(seed);
+    sort_ref u(m.mk_uninterpreted_sort(symbol("U")), m);
+    sort * us[2] = { u, u };
+    func_decl_ref f(m.mk_func_decl(symbol("f"), 2, us, u), m);
+    func_decl_ref g(m.mk_func_decl(symbol("g"), 1, us, u), m);
+    unsigned num_consts = 10;
+    expr_ref_vector cs(m), ts(m);
+    for (unsigned i = 0; i < num_consts; ++i) {
+        std::string name = "c" + std::to_string(i);
+        cs.push_back(m.mk_const(symbol(name.c_str()), u));
+    }
+    ts.append(cs);
+    for (unsigned i = 0; i < 30; ++i)
+        ts.push_back(m.mk_app(f, cs.get(rand(num_consts)), cs.get(rand(num_consts))));
+    for (unsigned i = 0; i < 15; ++i)
+        ts.push_back(m.mk_app(g, cs.get(rand(num_consts))));
+    for (unsigned i = 0; i < 320; ++i) {
+        expr_ref_vector lits(m);
+        for (unsigned j = 0; j < 3; ++j) {
+            expr_ref eq(m.mk_eq(ts.get(rand(ts.size())), ts.get(rand(ts.size()))), m);
+            lits.push_back(rand(2) == 0 ? eq.get() : m.mk_not(eq));
+        }
+        fmls.push_back(m.mk_or(lits.size(), lits.c_ptr()));
+    }
+}
+
+static lbool solve(unsigned seed, unsigned max_tracked, statistics & st) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector fmls(m);
+    mk_problem(seed, fmls);
+    smt_params fp;
+    fp.m_dack_max_tracked = max_tracked;
+    smt::kernel solver(m, fp);
+    solver.assert_expr(fmls);
+    lbool r = solver.check();
+    solver.collect_statistics(st);
+    return r;
+}
+
+static void tst_dyn_ack(unsigned seed) {
+    unsigned max_tracked = 16;
+    statistics st1, st2;
+    lbool r1 = solve(seed, 0, st1);
+    lbool r2 = solve(seed, max_tracked, st2);
+    std::cout << "problem " << seed << ": " << r1
+              << " conflicts: " << get_stat(st2, "conflicts")
+              << " tracked unbounded: " << get_stat(st1, "dyn ack max tracked")
+              << " bounded: " << get_stat(st2, "dyn ack max tracked")
+              << " evicted: " << get_stat(st2, "dyn ack evicted") << "\n";
+    ENSURE(r1 == r2);
+    ENSURE(get_stat(st1, "dyn ack evicted") == 0);
+    ENSURE(get_stat(st2, "dyn ack max tracked") <= max_tracked + max_tracked / 4);
+}
+
+void tst_dyn_ack() {
+    for (unsigned seed = 0; seed < 3; ++seed)
+        tst_dyn_ack(seed);
+}
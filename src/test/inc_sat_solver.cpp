@@ -0,0 +1,75 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    inc_sat_solver.cpp
+
+Abstract:
+
+    Check incremental bit-blasting in the incremental SAT solver
+    on a bounded model checking loop, and measure the latency of
+    each check.
+
+--*/
+
+#include <sstream>
+#include "inc_sat_solver.h"
+#include "bv_decl_plugin.h"
+#include "reg_decl_plugins.h"
+#include "stopwatch.h"
+#include "statistics.h"
+
+static void bmc_counter(bool incremental_bb, unsigned num_steps, unsigned target, svector<lbool>& results) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    params_ref p;
+    p.set_bool("incremental_bb", incremental_bb);
+    ref<solver> s = mk_inc_sat_solver(m, p);
+    unsigned sz = 16;
+    expr_ref x(m.mk_const(symbol("x0"), bv.mk_sort(sz)), m);
+    expr_ref y(m.mk_const(symbol("y0"), bv.mk_sort(sz)), m);
+    s->assert_expr(m.mk_eq(x, bv.mk_numeral(0, sz)));
+    s->assert_expr(m.mk_eq(y, bv.mk_numeral(1, sz)));
+    stopwatch sw;
+    sw.start();
+    for (unsigned k = 1; k <= num_steps; ++k) {
+        // x_k = x_{k-1} + y_{k-1}, y_k = y_{k-1} * 3
+        std::stringstream xn, yn;
+        xn << "x" << k;
+        yn << "y" << k;
+        expr_ref x1(m.mk_const(symbol(xn.str().c_str()), bv.mk_sort(sz)), m);
+        expr_ref y1(m.mk_const(symbol(yn.str().c_str()), bv.mk_sort(sz)), m);
+        s->assert_expr(m.mk_eq(x1, bv.mk_bv_add(x, y)));
+        s->assert_expr(m.mk_eq(y1, bv.mk_bv_mul(y, bv.mk_numeral(3, sz))));
+        x = x1;
+        y = y1;
+        s->push();
+        s->assert_expr(m.mk_eq(x, bv.mk_numeral(target, sz)));
+        lbool r = s->check_sat(0, 0);
+        s->pop(1);
+        results.push_back(r);
+    }
+    sw.stop();
+    statistics st;
+    s->collect_statistics(st);
+    std::cout << "incremental_bb: " << (incremental_bb ? "true" : "false")
+              << " checks: " << num_steps
+              << " avg. latency: " << (1000.0 * sw.get_seconds() / num_steps) << "ms\n";
+    st.display(std::cout);
+}
+
+void tst_inc_sat_solver() {
+    // x_k = (3^k - 1)/2, so x_5 = 121.
+    unsigned num_steps = 30;
+    svector<lbool> r1, r2;
+    bmc_counter(true, num_steps, 121, r1);
+    bmc_counter(false, num_steps, 121, r2);
+    VERIFY(r1.size() == num_steps && r2.size() == num_steps);
+    for (unsigned k = 0; k < num_steps; ++k) {
+        VERIFY(r1[k] == r2[k]);
+    }
+    VERIFY(r1[4] == l_true);
+    VERIFY(r1[3] == l_false);
+}
@@ -0,0 +1,139 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    lackr.cpp
+
+Abstract:
+
+    Lazy ackermannization of QF_UFBV problems. The lazy mode must
+    agree with the eager mode, and it never adds the congruence
+    constraint of a pair of terms twice, so it adds at most as many
+    constraints as the eager mode. When a model is refuted only by
+    constraints that were already added, it gives up instead of
+    looping.
+
+--*/
+
+#include"lackr.h"
+#include"inc_sat_solver.h"
+#include"bv_decl_plugin.h"
+#include"reg_decl_plugins.h"
+
+// A solver that ignores the formulas asserted after the first check,
+// so the congruence constraints of the lazy mode never rule out the
+// current model.
+class forgetful_solver : public solver {
+    ref<solver> m_solver;
+    bool        m_checked;
+public:
+    forgetful_solver(solver * s):m_solver(s), m_checked(false) {}
+    virtual solver* translate(ast_manager& m, params_ref const& p) { UNREACHABLE(); return 0; }
+    virtual void assert_expr(expr * t) { if (!m_checked) m_solver->assert_expr(t); }
+    virtual void assert_expr(expr * t, expr * a) { if (!m_checked) m_solver->assert_expr(t, a); }
+    virtual void push() { m_solver->push(); }
+    virtual void pop(unsigned n) { m_solver->pop(n); }
+    virtual unsigned get_scope_level() const { return m_solver->get_scope_level(); }
+    virtual lbool check_sat(unsigned num_assumptions, expr * const * assumptions) {
+        m_checked = true;
+        return m_solver->check_sat(num_assumptions, assumptions);
+    }
+    virtual void set_progress_callback(progress_callback * callback) {}
+    virtual unsigned get_num_assumptions() const { return m_solver->get_num_assumptions(); }
+    virtual expr * get_assumption(unsigned idx) const { return m_solver->get_assumption(idx); }
+    virtual void collect_statistics(statistics & st) const { m_solver->collect_statistics(st); }
+    virtual void get_unsat_core(ptr_vector<expr> & r) { m_solver->get_unsat_core(r); }
+    virtual void get_model(model_ref & m) { m_solver->get_model(m); }
+    virtual proof * get_proof() { return m_solver->get_proof(); }
+    virtual std::string reason_unknown() const { return m_solver->reason_unknown(); }
+    virtual void set_reason_unknown(char const* msg) { m_solver->set_reason_unknown(msg); }
+    virtual void get_labels(svector<symbol> & r) { m_solver->get_labels(r); }
+    virtual ast_manager& get_manager() const { return m_solver->get_manager(); }
+};
+
+static lbool run_lackr(expr_ref_vector & fmls, bool eager, bool forgetful, lackr_stats & st) {
+    ast_manager & m = fmls.get_manager();
+    params_ref p;
+    p.set_bool("eager", eager);
+    ref<solver> s = mk_inc_sat_solver(m, p);
+    if (forgetful)
+        s = alloc(forgetful_solver, s.get());
+    s->set_produce_models(true);
+    lackr lackr(m, p, st, fmls, s.get());
+    return lackr();
+}
+
+// x = y and f(x) != f(y) is unsat, but the abstraction is sat until
+// the congruence constraint of f(x) and f(y) is added.
+static void tst_no_refinement() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    sort_ref s(bv.mk_sort(8), m);
+    sort * ss[1] = { s };
+    func_decl_ref f(m.mk_func_decl(symbol("f"), 1, ss, s), m);
+    expr_ref x(m.mk_const(symbol("x"), s), m), y(m.mk_const(symbol("y"), s), m);
+    expr_ref_vector fmls(m);
+    fmls.push_back(m.mk_eq(x, y));
+    fmls.push_back(m.mk_not(m.mk_eq(m.mk_app(f, x.get()), m.mk_app(f, y.get()))));
+
+    lackr_stats st1, st2;
+    expr_ref_vector fmls1(fmls), fmls2(fmls);
+    ENSURE(run_lackr(fmls1, false, false, st1) == l_false);
+    ENSURE(st1.m_ackrs_sz == 1);
+    ENSURE(run_lackr(fmls2, false, true, st2) == l_undef);
+    std::cout << "no refinement: iterations " << st2.m_it << " constraints " << st2.m_ackrs_sz << "\n";
+    ENSURE(st2.m_it == 2);
+    ENSURE(st2.m_ackrs_sz == 1);
+}
+
+// random equalities between constants and applications of a unary f.
+static void mk_problem(ast_manager & m, random_gen & rand, unsigned num_apps, expr_ref_vector & fmls) {
+    bv_util bv(m);
+    sort_ref s(bv.mk_sort(4), m);
+    sort * ss[1] = { s };
+    func_decl_ref f(m.mk_func_decl(symbol("f"), 1, ss, s), m);
+    unsigned num_consts = 6;
+    expr_ref_vector cs(m), ts(m);
+    for (unsigned i = 0; i < num_consts; ++i) {
+        std::string name = "c" + std::to_string(i);
+        cs.push_back(m.mk_const(symbol(name.c_str()), s));
+    }
+    // distinct arguments, so that there are num_apps distinct applications.
+    for (unsigned i = 0; i < num_apps; ++i)
+        ts.push_back(m.mk_app(f, bv.mk_bv_add(cs.get(i % num_consts), bv.mk_numeral(i / num_consts, 4))));
+    ts.append(cs);
+    for (unsigned i = 0; i < 30; ++i) {
+        expr_ref eq(m.mk_eq(ts.get(rand(ts.size())), ts.get(rand(ts.size()))), m);
+        expr_ref eq2(m.mk_eq(ts.get(rand(ts.size())), ts.get(rand(ts.size()))), m);
+        fmls.push_back(m.mk_or(rand(2) == 0 ? eq.get() : m.mk_not(eq), rand(2) == 0 ? eq2.get() : m.mk_not(eq2)));
+    }
+}
+
+static void tst_refined_once(unsigned seed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    random_gen rand(seed);
+    unsigned num_apps = 8;
+    expr_ref_vector fmls(m);
+    mk_problem(m, rand, num_apps, fmls);
+    lackr_stats st1, st2;
+    expr_ref_vector fmls1(fmls), fmls2(fmls);
+    lbool r1 = run_lackr(fmls1, false, false, st1);
+    lbool r2 = run_lackr(fmls2, true, false, st2);
+    std::cout << "seed " << seed << ": " << r1 << " lazy constraints " << st1.m_ackrs_sz
+              << " eager constraints " << st2.m_ackrs_sz << "\n";
+    ENSURE(r1 != l_undef);
+    ENSURE(r1 == r2);
+    // the eager mode adds the constraint of every pair of applications.
+    ENSURE(st2.m_ackrs_sz <= num_apps * (num_apps - 1) / 2);
+    ENSURE(st1.m_ackrs_sz <= st2.m_ackrs_sz);
+    ENSURE(st1.m_ackrs_avoided >= 0);
+}
+
+void tst_lackr() {
+    tst_no_refinement();
+    for (unsigned seed = 0; seed < 20; ++seed)
+        tst_refined_once(seed);
+}
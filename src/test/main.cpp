@@ -225,11 +225,29 @@ int main(int argc, char ** argv) {
     TST(theory_pb);
     TST(simplex);
     TST(sat_user_scope);
+    TST(sat_card);
+    TST(sat_xor);
+    TST(sat_elim_vars);
+    TST(sat_inprocessing);
+    TST(sat_gc);
     TST(pdr);
     TST_ARGV(ddnf);
     TST(model_evaluator);
     TST(get_consequences);
+    TST(inc_sat_solver);
     TST(pb2bv);
+    TST(aig);
+    TST(z3_log);
+    TST(strategy_selector);
+    TST(tactic_profile);
+    TST(sls);
+    TST(qfbv_sls_portfolio);
+    TST(theory_array);
+    TST(theory_seq);
+    TST(dyn_ack);
+    TST(lackr);
+    TST(polynomial_cache);
+    TST(qe_mbp);
     //TST_ARGV(hs);
 }
 
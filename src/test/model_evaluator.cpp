@@ -4,9 +4,58 @@
 #include "arith_decl_plugin.h"
 #include "reg_decl_plugins.h"
 #include "ast_pp.h"
+#include "stopwatch.h"
 
 
+// model::eval shares one evaluator across calls, check that the results follow
+// updates of the model and compare the throughput with a fresh evaluator per call.
+static void tst_model_eval_reuse() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    func_decl_ref x(m.mk_const_decl(symbol("x"), a.mk_int()), m);
+    func_decl_ref y(m.mk_const_decl(symbol("y"), a.mk_int()), m);
+    model_ref mdl = alloc(model, m);
+    mdl->register_decl(x, a.mk_numeral(rational(1), true));
+    expr_ref e(a.mk_add(m.mk_const(x), a.mk_int(1)), m), v(m);
+
+    ENSURE(mdl->eval(e, v));
+    ENSURE(v == a.mk_numeral(rational(2), true));
+    // the cache of the shared evaluator must not hide the new value of x.
+    mdl->register_decl(x, a.mk_numeral(rational(5), true));
+    ENSURE(mdl->eval(e, v));
+    ENSURE(v == a.mk_numeral(rational(6), true));
+    // model completion is set for each call.
+    expr_ref ey(m.mk_const(y), m);
+    ENSURE(mdl->eval(ey, v, false));
+    ENSURE(v == ey);
+    ENSURE(mdl->eval(ey, v, true));
+    ENSURE(a.is_numeral(v));
+    ENSURE(mdl->eval(ey, v, false));
+    ENSURE(v != ey);
+
+    unsigned n = 20000;
+    expr_ref_vector terms(m);
+    for (unsigned i = 0; i < n; ++i)
+        terms.push_back(a.mk_add(m.mk_const(x), a.mk_int(i)));
+    stopwatch shared, fresh;
+    shared.start();
+    for (unsigned i = 0; i < n; ++i)
+        mdl->eval(terms.get(i), v);
+    shared.stop();
+    fresh.start();
+    for (unsigned i = 0; i < n; ++i) {
+        model_evaluator ev(*mdl.get());
+        ev(terms.get(i), v);
+    }
+    fresh.stop();
+    std::cout << "evals/sec with a shared evaluator: " << (n / shared.get_seconds())
+              << ", with a fresh evaluator per call: " << (n / fresh.get_seconds()) << "\n";
+}
+
 void tst_model_evaluator() {
+    tst_model_eval_reuse();
+
     ast_manager m;
     reg_decl_plugins(m);
     arith_util a(m);
@@ -6,6 +6,7 @@ Copyright (c) 2015 Microsoft Corporation
 
 #include "pdr_context.h"
 #include "reg_decl_plugins.h"
+#include "z3.h"
 
 
 using namespace pdr;
@@ -121,7 +122,91 @@ struct test_model_search {
 
 };
 
+// L1 counts x and y up to 10 and L2 counts them down together, so L3
+// is reached with x = y = 0. err is reachable iff reach_if_equal holds.
+// The reachable error does not depend on M: PDR answers unsat when a
+// rule with two body predicates is needed to reach err, with or
+// without pdr.incremental_propagate.
+static std::string mk_counters(bool reach_if_equal) {
+    std::string result =
+        "(declare-rel L1 (Int Int))\n"
+        "(declare-rel L2 (Int Int))\n"
+        "(declare-rel L3 (Int Int))\n"
+        "(declare-rel M (Int))\n"
+        "(declare-rel err ())\n"
+        "(declare-var x Int)\n"
+        "(declare-var y Int)\n"
+        "(declare-var z Int)\n"
+        "(rule (=> (= z 0) (M z)))\n"
+        "(rule (=> (and (M z) (< z 20)) (M (+ z 1))))\n"
+        "(rule (=> (and (= x 0) (= y 0)) (L1 x y)))\n"
+        "(rule (=> (and (L1 x y) (< x 10)) (L1 (+ x 1) (+ y 1))))\n"
+        "(rule (=> (and (L1 x y) (>= x 10)) (L2 x y)))\n"
+        "(rule (=> (and (L2 x y) (> y 0)) (L2 (- x 1) (- y 1))))\n"
+        "(rule (=> (and (L2 x y) (<= y 0)) (L3 x (* 2 y))))\n";
+    result += reach_if_equal ? "(rule (=> (and (L3 x y) (= x y)) err))\n" : "(rule (=> (and (L3 x y) (M z) (not (= x y))) err))\n";
+    result += "(query err)\n";
+    return result;
+}
+
+static unsigned get_stat(Z3_context ctx, Z3_stats st, char const* key) {
+    for (unsigned i = 0; i < Z3_stats_size(ctx, st); ++i) {
+        if (Z3_stats_is_uint(ctx, st, i) && strcmp(Z3_stats_get_key(ctx, st, i), key) == 0) {
+            return Z3_stats_get_uint_value(ctx, st, i);
+        }
+    }
+    return 0;
+}
+
+static Z3_lbool query_counters(bool reach_if_equal, bool incremental_propagate, unsigned& skipped) {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_fixedpoint fp = Z3_mk_fixedpoint(ctx);
+    Z3_fixedpoint_inc_ref(ctx, fp);
+    Z3_params p = Z3_mk_params(ctx);
+    Z3_params_inc_ref(ctx, p);
+    Z3_params_set_symbol(ctx, p, Z3_mk_string_symbol(ctx, "engine"), Z3_mk_string_symbol(ctx, "pdr"));
+    Z3_params_set_bool(ctx, p, Z3_mk_string_symbol(ctx, "pdr.incremental_propagate"), incremental_propagate);
+    Z3_fixedpoint_set_params(ctx, fp, p);
+    std::string prob = mk_counters(reach_if_equal);
+    Z3_ast_vector queries = Z3_fixedpoint_from_string(ctx, fp, prob.c_str());
+    Z3_ast_vector_inc_ref(ctx, queries);
+    ENSURE(Z3_ast_vector_size(ctx, queries) == 1);
+    Z3_lbool r = Z3_fixedpoint_query(ctx, fp, Z3_ast_vector_get(ctx, queries, 0));
+    Z3_stats st = Z3_fixedpoint_get_statistics(ctx, fp);
+    Z3_stats_inc_ref(ctx, st);
+    skipped = get_stat(ctx, st, "PDR num propagations skipped");
+    std::cout << "reach if equal: " << reach_if_equal 
+              << " incremental propagate: " << incremental_propagate
+              << " result: " << r 
+              << " propagations: " << get_stat(ctx, st, "PDR num propagations")
+              << " skipped: " << skipped << "\n";
+    Z3_stats_dec_ref(ctx, st);
+    Z3_ast_vector_dec_ref(ctx, queries);
+    Z3_params_dec_ref(ctx, p);
+    Z3_fixedpoint_dec_ref(ctx, fp);
+    Z3_del_context(ctx);
+    return r;
+}
+
+// pdr.incremental_propagate must not change the answers, and no
+// propagation is skipped when it is off.
+static void tst_incremental_propagate() {
+    for (unsigned i = 0; i < 2; ++i) {
+        bool reach_if_equal = i == 0;
+        unsigned skipped1 = 0, skipped2 = 0;
+        Z3_lbool r1 = query_counters(reach_if_equal, false, skipped1);
+        Z3_lbool r2 = query_counters(reach_if_equal, true, skipped2);
+        ENSURE(r1 == (reach_if_equal ? Z3_L_TRUE : Z3_L_FALSE));
+        ENSURE(r1 == r2);
+        ENSURE(skipped1 == 0);
+    }
+}
+
 void tst_pdr() {
+    tst_incremental_propagate();
+
     test_model_search test;
 
     test.init();
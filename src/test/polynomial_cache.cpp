@@ -0,0 +1,91 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    polynomial_cache.cpp
+
+Abstract:
+
+    Memoized psc chains and factorizations, and flushing of the
+    bounded cache. A flush must keep the unique polynomials that are
+    referenced outside of the cache, and remove the others.
+
+--*/
+
+#include"polynomial_cache.h"
+#include"statistics.h"
+
+static unsigned get_stat(statistics const & st, char const * key) {
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+static unsigned get_stat(polynomial::cache const & c, char const * key) {
+    statistics st;
+    c.collect_statistics(st);
+    return get_stat(st, key);
+}
+
+static void tst_hits() {
+    polynomial::numeral_manager nm;
+    reslimit rl; polynomial::manager m(rl, nm);
+    polynomial_ref x0(m), x1(m), p(m), q(m);
+    x0 = m.mk_polynomial(m.mk_var());
+    x1 = m.mk_polynomial(m.mk_var());
+    polynomial::cache c(m);
+    polynomial_ref_vector fs1(m), fs2(m), S1(m), S2(m);
+    p = (x0^2) - (x1^2);
+    q = x0*x1 + 1;
+    c.factor(p, fs1);
+    c.factor(p, fs2);
+    ENSURE(fs1.size() == 2 && fs2.size() == 2);
+    ENSURE(fs1.get(0) == fs2.get(0) && fs1.get(1) == fs2.get(1));
+    c.psc_chain(p, q, 0, S1);
+    c.psc_chain(p, q, 0, S2);
+    ENSURE(S1.size() == S2.size());
+    for (unsigned i = 0; i < S1.size(); ++i)
+        ENSURE(S1.get(i) == S2.get(i));
+    ENSURE(get_stat(c, "polynomial cache factor hits") == 1);
+    ENSURE(get_stat(c, "polynomial cache factor misses") == 1);
+    ENSURE(get_stat(c, "polynomial cache psc hits") == 1);
+    ENSURE(get_stat(c, "polynomial cache psc misses") == 1);
+    ENSURE(get_stat(c, "polynomial cache flushes") == 0);
+}
+
+static void tst_flush() {
+    polynomial::numeral_manager nm;
+    reslimit rl; polynomial::manager m(rl, nm);
+    polynomial_ref x0(m), x1(m), p(m), q(m);
+    x0 = m.mk_polynomial(m.mk_var());
+    x1 = m.mk_polynomial(m.mk_var());
+    polynomial::cache c(m);
+    c.set_max_entries(8);
+    polynomial_ref_vector kept(m), fs(m);
+    for (unsigned i = 0; i < 40; ++i) {
+        p = (x0^2) + static_cast<int>(i + 1)*x1 + 1;
+        c.factor(p, fs);
+        if (i < 3)
+            kept.push_back(c.mk_unique(p));
+    }
+    statistics st;
+    c.collect_statistics(st);
+    st.display(std::cout);
+    ENSURE(get_stat(st, "polynomial cache factor misses") == 40);
+    ENSURE(get_stat(st, "polynomial cache flushes") >= 4);
+    ENSURE(get_stat(st, "polynomial cache collected") > 0);
+    // the polynomials referenced by the client are still unique.
+    for (unsigned i = 0; i < kept.size(); ++i) {
+        q = (x0^2) + static_cast<int>(i + 1)*x1 + 1;
+        ENSURE(q.get() != kept.get(i));
+        ENSURE(c.mk_unique(q) == kept.get(i));
+    }
+}
+
+void tst_polynomial_cache() {
+    tst_hits();
+    tst_flush();
+}
@@ -0,0 +1,225 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    qe_mbp.cpp
+
+Abstract:
+
+    Reuse of cached model-based projections. A cached projection may
+    only be returned for a model that satisfies it, and it must imply
+    the existential closure of the projected formulas.
+    Also measures the latency of qsat rounds on exists-forall
+    families over LRA and LIA, with and without the cache. qsat
+    blocks every projection it returns, so the cache is not expected
+    to hit there.
+
+--*/
+
+#include "qe_mbp.h"
+#include "qsat.h"
+#include "smt_kernel.h"
+#include "smt_params.h"
+#include "arith_decl_plugin.h"
+#include "reg_decl_plugins.h"
+#include "expr_abstract.h"
+#include "model.h"
+#include "stopwatch.h"
+#include "statistics.h"
+
+static unsigned get_stat(statistics const & st, char const * key) {
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+static bool holds(model & mdl, expr_ref_vector const & fmls) {
+    ast_manager & m = fmls.get_manager();
+    expr_ref val(m);
+    for (unsigned i = 0; i < fmls.size(); ++i) {
+        if (!mdl.eval(fmls[i], val) || !m.is_true(val))
+            return false;
+    }
+    return true;
+}
+
+static unsigned get_stat_hits(qe::mbp const & mbp) {
+    statistics st;
+    mbp.collect_statistics(st);
+    return get_stat(st, "mbp projection cache hits");
+}
+
+// proj implies exists x . fmls, if proj and not exists x . fmls is unsat.
+static bool implies(expr_ref_vector const & proj, expr * exists_fmls) {
+    ast_manager & m = proj.get_manager();
+    smt_params fp;
+    smt::kernel solver(m, fp);
+    solver.assert_expr(proj);
+    solver.assert_expr(m.mk_not(exists_fmls));
+    return solver.check() == l_false;
+}
+
+/**
+   Project x from (x > y or x > u) and x < z. The projection uses the
+   disjunct that is true in the model, so it depends on the model.
+   exists x . fmls is y < z or u < z.
+*/
+static void tst_cache_reuse() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    app_ref x(m.mk_const(symbol("x"), a.mk_real()), m);
+    app_ref y(m.mk_const(symbol("y"), a.mk_real()), m);
+    app_ref u(m.mk_const(symbol("u"), a.mk_real()), m);
+    app_ref z(m.mk_const(symbol("z"), a.mk_real()), m);
+    expr_ref_vector fmls(m);
+    fmls.push_back(m.mk_or(a.mk_gt(x, y), a.mk_gt(x, u)));
+    fmls.push_back(a.mk_lt(x, z));
+    expr_ref exists_fmls(m.mk_or(a.mk_lt(y, z), a.mk_lt(u, z)), m);
+
+    // values of x, y, u, z. The second model satisfies the projection
+    // of the first, the third one does not.
+    int values[3][4] = { { 1, 0, 5, 2 }, { 5, 3, 10, 10 }, { 5, 12, 3, 10 } };
+    bool hit[3] = { false, true, false };
+    app * consts[4] = { x, y, u, z };
+    qe::mbp mbp(m);
+    expr_ref_vector first(m);
+    for (unsigned i = 0; i < 3; ++i) {
+        model mdl(m);
+        for (unsigned j = 0; j < 4; ++j)
+            mdl.register_decl(consts[j]->get_decl(), a.mk_numeral(rational(values[i][j]), false));
+        app_ref_vector vars(m);
+        vars.push_back(x);
+        expr_ref_vector proj(fmls);
+        unsigned hits = get_stat_hits(mbp);
+        mbp(true, vars, mdl, proj);
+        std::cout << "model " << i << ": " << proj << "\n";
+        ENSURE(vars.empty());
+        ENSURE(holds(mdl, proj));
+        ENSURE(implies(proj, exists_fmls));
+        ENSURE((get_stat_hits(mbp) > hits) == hit[i]);
+        if (i == 0)
+            first.append(proj);
+        else if (hit[i])
+            ENSURE(proj.size() == first.size());
+    }
+
+    // without the cache every projection is computed.
+    qe::mbp mbp2(m);
+    mbp2.set_max_projections(0);
+    for (unsigned i = 0; i < 3; ++i) {
+        model mdl(m);
+        for (unsigned j = 0; j < 4; ++j)
+            mdl.register_decl(consts[j]->get_decl(), a.mk_numeral(rational(values[i][j]), false));
+        app_ref_vector vars(m);
+        vars.push_back(x);
+        expr_ref_vector proj(fmls);
+        mbp2(true, vars, mdl, proj);
+        ENSURE(holds(mdl, proj));
+        ENSURE(implies(proj, exists_fmls));
+    }
+    ENSURE(get_stat_hits(mbp2) == 0);
+}
+
+// exists xs forall ys . a disjunction of conjunctions of random linear
+// constraints. The variables range over [-4, 4], otherwise qsat need not
+// terminate on the integer instances.
+static expr_ref mk_exists_forall(ast_manager & m, random_gen & rand, bool is_int) {
+    arith_util a(m);
+    sort * s = is_int ? a.mk_int() : a.mk_real();
+    unsigned num_x = 3, num_y = 2, num_disjs = 6;
+    expr_ref_vector xs(m), ys(m), disjs(m), bounds(m);
+    ptr_vector<sort> sorts;
+    svector<symbol> names;
+    for (unsigned i = 0; i < num_x; ++i)
+        xs.push_back(m.mk_const(symbol(("x" + std::to_string(i)).c_str()), s));
+    for (unsigned i = 0; i < num_y; ++i) {
+        names.push_back(symbol(("y" + std::to_string(i)).c_str()));
+        ys.push_back(m.mk_const(names.back(), s));
+        sorts.push_back(s);
+    }
+    expr_ref_vector vs(xs);
+    vs.append(ys);
+    for (unsigned k = 0; k < ys.size(); ++k) {
+        bounds.push_back(a.mk_le(ys.get(k), a.mk_numeral(rational(4), is_int)));
+        bounds.push_back(a.mk_ge(ys.get(k), a.mk_numeral(rational(-4), is_int)));
+    }
+    disjs.push_back(m.mk_not(m.mk_and(bounds.size(), bounds.c_ptr())));
+    bounds.reset();
+    for (unsigned k = 0; k < xs.size(); ++k) {
+        bounds.push_back(a.mk_le(xs.get(k), a.mk_numeral(rational(4), is_int)));
+        bounds.push_back(a.mk_ge(xs.get(k), a.mk_numeral(rational(-4), is_int)));
+    }
+    for (unsigned i = 0; i < num_disjs; ++i) {
+        expr_ref_vector conjs(m);
+        for (unsigned j = 0; j < 2; ++j) {
+            expr_ref_vector terms(m);
+            for (unsigned k = 0; k < vs.size(); ++k) {
+                int c = static_cast<int>(rand(7)) - 3;
+                if (c != 0)
+                    terms.push_back(a.mk_mul(a.mk_numeral(rational(c), is_int), vs.get(k)));
+            }
+            expr_ref lhs(terms.empty() ? a.mk_numeral(rational(0), is_int) : a.mk_add(terms.size(), terms.c_ptr()), m);
+            conjs.push_back(a.mk_le(lhs, a.mk_numeral(rational(static_cast<int>(rand(11)) - 5), is_int)));
+        }
+        disjs.push_back(m.mk_and(conjs.size(), conjs.c_ptr()));
+    }
+    expr_ref body(m.mk_or(disjs.size(), disjs.c_ptr()), m), result(m);
+    expr_abstract(m, 0, ys.size(), ys.c_ptr(), body, result);
+    bounds.push_back(m.mk_forall(sorts.size(), sorts.c_ptr(), names.c_ptr(), result));
+    return expr_ref(m.mk_and(bounds.size(), bounds.c_ptr()), m);
+}
+
+static lbool run_qsat(ast_manager & m, expr * fml, unsigned max_projections, statistics & st, double & secs) {
+    params_ref p;
+    p.set_uint("max_projections", max_projections);
+    tactic_ref t = mk_qsat_tactic(m, p);
+    goal_ref g = alloc(goal, m);
+    g->assert_expr(fml);
+    model_ref md;
+    proof_ref pr(m);
+    expr_dependency_ref core(m);
+    std::string reason;
+    stopwatch timer;
+    timer.start();
+    lbool r = check_sat(*t, g, md, pr, core, reason);
+    timer.stop();
+    secs = timer.get_seconds();
+    t->collect_statistics(st);
+    return r;
+}
+
+static void tst_qsat_latency(bool is_int) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    random_gen rand(is_int ? 1 : 0);
+    unsigned rounds[2] = { 0, 0 }, hits = 0;
+    double secs[2] = { 0, 0 };
+    for (unsigned i = 0; i < 20; ++i) {
+        expr_ref fml = mk_exists_forall(m, rand, is_int);
+        lbool r[2];
+        for (unsigned c = 0; c < 2; ++c) {
+            statistics st;
+            double s;
+            r[c] = run_qsat(m, fml, c == 0 ? 0 : 1000, st, s);
+            rounds[c] += get_stat(st, "qsat num rounds");
+            secs[c] += s;
+            if (c == 1)
+                hits += get_stat(st, "mbp projection cache hits");
+        }
+        ENSURE(r[0] == r[1]);
+    }
+    std::cout << (is_int ? "LIA" : "LRA") << " exists-forall: rounds " << rounds[0] << "/" << rounds[1]
+              << " secs " << secs[0] << "/" << secs[1] << " cache hits " << hits
+              << " ms/round without cache " << (1000 * secs[0] / std::max(1u, rounds[0]))
+              << " with cache " << (1000 * secs[1] / std::max(1u, rounds[1])) << "\n";
+}
+
+void tst_qe_mbp() {
+    tst_cache_reuse();
+    tst_qsat_latency(false);
+    tst_qsat_latency(true);
+}
@@ -0,0 +1,76 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    qfbv_sls_portfolio.cpp
+
+Abstract:
+
+    Solve QF_BV goals with the qfbv-sls-portfolio tactic. On
+    satisfiable goals either branch may win and the model must
+    satisfy the goal. On unsatisfiable goals local search gives up,
+    so the systematic branch must provide the answer.
+
+--*/
+
+#include"qfbv_sls_portfolio_tactic.h"
+#include"tactic.h"
+#include"bv_decl_plugin.h"
+#include"reg_decl_plugins.h"
+#include"model.h"
+
+static lbool solve(goal_ref & g, model_ref & md) {
+    ast_manager & m = g->m();
+    tactic_ref t = mk_qfbv_sls_portfolio_tactic(m);
+    proof_ref pr(m);
+    expr_dependency_ref core(m);
+    std::string reason;
+    return check_sat(*t, g, md, pr, core, reason);
+}
+
+// c * x + y = d and x xor y = e have a solution when d and e are
+// computed from values of x and y. Adding x <= y, y <= x and x != y
+// makes the goal unsatisfiable.
+static void tst_portfolio(unsigned seed, bool is_sat) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    random_gen rand(seed);
+    unsigned sz = 16;
+    expr_ref x(m.mk_const(symbol("x"), bv.mk_sort(sz)), m);
+    expr_ref y(m.mk_const(symbol("y"), bv.mk_sort(sz)), m);
+    unsigned a = rand() & 0xffff, b = rand() & 0xffff, c = (rand() & 0xffff) | 1;
+    goal_ref g = alloc(goal, m, true);
+    g->assert_expr(m.mk_eq(bv.mk_bv_add(bv.mk_bv_mul(bv.mk_numeral(c, sz), x), y),
+                           bv.mk_numeral((c * a + b) & 0xffff, sz)));
+    expr * args[2] = { x, y };
+    g->assert_expr(m.mk_eq(bv.mk_bv_xor(2, args), bv.mk_numeral(a ^ b, sz)));
+    if (!is_sat) {
+        g->assert_expr(bv.mk_ule(x, y));
+        g->assert_expr(bv.mk_ule(y, x));
+        g->assert_expr(m.mk_not(m.mk_eq(x, y)));
+    }
+    expr_ref_vector fmls(m);
+    for (unsigned i = 0; i < g->size(); ++i)
+        fmls.push_back(g->form(i));
+    model_ref md;
+    lbool r = solve(g, md);
+    std::cout << "seed " << seed << ": " << r << "\n";
+    ENSURE(r == (is_sat ? l_true : l_false));
+    if (is_sat) {
+        ENSURE(md);
+        expr_ref val(m);
+        for (unsigned i = 0; i < fmls.size(); ++i) {
+            ENSURE(md->eval(fmls.get(i), val, true));
+            ENSURE(m.is_true(val));
+        }
+    }
+}
+
+void tst_qfbv_sls_portfolio() {
+    for (unsigned seed = 0; seed < 5; ++seed) {
+        tst_portfolio(seed, true);
+        tst_portfolio(seed, false);
+    }
+}
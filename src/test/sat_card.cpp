@@ -0,0 +1,204 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_card.cpp
+
+Abstract:
+
+    Compare native cardinality and pseudo-Boolean constraints in
+    the incremental SAT solver with their encodings into clauses.
+
+--*/
+
+#include <sstream>
+#include "inc_sat_solver.h"
+#include "fd_solver.h"
+#include "sat_card_extension.h"
+#include "pb_decl_plugin.h"
+#include "reg_decl_plugins.h"
+#include "model.h"
+#include "statistics.h"
+
+static ref<solver> mk_card_solver(ast_manager& m, bool native, bool fd = false) {
+    params_ref p;
+    p.set_bool("cardinality.solver", native);
+    p.set_uint("cardinality.min_size", 0);
+    return ref<solver>(fd ? mk_fd_solver(m, p) : mk_inc_sat_solver(m, p));
+}
+
+static unsigned get_stat(statistics const& st, char const* key) {
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0) {
+            return st.get_uint_value(i);
+        }
+    }
+    return 0;
+}
+
+static void mk_vars(ast_manager& m, char const* prefix, unsigned n, expr_ref_vector& vars) {
+    for (unsigned i = 0; i < n; ++i) {
+        std::stringstream strm;
+        strm << prefix << i;
+        vars.push_back(m.mk_const(symbol(strm.str().c_str()), m.mk_bool_sort()));
+    }
+}
+
+static void check_model(solver& s, expr_ref_vector const& fmls) {
+    ast_manager& m = fmls.get_manager();
+    model_ref mdl;
+    s.get_model(mdl);
+    ENSURE(mdl);
+    for (unsigned i = 0; i < fmls.size(); ++i) {
+        expr_ref val(m);
+        VERIFY(mdl->eval(fmls[i], val, true));
+        ENSURE(m.is_true(val));
+    }
+}
+
+// place num_pigeons pigeons into num_holes holes.
+// The fd solver is the solver used for SMT2 problems in QF_FD.
+static lbool pigeon_hole(bool native, unsigned num_pigeons, unsigned num_holes, bool fd = false) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    pb_util pb(m);
+    ref<solver> s = mk_card_solver(m, native, fd);
+    expr_ref_vector vars(m), fmls(m);
+    mk_vars(m, "p", num_pigeons * num_holes, vars);
+    for (unsigned i = 0; i < num_pigeons; ++i) {
+        fmls.push_back(pb.mk_at_least_k(num_holes, vars.c_ptr() + i * num_holes, 1));
+    }
+    for (unsigned j = 0; j < num_holes; ++j) {
+        ptr_vector<expr> hole;
+        for (unsigned i = 0; i < num_pigeons; ++i) {
+            hole.push_back(vars[i * num_holes + j].get());
+        }
+        fmls.push_back(pb.mk_at_most_k(hole.size(), hole.c_ptr(), 1));
+    }
+    for (unsigned i = 0; i < fmls.size(); ++i) {
+        s->assert_expr(fmls[i].get());
+    }
+    lbool r = s->check_sat(0, 0);
+    if (r == l_true) {
+        check_model(*s, fmls);
+    }
+    statistics st;
+    s->collect_statistics(st);
+    std::cout << "pigeons: " << num_pigeons << " holes: " << num_holes << " native: " << native << " fd: " << fd << " " << r << "\n";
+    st.display(std::cout);
+    if (native) {
+        ENSURE(get_stat(st, "cardinality propagations") > 0);
+        ENSURE(r != l_false || get_stat(st, "cardinality conflicts") > 0);
+    }
+    else {
+        ENSURE(get_stat(st, "cardinality propagations") == 0);
+    }
+    return r;
+}
+
+static app* mk_random_pb(pb_util& pb, random_gen& rand, expr_ref_vector const& vars) {
+    ast_manager& m = pb.get_manager();
+    ptr_vector<expr> args;
+    vector<rational> coeffs;
+    unsigned sum = 0;
+    unsigned n = 2 + rand(vars.size() - 1);
+    for (unsigned i = 0; i < n; ++i) {
+        expr* v = vars[rand(vars.size())];
+        args.push_back(rand(2) == 0 ? v : m.mk_not(v));
+        unsigned c = 1 + rand(4);
+        coeffs.push_back(rational(c));
+        sum += c;
+    }
+    rational k(rand(sum + 1));
+    switch (rand(5)) {
+    case 0: return pb.mk_ge(n, coeffs.c_ptr(), args.c_ptr(), k);
+    case 1: return pb.mk_le(n, coeffs.c_ptr(), args.c_ptr(), k);
+    case 2: return pb.mk_eq(n, coeffs.c_ptr(), args.c_ptr(), k);
+    case 3: return pb.mk_at_least_k(n, args.c_ptr(), rand(n + 1));
+    default: return pb.mk_at_most_k(n, args.c_ptr(), rand(n + 1));
+    }
+}
+
+// random pseudo-Boolean constraints, possibly nested under
+// Boolean connectives, asserted in nested scopes.
+static void random_pb(unsigned seed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    pb_util pb(m);
+    random_gen rand(seed);
+    ref<solver> s1 = mk_card_solver(m, true);
+    ref<solver> s2 = mk_card_solver(m, false);
+    expr_ref_vector vars(m), fmls(m);
+    mk_vars(m, "x", 8, vars);
+    unsigned_vector lim;
+    for (unsigned i = 0; i < 40; ++i) {
+        expr_ref f(mk_random_pb(pb, rand, vars), m);
+        switch (rand(4)) {
+        case 0: f = m.mk_not(f); break;
+        case 1: f = m.mk_or(f, mk_random_pb(pb, rand, vars)); break;
+        default: break;
+        }
+        if (rand(4) == 0) {
+            s1->push();
+            s2->push();
+            lim.push_back(fmls.size());
+        }
+        fmls.push_back(f);
+        s1->assert_expr(f);
+        s2->assert_expr(f);
+        lbool r1 = s1->check_sat(0, 0);
+        lbool r2 = s2->check_sat(0, 0);
+        ENSURE(r1 == r2);
+        if (r1 == l_true) {
+            check_model(*s1, fmls);
+        }
+        if (r1 == l_false) {
+            if (lim.empty()) {
+                break;
+            }
+            s1->pop(1);
+            s2->pop(1);
+            fmls.shrink(lim.back());
+            lim.pop_back();
+        }
+    }
+}
+
+// constraints that contain their own reification literal.
+static void self_reference() {
+    for (unsigned neg = 0; neg < 2; ++neg) {
+        params_ref p;
+        reslimit rlim;
+        sat::solver s(p, rlim, 0);
+        sat::literal l(s.mk_var(), false), a(s.mk_var(), false), b(s.mk_var(), false);
+        sat::card_extension* ext = alloc(sat::card_extension);
+        s.set_extension(ext);
+        sat::literal_vector lits;
+        lits.push_back(neg ? ~l : l);
+        lits.push_back(a);
+        lits.push_back(b);
+        // l => ~l + a + b >= 2, that is, a and b.
+        // l => l + a + b >= 2, that is, a or b.
+        ext->add_at_least(l, lits, 2);
+        s.mk_clause(1, &l);
+        sat::literal asms[2] = { ~b, ~a };
+        ENSURE(s.check(1, asms) == (neg ? l_false : l_true));
+        ENSURE(s.check(2, asms) == l_false);
+        ENSURE(s.check() == l_true);
+        ENSURE(!neg || (s.get_model()[a.var()] == l_true && s.get_model()[b.var()] == l_true));
+    }
+}
+
+void tst_sat_card() {
+    self_reference();
+    for (unsigned n = 4; n <= 7; ++n) {
+        VERIFY(pigeon_hole(true, n, n) == l_true);
+        VERIFY(pigeon_hole(true, n + 1, n) == l_false);
+        VERIFY(pigeon_hole(false, n + 1, n) == l_false);
+        VERIFY(pigeon_hole(true, n + 1, n, true) == l_false);
+    }
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        random_pb(seed);
+    }
+}
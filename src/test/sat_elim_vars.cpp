@@ -0,0 +1,108 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_elim_vars.cpp
+
+Abstract:
+
+    Variable elimination in the SAT simplifier with several threads
+    must eliminate the same variables as the sequential elimination.
+    Random problems are solved with resolution.threads set to 1, 2
+    and 4, and the results and statistics are compared.
+
+--*/
+
+#include "sat_solver.h"
+#include "statistics.h"
+#include "util.h"
+
+typedef vector<sat::literal_vector> clauses_t;
+
+// a random 3-SAT problem over core_vars variables, which requires some
+// conflicts, together with sparse clauses over extra_vars variables,
+// most of which can be eliminated.
+static void mk_problem(random_gen& rand, unsigned core_vars, unsigned extra_vars, clauses_t& clauses) {
+    unsigned num_vars = core_vars + extra_vars;
+    for (unsigned i = 0; i < core_vars * 426 / 100; ++i) {
+        sat::literal_vector cls;
+        while (cls.size() < 3) {
+            sat::literal l(rand(core_vars), rand(2) == 0);
+            if (!cls.contains(l) && !cls.contains(~l)) cls.push_back(l);
+        }
+        clauses.push_back(cls);
+    }
+    for (unsigned i = 0; i < extra_vars * 3 / 2; ++i) {
+        sat::literal_vector cls;
+        unsigned len = 3 + rand(2);
+        while (cls.size() < len) {
+            sat::literal l(rand(num_vars), rand(2) == 0);
+            if (!cls.contains(l) && !cls.contains(~l)) cls.push_back(l);
+        }
+        clauses.push_back(cls);
+    }
+}
+
+static bool is_model(clauses_t const& clauses, sat::model const& mdl) {
+    for (unsigned i = 0; i < clauses.size(); ++i) {
+        bool sat = false;
+        for (unsigned j = 0; !sat && j < clauses[i].size(); ++j) {
+            sat::literal l = clauses[i][j];
+            sat = mdl[l.var()] == (l.sign() ? l_false : l_true);
+        }
+        if (!sat) return false;
+    }
+    return true;
+}
+
+static lbool solve(unsigned num_vars, clauses_t const& clauses, unsigned num_threads, statistics& st) {
+    params_ref p;
+    p.set_uint("resolution.threads", num_threads);
+    // simplify after a few hundred conflicts.
+    p.set_uint("restart.initial", 1);
+    reslimit rlim;
+    sat::solver s(p, rlim, 0);
+    for (unsigned i = 0; i < num_vars; ++i) {
+        s.mk_var();
+    }
+    for (unsigned i = 0; i < clauses.size(); ++i) {
+        sat::literal_vector cls(clauses[i]);
+        s.mk_clause(cls.size(), cls.c_ptr());
+    }
+    lbool r = s.check();
+    if (r == l_true) {
+        ENSURE(is_model(clauses, s.get_model()));
+    }
+    s.collect_statistics(st);
+    return r;
+}
+
+static void check_same(statistics const& st1, statistics const& st2) {
+    ENSURE(st1.size() == st2.size());
+    for (unsigned i = 0; i < st1.size(); ++i) {
+        ENSURE(strcmp(st1.get_key(i), st2.get_key(i)) == 0);
+        if (st1.is_uint(i)) {
+            ENSURE(st1.get_uint_value(i) == st2.get_uint_value(i));
+        }
+    }
+}
+
+void tst_sat_elim_vars() {
+    random_gen rand(0);
+    for (unsigned i = 0; i < 6; ++i) {
+        clauses_t clauses;
+        unsigned core_vars = 150, extra_vars = 2000;
+        mk_problem(rand, core_vars, extra_vars, clauses);
+        statistics st1;
+        lbool r1 = solve(core_vars + extra_vars, clauses, 1, st1);
+        std::cout << "problem " << i << ": " << r1 << "\n";
+        st1.display(std::cout);
+        for (unsigned num_threads = 2; num_threads <= 4; num_threads *= 2) {
+            statistics st2;
+            lbool r2 = solve(core_vars + extra_vars, clauses, num_threads, st2);
+            ENSURE(r1 == r2);
+            check_same(st1, st2);
+        }
+    }
+}
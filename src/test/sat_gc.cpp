@@ -0,0 +1,82 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_gc.cpp
+
+Abstract:
+
+    Garbage collection of learned clauses with the tiers strategy.
+    Random 3-SAT problems at the threshold are solved with frequent
+    gc rounds. The results must not change, and the clauses of the
+    core tier are deleted only when there are more than
+    gc.tier1_max of them.
+
+--*/
+
+#include "sat_solver.h"
+#include "statistics.h"
+#include "util.h"
+
+static unsigned get_stat(statistics const & st, char const * key) {
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+static lbool solve(unsigned seed, params_ref const & p, statistics & st) {
+    random_gen rand(seed);
+    unsigned num_vars = 150;
+    reslimit rlim;
+    sat::solver s(p, rlim, 0);
+    for (unsigned i = 0; i < num_vars; ++i) {
+        s.mk_var();
+    }
+    for (unsigned i = 0; i < num_vars * 426 / 100; ++i) {
+        sat::literal_vector cls;
+        while (cls.size() < 3) {
+            sat::literal l(rand(num_vars), rand(2) == 0);
+            if (!cls.contains(l) && !cls.contains(~l)) cls.push_back(l);
+        }
+        s.mk_clause(cls.size(), cls.c_ptr());
+    }
+    lbool r = s.check();
+    s.collect_statistics(st);
+    return r;
+}
+
+void tst_sat_gc() {
+    params_ref p;
+    p.set_uint("gc.initial", 200);
+    p.set_uint("gc.increment", 50);
+    for (unsigned seed = 0; seed < 3; ++seed) {
+        statistics st1, st2, st3, st4;
+        params_ref p1(p);
+        p1.set_sym("gc", symbol("glue_psm"));
+        lbool r1 = solve(seed, p1, st1);
+        params_ref p2(p);
+        p2.set_sym("gc", symbol("tiers"));
+        lbool r2 = solve(seed, p2, st2);
+        // every learned clause is in the core tier.
+        params_ref p3(p2);
+        p3.set_uint("gc.tier1_glue", UINT_MAX);
+        p3.set_uint("gc.tier1_max", UINT_MAX);
+        lbool r3 = solve(seed, p3, st3);
+        params_ref p4(p3);
+        p4.set_uint("gc.tier1_max", 100);
+        lbool r4 = solve(seed, p4, st4);
+        std::cout << "problem " << seed << ": " << r1
+                  << " conflicts: " << get_stat(st2, "conflicts")
+                  << " gc glue_psm: " << get_stat(st1, "gc clause")
+                  << " tiers: " << get_stat(st2, "gc clause")
+                  << " core only: " << get_stat(st3, "gc clause")
+                  << " capped core: " << get_stat(st4, "gc clause") << "\n";
+        ENSURE(r1 == r2 && r2 == r3 && r3 == r4);
+        ENSURE(get_stat(st2, "gc clause") > 0);
+        ENSURE(get_stat(st3, "gc clause") == 0);
+        ENSURE(get_stat(st4, "gc clause") > 0);
+    }
+}
@@ -0,0 +1,78 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_inprocessing.cpp
+
+Abstract:
+
+    Scheduling of the inprocessing techniques. Random 3-SAT problems
+    at the threshold are solved with frequent simplifications.
+    Techniques that are never effective enough must be skipped, and
+    asymmetric branching must strengthen learned clauses.
+
+--*/
+
+#include "sat_solver.h"
+#include "statistics.h"
+#include "util.h"
+
+static unsigned get_stat(statistics const & st, char const * key) {
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+static lbool solve(unsigned seed, params_ref const & p, statistics & st) {
+    random_gen rand(seed);
+    unsigned num_vars = 160;
+    reslimit rlim;
+    sat::solver s(p, rlim, 0);
+    for (unsigned i = 0; i < num_vars; ++i) {
+        s.mk_var();
+    }
+    for (unsigned i = 0; i < num_vars * 426 / 100; ++i) {
+        sat::literal_vector cls;
+        while (cls.size() < 3) {
+            sat::literal l(rand(num_vars), rand(2) == 0);
+            if (!cls.contains(l) && !cls.contains(~l)) cls.push_back(l);
+        }
+        s.mk_clause(cls.size(), cls.c_ptr());
+    }
+    lbool r = s.check();
+    s.collect_statistics(st);
+    return r;
+}
+
+void tst_sat_inprocessing() {
+    params_ref p;
+    // simplify every few hundred conflicts.
+    p.set_uint("restart.initial", 10);
+    p.set_uint("simplify_mult1", 100);
+    p.set_double("simplify_mult2", 1.1);
+    p.set_uint("simplify_max", 200);
+    unsigned skips = 0, elim_learned = 0;
+    for (unsigned seed = 0; seed < 3; ++seed) {
+        statistics st1, st2, st3;
+        // no technique removes a thousand literals per tick.
+        params_ref p1(p);
+        p1.set_double("inprocess.min_effectiveness", 1e9);
+        lbool r1 = solve(seed, p1, st1);
+        params_ref p2(p1);
+        p2.set_bool("inprocess.adaptive", false);
+        lbool r2 = solve(seed, p2, st2);
+        lbool r3 = solve(seed, p, st3);
+        std::cout << "problem " << seed << ": " << r1
+                  << " skips: " << get_stat(st1, "inprocess skips")
+                  << " elim learned literals: " << get_stat(st3, "elim learned literals") << "\n";
+        ENSURE(r1 == r2 && r2 == r3);
+        ENSURE(get_stat(st2, "inprocess skips") == 0);
+        skips += get_stat(st1, "inprocess skips");
+        elim_learned += get_stat(st3, "elim learned literals");
+    }
+    ENSURE(skips > 0);
+    ENSURE(elim_learned > 0);
+}
@@ -0,0 +1,254 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sat_xor.cpp
+
+Abstract:
+
+    Parity problems for XOR detection and Gauss-Jordan elimination
+    in the SAT solver. Every problem is solved with and without
+    xor.solver, and the results, run times and statistics are
+    displayed.
+
+--*/
+
+#include "sat_solver.h"
+#include "stopwatch.h"
+#include "statistics.h"
+#include "util.h"
+
+typedef vector<sat::literal_vector> clauses_t;
+
+struct parity_problem {
+    unsigned  m_num_vars;
+    clauses_t m_clauses;
+    parity_problem():m_num_vars(0) {}
+
+    unsigned mk_var() { return m_num_vars++; }
+
+    // add the clauses of vars[0] xor ... xor vars[n-1] = rhs.
+    void add_xor_core(sat::bool_var_vector const& vars, bool rhs) {
+        unsigned n = vars.size();
+        for (unsigned mask = 0; mask < (1u << n); ++mask) {
+            // the clause excludes the assignment where the variables
+            // in mask are true. It has the wrong parity if the number
+            // of true variables differs from rhs modulo 2.
+            if ((get_num_1bits(mask) % 2 == 1) == rhs)
+                continue;
+            m_clauses.push_back(sat::literal_vector());
+            for (unsigned i = 0; i < n; ++i) {
+                m_clauses.back().push_back(sat::literal(vars[i], (mask & (1u << i)) != 0));
+            }
+        }
+    }
+
+    // add a long XOR constraint split into XOR constraints over
+    // at most 4 variables: x + y + z + rest = rhs is replaced by
+    // x + y + z + a = 0 and a + rest = rhs.
+    void add_xor(sat::bool_var_vector vars, bool rhs) {
+        while (vars.size() > 4) {
+            sat::bool_var_vector chunk;
+            for (unsigned i = 0; i < 3; ++i) {
+                chunk.push_back(vars.back());
+                vars.pop_back();
+            }
+            sat::bool_var a = mk_var();
+            chunk.push_back(a);
+            add_xor_core(chunk, false);
+            vars.push_back(a);
+        }
+        add_xor_core(vars, rhs);
+    }
+};
+
+// num_xors random XOR constraints of length len over num_vars variables.
+static void mk_random_xors(random_gen& rand, unsigned num_vars, unsigned num_xors, unsigned len, parity_problem& p) {
+    for (unsigned i = 0; i < num_vars; ++i) {
+        p.mk_var();
+    }
+    for (unsigned i = 0; i < num_xors; ++i) {
+        sat::bool_var_vector vars;
+        while (vars.size() < len) {
+            sat::bool_var v = rand(num_vars);
+            if (!vars.contains(v)) vars.push_back(v);
+        }
+        p.add_xor(vars, rand(2) == 1);
+    }
+}
+
+// random XOR constraints together with random ternary clauses.
+static void mk_mixed(random_gen& rand, unsigned num_vars, parity_problem& p) {
+    mk_random_xors(rand, num_vars, num_vars / 2, 5, p);
+    for (unsigned i = 0; i < 5 * num_vars / 2; ++i) {
+        sat::bool_var_vector vars;
+        while (vars.size() < 3) {
+            sat::bool_var v = rand(num_vars);
+            if (!vars.contains(v)) vars.push_back(v);
+        }
+        sat::literal_vector cls;
+        for (unsigned j = 0; j < 3; ++j) {
+            cls.push_back(sat::literal(vars[j], rand(2) == 0));
+        }
+        p.m_clauses.push_back(cls);
+    }
+}
+
+// Tseitin formula of a random graph with n vertices of degree deg:
+// the edges incident to a vertex sum up to its charge. The formula
+// is unsatisfiable if the sum of the charges is odd.
+static void mk_tseitin(random_gen& rand, unsigned n, unsigned deg, parity_problem& p) {
+    vector<sat::bool_var_vector> incident;
+    incident.resize(n);
+    unsigned_vector stubs;
+    for (unsigned v = 0; v < n; ++v) {
+        for (unsigned j = 0; j < deg; ++j) {
+            stubs.push_back(v);
+        }
+    }
+    shuffle(stubs.size(), stubs.c_ptr(), rand);
+    for (unsigned i = 0; i + 1 < stubs.size(); i += 2) {
+        unsigned u = stubs[i], v = stubs[i + 1];
+        if (u == v) continue;
+        sat::bool_var e = p.mk_var();
+        incident[u].push_back(e);
+        incident[v].push_back(e);
+    }
+    bool charged = false;
+    for (unsigned v = 0; v < n; ++v) {
+        if (incident[v].empty()) continue;
+        p.add_xor_core(incident[v], !charged);
+        charged = true;
+    }
+}
+
+static bool is_model(parity_problem const& p, sat::model const& mdl) {
+    for (unsigned i = 0; i < p.m_clauses.size(); ++i) {
+        bool sat = false;
+        for (unsigned j = 0; !sat && j < p.m_clauses[i].size(); ++j) {
+            sat::literal l = p.m_clauses[i][j];
+            sat = mdl[l.var()] == (l.sign() ? l_false : l_true);
+        }
+        if (!sat) return false;
+    }
+    return true;
+}
+
+static lbool solve(char const* name, parity_problem const& p, bool use_xor) {
+    params_ref params;
+    params.set_bool("xor.solver", use_xor);
+    reslimit rlim;
+    sat::solver s(params, rlim, 0);
+    for (unsigned i = 0; i < p.m_num_vars; ++i) {
+        s.mk_var();
+    }
+    for (unsigned i = 0; i < p.m_clauses.size(); ++i) {
+        sat::literal_vector cls(p.m_clauses[i]);
+        s.mk_clause(cls.size(), cls.c_ptr());
+    }
+    stopwatch sw;
+    sw.start();
+    lbool r = s.check();
+    sw.stop();
+    if (r == l_true) {
+        ENSURE(is_model(p, s.get_model()));
+    }
+    statistics st;
+    s.collect_statistics(st);
+    std::cout << name << " vars: " << p.m_num_vars << " clauses: " << p.m_clauses.size()
+              << " xor.solver: " << (use_xor ? "true" : "false") << " " << r
+              << " time: " << sw.get_seconds() << "s\n";
+    st.display(std::cout);
+    return r;
+}
+
+static void compare(char const* name, parity_problem const& p) {
+    lbool r1 = solve(name, p, true);
+    lbool r2 = solve(name, p, false);
+    ENSURE(r1 == r2);
+}
+
+// XOR constraints with random units and user scopes, compared with
+// a solver that does not detect XOR constraints.
+static void random_scopes(unsigned seed) {
+    random_gen rand(seed);
+    parity_problem p;
+    mk_random_xors(rand, 12, 10, 3 + rand(4), p);
+    params_ref p1, p2;
+    p1.set_bool("xor.solver", true);
+    p2.set_bool("xor.solver", false);
+    reslimit rlim;
+    sat::solver s1(p1, rlim, 0), s2(p2, rlim, 0);
+    for (unsigned i = 0; i < p.m_num_vars; ++i) {
+        s1.mk_var();
+        s2.mk_var();
+    }
+    for (unsigned i = 0; i < p.m_clauses.size(); ++i) {
+        sat::literal_vector cls(p.m_clauses[i]);
+        s1.mk_clause(cls.size(), cls.c_ptr());
+        s2.mk_clause(cls.size(), cls.c_ptr());
+    }
+    for (unsigned i = 0; i < 10; ++i) {
+        s1.user_push();
+        s2.user_push();
+        for (unsigned j = 0; j < 1 + rand(4); ++j) {
+            sat::literal l(rand(12), rand(2) == 0);
+            s1.mk_clause(1, &l);
+            s2.mk_clause(1, &l);
+        }
+        lbool r1 = s1.check();
+        lbool r2 = s2.check();
+        ENSURE(r1 == r2);
+        if (r1 == l_true) {
+            ENSURE(is_model(p, s1.get_model()));
+        }
+        s1.user_pop(1);
+        s2.user_pop(1);
+    }
+}
+
+// the XOR and cardinality constraints would compete for the single
+// extension of the solver.
+static void reject_cardinality_solver() {
+    params_ref params;
+    params.set_bool("xor.solver", true);
+    params.set_bool("cardinality.solver", true);
+    reslimit rlim;
+    bool rejected = false;
+    try {
+        sat::solver s(params, rlim, 0);
+    }
+    catch (sat::sat_param_exception& ex) {
+        std::cout << ex.msg() << "\n";
+        rejected = true;
+    }
+    ENSURE(rejected);
+}
+
+void tst_sat_xor() {
+    reject_cardinality_solver();
+    random_gen rand(0);
+    for (unsigned n = 16; n <= 32; n += 8) {
+        // under- and over-determined systems of long XOR constraints.
+        parity_problem p1, p2;
+        mk_random_xors(rand, n, n - 2, 10, p1);
+        compare("random-xor", p1);
+        mk_random_xors(rand, n, n + 2, 10, p2);
+        compare("random-xor", p2);
+    }
+    for (unsigned i = 0; i < 20; ++i) {
+        parity_problem p;
+        mk_mixed(rand, 40, p);
+        compare("mixed", p);
+    }
+    for (unsigned n = 16; n <= 32; n += 8) {
+        parity_problem p;
+        mk_tseitin(rand, n, 4, p);
+        VERIFY(solve("tseitin", p, true) == l_false);
+        VERIFY(solve("tseitin", p, false) == l_false);
+    }
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        random_scopes(seed);
+    }
+}
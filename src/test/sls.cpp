@@ -0,0 +1,115 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    sls.cpp
+
+Abstract:
+
+    Local search for bit-vectors with values stored as mpz and with
+    values of Booleans and bit-vectors of at most 64 bits stored as
+    machine words. Both must take the same moves, and the number of
+    moves per second (flips/sec) is reported for each.
+
+--*/
+
+#include"sls_engine.h"
+#include"bv_decl_plugin.h"
+#include"reg_decl_plugins.h"
+#include"stopwatch.h"
+#include"statistics.h"
+
+static unsigned get_stat(statistics const & st, char const * key) {
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+static uint64 rand_word(random_gen & rand) {
+    return (static_cast<uint64>(rand()) << 17) ^ (static_cast<uint64>(rand()) << 8) ^ rand();
+}
+
+// Random constraints over 32-bit variables that hold for a hidden assignment.
+static void mk_problem(unsigned seed, bv_util & bv, goal & g) {
+    ast_manager & m = g.m();
+    random_gen rand(seed);
+    unsigned num_vars = 12, sz = 32;
+    uint64 mask = 0xffffffff;
+    expr_ref_vector xs(m);
+    svector<uint64> vals;
+    for (unsigned i = 0; i < num_vars; ++i) {
+        std::string name = "x" + std::to_string(i);
+        xs.push_back(m.mk_const(symbol(name.c_str()), bv.mk_sort(sz)));
+        vals.push_back(rand_word(rand) & mask);
+    }
+    for (unsigned k = 0; k < 3 * num_vars; ++k) {
+        unsigned i = rand(num_vars), j = rand(num_vars);
+        expr * x = xs.get(i), * y = xs.get(j);
+        uint64 a = vals[i], b = vals[j];
+        uint64 c = rand_word(rand) | 1;
+        unsigned sh = rand(sz);
+        expr * args[2] = { 0, y };
+        switch (k % 4) {
+        case 0:
+            g.assert_expr(m.mk_eq(bv.mk_bv_add(bv.mk_bv_mul(bv.mk_numeral(c & mask, sz), x), y),
+                                  bv.mk_numeral((c * a + b) & mask, sz)));
+            break;
+        case 1:
+            args[0] = bv.mk_bv_lshr(x, bv.mk_numeral(sh, sz));
+            g.assert_expr(m.mk_eq(bv.mk_bv_xor(2, args), bv.mk_numeral((a >> sh) ^ b, sz)));
+            break;
+        case 2:
+            args[0] = x;
+            g.assert_expr(bv.mk_ule(bv.mk_numeral(a | b, sz), bv.mk_bv_or(2, args)));
+            break;
+        default:
+            g.assert_expr(bv.mk_ule(bv.mk_bv_sub(x, y), bv.mk_numeral((a - b) & mask, sz)));
+            break;
+        }
+    }
+}
+
+static void tst_sls(unsigned seed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    unsigned moves[2], word_evals[2];
+    lbool results[2];
+    double secs[2];
+    for (unsigned words = 0; words < 2; ++words) {
+        params_ref p;
+        p.set_uint("random_seed", seed);
+        p.set_uint("max_restarts", 2);
+        p.set_uint("restart_base", 500);
+        p.set_bool("word_values", words == 1);
+        goal_ref g = alloc(goal, m);
+        mk_problem(seed, bv, *g);
+        sls_engine engine(m, p);
+        for (unsigned i = 0; i < g->size(); ++i)
+            engine.assert_expr(g->form(i));
+        stopwatch timer;
+        timer.start();
+        results[words] = engine();
+        timer.stop();
+        statistics st;
+        engine.collect_statistics(st);
+        moves[words]      = get_stat(st, "sls moves");
+        word_evals[words] = get_stat(st, "sls word evals");
+        secs[words]       = timer.get_seconds();
+    }
+    std::cout << "problem " << seed << ": " << results[1] << " moves: " << moves[1]
+              << " flips/sec mpz: " << (moves[0] / secs[0])
+              << " words: " << (moves[1] / secs[1]) << "\n";
+    ENSURE(results[0] == results[1]);
+    ENSURE(moves[0] == moves[1]);
+    ENSURE(word_evals[0] == 0);
+    ENSURE(word_evals[1] > 0);
+}
+
+void tst_sls() {
+    for (unsigned seed = 0; seed < 3; ++seed)
+        tst_sls(seed);
+}
@@ -0,0 +1,107 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    strategy_selector.cpp
+
+Abstract:
+
+    Loading of strategy selector models and selection of strategies.
+    Malformed models must be reported when the tactic is created.
+
+--*/
+
+#include<fstream>
+#include"strategy_selector_tactic.h"
+#include"tactic.h"
+#include"arith_decl_plugin.h"
+#include"reg_decl_plugins.h"
+#include"statistics.h"
+
+static char const * g_model_file = "strategy_selector_model.txt";
+
+static void write_model(char const * model) {
+    std::ofstream out(g_model_file);
+    out << model;
+}
+
+static params_ref mk_params() {
+    params_ref p;
+    p.set_str("model", g_model_file);
+    return p;
+}
+
+static bool is_selected(tactic & t, char const * name) {
+    statistics st;
+    t.collect_statistics(st);
+    std::string key = std::string("selected ") + name;
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && key == st.get_key(i))
+            return st.get_uint_value(i) > 0;
+    }
+    return false;
+}
+
+static lbool solve(tactic & t, goal_ref & g) {
+    model_ref md;
+    proof_ref pr(g->m());
+    expr_dependency_ref core(g->m());
+    std::string reason;
+    return check_sat(t, g, md, pr, core, reason);
+}
+
+static void tst_select() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    write_model("# lia goals use qflia, all other goals use smt\n"
+                "node 0 is_qflia 0.5 1 2\n"
+                "leaf 1 smt\n"
+                "leaf 2 qflia\n");
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref y(m.mk_const(symbol("y"), a.mk_real()), m);
+
+    tactic_ref t1 = mk_strategy_selector_tactic(m, mk_params());
+    goal_ref g1 = alloc(goal, m);
+    g1->assert_expr(a.mk_gt(x, a.mk_int(2)));
+    g1->assert_expr(a.mk_lt(x, a.mk_int(5)));
+    ENSURE(solve(*t1, g1) == l_true);
+    ENSURE(is_selected(*t1, "qflia"));
+    ENSURE(!is_selected(*t1, "smt"));
+
+    tactic_ref t2 = mk_strategy_selector_tactic(m, mk_params());
+    goal_ref g2 = alloc(goal, m);
+    g2->assert_expr(a.mk_gt(y, a.mk_numeral(rational(1, 2), false)));
+    g2->assert_expr(a.mk_lt(y, a.mk_numeral(rational(1), false)));
+    ENSURE(solve(*t2, g2) == l_true);
+    ENSURE(is_selected(*t2, "smt"));
+    ENSURE(!is_selected(*t2, "qflia"));
+}
+
+static void tst_malformed(char const * model) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    write_model(model);
+    bool failed = false;
+    try {
+        tactic_ref t = mk_strategy_selector_tactic(m, mk_params());
+    }
+    catch (z3_exception & ex) {
+        std::cout << ex.msg() << "\n";
+        failed = true;
+    }
+    ENSURE(failed);
+}
+
+void tst_strategy_selector() {
+    tst_select();
+    tst_malformed("leaf 4294967295 smt\n");
+    tst_malformed("node 0 is_qflia 0.5 1 4294967295\nleaf 1 smt\n");
+    tst_malformed("node 0 is_qflia 0.5 1 2\nleaf 1 smt\n");
+    tst_malformed("node 0 no_such_feature 0.5 1 2\nleaf 1 smt\nleaf 2 qflia\n");
+    tst_malformed("leaf 0 no_such_strategy\n");
+    tst_malformed("leaf 0 smt\nleaf 0 qflia\n");
+    tst_malformed("# no entries\n");
+    remove(g_model_file);
+}
@@ -0,0 +1,140 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    tactic_profile.cpp
+
+Abstract:
+
+    Profiles of tactics. A profiled tactical profiles its arguments,
+    the profile is a tree that follows the nesting of the tactics that
+    ran, and the profiles of translated copies, such as the ones run by
+    par, are merged into the profile.
+
+--*/
+
+#include<sstream>
+#include"tactical.h"
+#include"simplify_tactic.h"
+#include"arith_decl_plugin.h"
+#include"reg_decl_plugins.h"
+#include"statistics.h"
+
+static void run(tactic & t, goal_ref const & g) {
+    goal_ref_buffer     result;
+    model_converter_ref mc;
+    proof_converter_ref pc;
+    expr_dependency_ref core(g->m());
+    t(g, result, mc, pc, core);
+    ENSURE(result.size() == 1);
+}
+
+static bool contains(std::string const & s, char const * sub) {
+    return s.find(sub) != std::string::npos;
+}
+
+static std::string display(tactic_profile const & p) {
+    std::ostringstream strm;
+    p.display(strm);
+    std::cout << strm.str();
+    return strm.str();
+}
+
+static unsigned get_stat(statistics const & st, char const * key) {
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return UINT_MAX;
+}
+
+static goal_ref mk_goal(ast_manager & m) {
+    arith_util a(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    goal_ref g = alloc(goal, m);
+    g->assert_expr(a.mk_gt(a.mk_add(x, a.mk_int(1)), a.mk_int(2)));
+    return g;
+}
+
+static void tst_nesting() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    goal_ref g = mk_goal(m);
+
+    ref<tactic_profile> prof = alloc(tactic_profile);
+    tactic_ref t = and_then(mk_simplify_tactic(m), or_else(mk_fail_tactic(), mk_skip_tactic()));
+    t = profile_tactic(*prof, "main", t.get());
+    // added after profiling, so it is not profiled.
+    tactic_ref t2 = and_then(t.get(), mk_skip_tactic());
+
+    run(*t2, g);
+    run(*t2, g);
+    std::string s = display(*prof);
+    ENSURE(contains(s, "(profile\n  (main :calls 2 :failed 0"));
+    ENSURE(contains(s, "\n    (#1 :calls 2 :failed 0"));
+    ENSURE(contains(s, "\n    (or-else :calls 2 :failed 0"));
+    ENSURE(contains(s, "\n      (#1 :calls 2 :failed 2"));
+    ENSURE(contains(s, "\n      (#2 :calls 2 :failed 0"));
+    ENSURE(!contains(s, "#3"));
+
+    statistics st;
+    prof->collect_statistics(st);
+    st.display(std::cout);
+    ENSURE(get_stat(st, "profile main calls") == 2);
+    ENSURE(get_stat(st, "profile main/or-else calls") == 2);
+    ENSURE(get_stat(st, "profile main/or-else/#1 failed") == 2);
+    ENSURE(get_stat(st, "profile main/or-else/#2 subgoals") == 2);
+
+    // a profiled tactic is renamed instead of being profiled twice.
+    t = profile_tactic(*prof, "renamed", t.get());
+    t2 = 0;
+    t->reset_statistics();
+    ENSURE(display(*prof) == "(profile)\n");
+    run(*t, g);
+    s = display(*prof);
+    ENSURE(contains(s, "(profile\n  (renamed :calls 1"));
+    ENSURE(!contains(s, "main"));
+}
+
+static void tst_par() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    goal_ref g = mk_goal(m);
+
+    ref<tactic_profile> prof = alloc(tactic_profile);
+    tactic * ts[2] = { and_then(mk_fail_tactic(), mk_skip_tactic()), and_then(mk_simplify_tactic(m), mk_skip_tactic()) };
+    tactic_ref t = profile_tactic(*prof, "main", par(2, ts));
+    run(*t, g);
+    run(*t, g);
+    // the children run on translated copies, their profiles are merged under par.
+    std::string s = display(*prof);
+    ENSURE(contains(s, "(profile\n  (main :calls 2 :failed 0"));
+    ENSURE(contains(s, "\n    (and-then :calls 2 :failed 2"));
+    ENSURE(contains(s, "\n      (#1 :calls 2 :failed 2"));
+    ENSURE(contains(s, "\n    (and-then :calls 2 :failed 0"));
+    ENSURE(contains(s, "\n      (#2 :calls 2 :failed 0"));
+
+    statistics st;
+    prof->collect_statistics(st);
+    ENSURE(get_stat(st, "profile main/and-then failed") == 2);
+    ENSURE(get_stat(st, "profile main/and-then.2 subgoals") == 2);
+    ENSURE(get_stat(st, "profile main/and-then.2/#2 calls") == 2);
+
+    // a translated tactic records into the profile too.
+    ref<tactic_profile> prof2 = alloc(tactic_profile);
+    tactic_ref t2 = profile_tactic(*prof2, "main", and_then(mk_simplify_tactic(m), mk_skip_tactic()));
+    {
+        tactic_ref t3 = t2->translate(m);
+        run(*t3, g);
+        ENSURE(display(*prof2) == "(profile)\n");
+    }
+    s = display(*prof2);
+    ENSURE(contains(s, "(profile\n  (main :calls 1 :failed 0"));
+    ENSURE(contains(s, "\n    (#2 :calls 1 :failed 0"));
+}
+
+void tst_tactic_profile() {
+    tst_nesting();
+    tst_par();
+}
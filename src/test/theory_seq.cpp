@@ -0,0 +1,86 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    theory_seq.cpp
+
+Abstract:
+
+    Regular expression membership with a bounded automata cache.
+    The cache is flushed when an automaton would exceed
+    smt.seq.max_automata_states, and the results must not change.
+
+--*/
+
+#include<sstream>
+#include"smt_kernel.h"
+#include"smt_params.h"
+#include"cmd_context.h"
+#include"smt2parser.h"
+#include"reg_decl_plugins.h"
+#include"statistics.h"
+
+static unsigned get_stat(statistics const & st, char const * key) {
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+static char const * g_sat =
+    "(declare-const x String)\n"
+    "(declare-const y String)\n"
+    "(assert (str.in.re x (re.++ (re.* (re.union (str.to.re \"a\") (str.to.re \"b\"))) (str.to.re \"c\"))))\n"
+    "(assert (str.in.re x (re.++ (re.* (str.to.re \"a\")) (re.+ (re.union (str.to.re \"b\") (str.to.re \"c\"))))))\n"
+    "(assert (str.in.re y (re.++ (str.to.re \"ab\") (re.* (str.to.re \"c\")) (str.to.re \"d\"))))\n"
+    "(assert (= (str.len x) 4))\n"
+    "(assert (= (str.len y) 5))\n";
+
+static char const * g_unsat =
+    "(declare-const x String)\n"
+    "(assert (str.in.re x (re.+ (str.to.re \"a\"))))\n"
+    "(assert (str.in.re x (re.++ (re.* (str.to.re \"b\")) (str.to.re \"c\"))))\n";
+
+static void tst_bound(char const * problem, lbool expected, unsigned max_states) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    cmd_context ctx(false, &m);
+    ctx.set_ignore_check(true);
+    std::istringstream is(problem);
+    VERIFY(parse_smt2_commands(ctx, is));
+
+    smt_params fp;
+    fp.m_seq_max_automata_states = max_states;
+    smt::kernel solver(m, fp);
+    ptr_vector<expr>::const_iterator it  = ctx.begin_assertions();
+    ptr_vector<expr>::const_iterator end = ctx.end_assertions();
+    for (; it != end; ++it)
+        solver.assert_expr(*it);
+    lbool r = solver.check();
+    statistics st;
+    solver.collect_statistics(st);
+    unsigned built   = get_stat(st, "seq automata");
+    unsigned flushes = get_stat(st, "seq automata flushes");
+    std::cout << "max states " << max_states << ": " << r << " automata: " << built
+              << " flushes: " << flushes << "\n";
+    ENSURE(r == expected);
+    ENSURE(built > 0);
+    if (max_states == UINT_MAX) {
+        ENSURE(flushes == 0);
+    }
+    else if (max_states == 1) {
+        // every automaton has more than one state, so each insertion
+        // into a non-empty cache flushes it.
+        ENSURE(flushes + 1 == built);
+    }
+}
+
+void tst_theory_seq() {
+    unsigned bounds[3] = { UINT_MAX, 10, 1 };
+    for (unsigned i = 0; i < 3; ++i) {
+        tst_bound(g_sat, l_true, bounds[i]);
+        tst_bound(g_unsat, l_false, bounds[i]);
+    }
+}
@@ -0,0 +1,130 @@
+/*++
+Copyright (c) 2016 Microsoft Corporation
+
+Module Name:
+
+    z3_log.cpp
+
+Abstract:
+
+    Record API sessions in the text and binary log formats and replay
+    them. Replaying a binary log while logging must reproduce the same
+    log, since objects are logged by ids instead of addresses.
+
+--*/
+
+#include<fstream>
+#include<sstream>
+#include"z3.h"
+#include"z3_replayer.h"
+#include"stopwatch.h"
+#include"debug.h"
+
+static void mk_session(unsigned num_terms) {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_sort int_ty = Z3_mk_int_sort(ctx);
+    Z3_ast x = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "x"), int_ty);
+    Z3_ast y = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "y"), int_ty);
+    Z3_solver s = Z3_mk_solver(ctx);
+    Z3_solver_inc_ref(ctx, s);
+    Z3_ast args[2] = { x, y };
+    Z3_solver_assert(ctx, s, Z3_mk_gt(ctx, Z3_mk_add(ctx, 2, args), Z3_mk_int(ctx, 2, int_ty)));
+    Z3_solver_assert(ctx, s, Z3_mk_lt(ctx, x, Z3_mk_int(ctx, 1, int_ty)));
+    Z3_ast t = x;
+    for (unsigned i = 0; i < num_terms; ++i) {
+        Z3_ast ts[2] = { t, Z3_mk_int(ctx, i, int_ty) };
+        t = Z3_mk_add(ctx, 2, ts);
+    }
+    ENSURE(Z3_solver_check(ctx, s) == Z3_L_TRUE);
+    Z3_model m = Z3_solver_get_model(ctx, s);
+    Z3_model_inc_ref(ctx, m);
+    Z3_ast v = 0;
+    ENSURE(Z3_model_eval(ctx, m, y, Z3_TRUE, &v) == Z3_TRUE);
+    Z3_model_dec_ref(ctx, m);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_del_context(ctx);
+}
+
+static std::string read_file(char const * file_name) {
+    std::ifstream in(file_name, std::ios::binary);
+    std::ostringstream strm;
+    strm << in.rdbuf();
+    return strm.str();
+}
+
+// the logs are written to the temporary directory, not to the
+// directory the tests run in.
+static std::string temp_path(char const * file_name) {
+    char const * dir = getenv("TMPDIR");
+    if (!dir)
+        dir = getenv("TEMP");
+#ifdef _WINDOWS
+    if (!dir)
+        dir = ".";
+    return std::string(dir) + "\\" + file_name;
+#else
+    if (!dir)
+        dir = "/tmp";
+    return std::string(dir) + "/" + file_name;
+#endif
+}
+
+static double replay(char const * file_name) {
+    stopwatch timer;
+    timer.start();
+    std::ifstream in(file_name, std::ios::binary);
+    ENSURE(!in.fail());
+    z3_replayer r(in);
+    r.parse();
+    timer.stop();
+    return timer.get_seconds();
+}
+
+static void tst_round_trip() {
+    std::string bin1 = temp_path("z3_log_1.bin");
+    std::string bin2 = temp_path("z3_log_2.bin");
+    std::string log1 = temp_path("z3_log_1.log");
+    ENSURE(Z3_open_binary_log(bin1.c_str()) == Z3_TRUE);
+    mk_session(10);
+    Z3_close_log();
+    ENSURE(Z3_open_binary_log(bin2.c_str()) == Z3_TRUE);
+    replay(bin1.c_str());
+    Z3_close_log();
+    std::string data1 = read_file(bin1.c_str());
+    std::string data2 = read_file(bin2.c_str());
+    ENSURE(!data1.empty());
+    ENSURE(data1 == data2);
+
+    ENSURE(Z3_open_log(log1.c_str()) == Z3_TRUE);
+    mk_session(10);
+    Z3_close_log();
+    replay(log1.c_str());
+    remove(bin1.c_str());
+    remove(bin2.c_str());
+    remove(log1.c_str());
+}
+
+static void tst_replay_time() {
+    unsigned num_terms = 100000;
+    std::string log = temp_path("z3_log_3.log");
+    std::string bin = temp_path("z3_log_3.bin");
+    ENSURE(Z3_open_log(log.c_str()) == Z3_TRUE);
+    mk_session(num_terms);
+    Z3_close_log();
+    ENSURE(Z3_open_binary_log(bin.c_str()) == Z3_TRUE);
+    mk_session(num_terms);
+    Z3_close_log();
+    double text_time = replay(log.c_str());
+    double bin_time  = replay(bin.c_str());
+    std::cout << "text log:   " << read_file(log.c_str()).size() << " bytes, replay " << text_time << " secs\n";
+    std::cout << "binary log: " << read_file(bin.c_str()).size() << " bytes, replay " << bin_time << " secs\n";
+    remove(log.c_str());
+    remove(bin.c_str());
+}
+
+void tst_z3_log() {
+    tst_round_trip();
+    tst_replay_time();
+}
@@ -314,6 +314,13 @@ public:
 
     bool empty(ref const & r) const { return size(r) == 0; }
 
+    /**
+       \brief Return true if \c r1 and \c r2 are references to the same version.
+       Cells are never modified in a way that changes the array they represent,
+       so the arrays are equal when this method returns true.
+    */
+    bool same(ref const & r1, ref const & r2) const { return r1.m_ref == r2.m_ref; }
+
     value const & get(ref const & r, unsigned i) const {
         SASSERT(i < size(r));
         